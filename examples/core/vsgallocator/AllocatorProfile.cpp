@@ -0,0 +1,195 @@
+#include "AllocatorProfile.h"
+
+#include <vsg/io/Logger.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// Register the AllocatorProfile::create() method with vsg::ObjectFactory::instance() so it can be used for creating objects during reading.
+vsg::RegisterWithObjectFactoryProxy<AllocatorProfile> s_Register_AllocatorProfile;
+
+size_t AllocatorProfile::recommendedBlockSize(uint32_t affinity) const
+{
+    const size_t MB = 1024 * 1024;
+    for (auto& a : affinities)
+    {
+        if (a.affinity != affinity || a.numAllocations == 0) continue;
+
+        // find the size range that 99% of the allocations fit within, larger ones are left to the allocator's fallback
+        uint64_t typicalSize = a.largestAllocation;
+        uint64_t count = 0;
+        for (size_t i = 0; i < a.sizeHistogram.size(); ++i)
+        {
+            count += a.sizeHistogram[i];
+            if (count * 100 >= a.numAllocations * 99)
+            {
+                typicalSize = std::min(a.largestAllocation, uint64_t(1) << i);
+                break;
+            }
+        }
+
+        auto toMB = [&](uint64_t size) { return std::max(size_t(1), static_cast<size_t>((size + MB - 1) / MB)); };
+        return std::min(toMB(typicalSize * allocationsPerBlock), toMB(a.peakAllocated)) * MB;
+    }
+    return 0;
+}
+
+void AllocatorProfile::apply(vsg::Allocator& allocator, bool reserve) const
+{
+    for (auto& a : affinities)
+    {
+        auto blockSize = recommendedBlockSize(a.affinity);
+        if (blockSize == 0) continue;
+
+        auto affinity = static_cast<vsg::AllocatorAffinity>(a.affinity);
+        allocator.setBlockSize(affinity, blockSize);
+
+        if (reserve)
+        {
+            // allocate chunks small enough to be placed in the allocator's blocks until the peak is covered, the released blocks
+            // remain reserved by the allocator, ready for the allocations that follow
+            size_t chunkSize = blockSize / 4;
+            std::vector<void*> chunks;
+            for (uint64_t reserved = 0; reserved < a.peakAllocated; reserved += chunkSize)
+            {
+                if (auto ptr = allocator.allocate(chunkSize, affinity))
+                    chunks.push_back(ptr);
+                else
+                    break;
+            }
+            for (auto ptr : chunks) allocator.deallocate(ptr, chunkSize);
+        }
+    }
+}
+
+void AllocatorProfile::report(std::ostream& out) const
+{
+    out << "AllocatorProfile::report()" << std::endl;
+    for (auto& a : affinities)
+    {
+        out << "  affinity " << a.affinity << ", numAllocations = " << a.numAllocations << ", totalAllocated = " << a.totalAllocated
+            << ", peakAllocated = " << a.peakAllocated << ", largestAllocation = " << a.largestAllocation
+            << ", recommendedBlockSize = " << recommendedBlockSize(a.affinity) << std::endl;
+    }
+}
+
+void AllocatorProfile::read(vsg::Input& input)
+{
+    vsg::Object::read(input);
+
+    affinities.resize(input.readValue<uint32_t>("numAffinities"));
+    for (auto& a : affinities)
+    {
+        input.read("affinity", a.affinity);
+        input.read("numAllocations", a.numAllocations);
+        input.read("totalAllocated", a.totalAllocated);
+        input.read("peakAllocated", a.peakAllocated);
+        input.read("largestAllocation", a.largestAllocation);
+
+        a.sizeHistogram.resize(input.readValue<uint32_t>("numBuckets"));
+        for (auto& count : a.sizeHistogram) input.read("count", count);
+    }
+}
+
+void AllocatorProfile::write(vsg::Output& output) const
+{
+    vsg::Object::write(output);
+
+    output.writeValue<uint32_t>("numAffinities", affinities.size());
+    for (auto& a : affinities)
+    {
+        output.write("affinity", a.affinity);
+        output.write("numAllocations", a.numAllocations);
+        output.write("totalAllocated", a.totalAllocated);
+        output.write("peakAllocated", a.peakAllocated);
+        output.write("largestAllocation", a.largestAllocation);
+
+        output.writeValue<uint32_t>("numBuckets", a.sizeHistogram.size());
+        for (auto& count : a.sizeHistogram) output.write("count", count);
+    }
+}
+
+ProfilingAllocator::ProfilingAllocator(std::unique_ptr<Allocator> in_nestedAllocator) :
+    vsg::Allocator(std::move(in_nestedAllocator))
+{
+    if (nestedAllocator) allocatorType = nestedAllocator->allocatorType;
+}
+
+void* ProfilingAllocator::allocate(std::size_t size, vsg::AllocatorAffinity allocatorAffinity)
+{
+    uint32_t affinity = std::min(static_cast<uint32_t>(allocatorAffinity), static_cast<uint32_t>(maxAffinities - 1));
+
+    size_t bucket = 0;
+    while (bucket < numBuckets - 1 && (size_t(1) << bucket) < size) ++bucket;
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    // pass on any change to the allocatorType made since the nested allocator was wrapped
+    if (nestedAllocator->allocatorType != allocatorType) nestedAllocator->allocatorType = allocatorType;
+
+    void* ptr = nestedAllocator->allocate(size, allocatorAffinity);
+    if (!ptr) return ptr;
+
+    auto& counters = _counters[affinity];
+    ++counters.numAllocations;
+    counters.totalAllocated += size;
+    counters.currentAllocated += size;
+    counters.peakAllocated = std::max(counters.peakAllocated, counters.currentAllocated);
+    counters.largestAllocation = std::max(counters.largestAllocation, static_cast<uint64_t>(size));
+    ++counters.sizeHistogram[bucket];
+
+    _affinities[ptr] = affinity;
+
+    return ptr;
+}
+
+bool ProfilingAllocator::deallocate(void* ptr, std::size_t size)
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        // memory allocated before the ProfilingAllocator was assigned won't be in the map
+        if (auto itr = _affinities.find(ptr); itr != _affinities.end())
+        {
+            auto& counters = _counters[itr->second];
+            counters.currentAllocated -= std::min(counters.currentAllocated, static_cast<uint64_t>(size));
+            _affinities.erase(itr);
+        }
+    }
+
+    return nestedAllocator->deallocate(ptr, size);
+}
+
+void ProfilingAllocator::report(std::ostream& out) const
+{
+    profile()->report(out);
+    nestedAllocator->report(out);
+}
+
+vsg::ref_ptr<AllocatorProfile> ProfilingAllocator::profile() const
+{
+    auto allocatorProfile = AllocatorProfile::create();
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    for (uint32_t i = 0; i < maxAffinities; ++i)
+    {
+        auto& counters = _counters[i];
+        if (counters.numAllocations == 0) continue;
+
+        AllocatorProfile::Affinity a;
+        a.affinity = i;
+        a.numAllocations = counters.numAllocations;
+        a.totalAllocated = counters.totalAllocated;
+        a.peakAllocated = counters.peakAllocated;
+        a.largestAllocation = counters.largestAllocation;
+
+        // trim empty buckets from the end of the histogram
+        size_t numUsedBuckets = numBuckets;
+        while (numUsedBuckets > 0 && counters.sizeHistogram[numUsedBuckets - 1] == 0) --numUsedBuckets;
+        a.sizeHistogram.assign(counters.sizeHistogram.begin(), counters.sizeHistogram.begin() + numUsedBuckets);
+
+        allocatorProfile->affinities.push_back(a);
+    }
+    return allocatorProfile;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vsg/core/Allocator.h>
+#include <vsg/core/Inherit.h>
+#include <vsg/io/Input.h>
+#include <vsg/io/Output.h>
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// Record of the allocations made for each AllocatorAffinity during a run, used to size the allocator's blocks on the next run.
+class AllocatorProfile : public vsg::Inherit<vsg::Object, AllocatorProfile>
+{
+public:
+    struct Affinity
+    {
+        uint32_t affinity = 0;
+        uint64_t numAllocations = 0;
+        uint64_t totalAllocated = 0;
+        uint64_t peakAllocated = 0;
+        uint64_t largestAllocation = 0;
+
+        /// number of allocations in each power of two size range, index i counting sizes in the range (2^(i-1), 2^i]
+        std::vector<uint64_t> sizeHistogram;
+    };
+
+    std::vector<Affinity> affinities;
+
+    /// number of the affinity's typical allocations each block should hold.
+    static constexpr size_t allocationsPerBlock = 1024;
+
+    /// block size to use for the affinity, sized from its size histogram to hold allocationsPerBlock of the allocation size that 99% of its
+    /// allocations fit within, rounded up to a whole number of megabytes and capped at its peak allocated. 0 if no allocations were recorded.
+    size_t recommendedBlockSize(uint32_t affinity) const;
+
+    /// set the block sizes of the allocator from the profile, and when reserve is true reserve each affinity's peak up front
+    /// by allocating and releasing enough block sized chunks to cover it.
+    void apply(vsg::Allocator& allocator, bool reserve) const;
+
+    void report(std::ostream& out) const;
+
+    void read(vsg::Input& input) override;
+    void write(vsg::Output& output) const override;
+};
+
+/// Allocator that records an AllocatorProfile of the allocations passed through to its nested allocator.
+/// Each allocation's affinity is kept in a map so deallocations can be attributed, this adds overhead so is only intended for profiling runs.
+/// The allocatorType is taken from the nested allocator on construction, and changes to it are passed on to the nested allocator.
+class ProfilingAllocator : public vsg::Allocator
+{
+public:
+    explicit ProfilingAllocator(std::unique_ptr<Allocator> in_nestedAllocator);
+
+    void* allocate(std::size_t size, vsg::AllocatorAffinity allocatorAffinity) override;
+    bool deallocate(void* ptr, std::size_t size) override;
+
+    size_t deleteEmptyMemoryBlocks() override { return nestedAllocator->deleteEmptyMemoryBlocks(); }
+    size_t totalAvailableSize() const override { return nestedAllocator->totalAvailableSize(); }
+    size_t totalReservedSize() const override { return nestedAllocator->totalReservedSize(); }
+    size_t totalMemorySize() const override { return nestedAllocator->totalMemorySize(); }
+    void setBlockSize(vsg::AllocatorAffinity allocatorAffinity, size_t blockSize) override { nestedAllocator->setBlockSize(allocatorAffinity, blockSize); }
+
+    void report(std::ostream& out) const override;
+
+    /// create a profile from the allocations recorded so far.
+    vsg::ref_ptr<AllocatorProfile> profile() const;
+
+protected:
+    static constexpr size_t maxAffinities = 8;
+    static constexpr size_t numBuckets = 64;
+
+    struct Counters
+    {
+        uint64_t numAllocations = 0;
+        uint64_t totalAllocated = 0;
+        uint64_t currentAllocated = 0;
+        uint64_t peakAllocated = 0;
+        uint64_t largestAllocation = 0;
+        std::array<uint64_t, numBuckets> sizeHistogram{};
+    };
+
+    mutable std::mutex _mutex;
+    std::array<Counters, maxAffinities> _counters;
+    std::unordered_map<void*, uint32_t> _affinities;
+};
+
+EVSG_type_name(AllocatorProfile);
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vsg/nodes/Group.h>
+
+#include "WorkStealingThreads.h"
+
+/// ParallelVisitor adds parallel traversal to an existing visitor type V, such as vsg::ConstVisitor or vsg::ComputeBounds.
+/// Subclasses call split(group) from their apply(Group&) to hand the group's children off to the WorkStealingThreads,
+/// each thread traverses with its own visitor created by cloneVisitor(), and merge() combines their results at the end of dispatch().
+template<class V>
+class ParallelVisitor : public V
+{
+public:
+    using V::V;
+
+    /// pool of threads to distribute the traversal across, if null traversal is single threaded.
+    vsg::ref_ptr<WorkStealingThreads> threads;
+
+    /// minimum number of children a Group requires before its children are handed off as separate tasks.
+    size_t minChildrenToSplit = 2;
+
+    /// maximum number of nested splits, subgraphs below this are traversed entirely by the thread that reaches them.
+    uint32_t maxSplitLevels = 4;
+
+    /// create a visitor with the same settings as this one, but with empty results, for use by another thread.
+    virtual vsg::ref_ptr<ParallelVisitor> cloneVisitor() const = 0;
+
+    /// copy the traversal state, such as matrix stacks, required to continue the traversal from the current position.
+    virtual void copyTraversalState(ParallelVisitor& /*visitor*/) const {}
+
+    /// merge the results collected by a thread's visitor into this visitor.
+    virtual void merge(const ParallelVisitor& visitor) = 0;
+
+    /// traverse the subgraph in parallel, merging the results of all the threads' visitors into this visitor.
+    template<class N>
+    void dispatch(N& node)
+    {
+        if (!threads || threads->size() <= 1)
+        {
+            node.accept(*this);
+            return;
+        }
+
+        _threadVisitors.clear();
+        _threadVisitors.resize(threads->size());
+        _splitLevel = 0;
+
+        threads->run([this, &node](uint32_t threadIndex) {
+            _threadIndex = threadIndex;
+            node.accept(*this);
+        });
+
+        for (auto& visitor : _threadVisitors)
+        {
+            if (visitor) merge(*visitor);
+        }
+        _threadVisitors.clear();
+    }
+
+    /// hand the group's children off to the threads if it qualifies for splitting, return false if the caller should traverse it.
+    template<class G>
+    bool split(G& group)
+    {
+        if (_threadVisitors.empty() && !_parent) return false;
+        if (_splitLevel >= maxSplitLevels || group.children.size() < minChildrenToSplit) return false;
+
+        auto root = _parent ? _parent : this;
+
+        // snapshot the traversal state so it's available to the tasks after this visitor has moved on
+        vsg::ref_ptr<ParallelVisitor> snapshot = cloneVisitor();
+        copyTraversalState(*snapshot);
+
+        auto splitLevel = _splitLevel + 1;
+        for (auto& child : group.children)
+        {
+            root->threads->push(_threadIndex, [root, snapshot, splitLevel, child = child.get()](uint32_t threadIndex) {
+                auto& visitor = root->_threadVisitors[threadIndex];
+                if (!visitor)
+                {
+                    visitor = root->cloneVisitor();
+                    visitor->_parent = root;
+                }
+
+                snapshot->copyTraversalState(*visitor);
+                visitor->_threadIndex = threadIndex;
+                visitor->_splitLevel = splitLevel;
+
+                child->accept(*visitor);
+            });
+        }
+        return true;
+    }
+
+protected:
+    ParallelVisitor* _parent = nullptr;
+    uint32_t _threadIndex = 0;
+    uint32_t _splitLevel = 0;
+    std::vector<vsg::ref_ptr<ParallelVisitor>> _threadVisitors;
+};
@@ -0,0 +1,111 @@
+#include "WorkStealingThreads.h"
+
+WorkStealingThreads::WorkStealingThreads(uint32_t numThreads)
+{
+    if (numThreads == 0) numThreads = 1;
+
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        _queues.emplace_back(new TaskQueue);
+    }
+
+    // thread 0 is the thread that calls run(), so only create the additional worker threads
+    for (uint32_t i = 1; i < numThreads; ++i)
+    {
+        _threads.emplace_back([this, i]() {
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _cv.wait(lock, [this]() { return _done || _pending > 0; });
+                    if (_done) return;
+                }
+                work(i);
+            }
+        });
+    }
+}
+
+WorkStealingThreads::~WorkStealingThreads()
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _done = true;
+    }
+    _cv.notify_all();
+
+    for (auto& thread : _threads) thread.join();
+}
+
+void WorkStealingThreads::push(uint32_t threadIndex, Task task)
+{
+    ++_pending;
+
+    auto& queue = *_queues[threadIndex];
+    std::scoped_lock<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+}
+
+bool WorkStealingThreads::pop(uint32_t threadIndex, Task& task)
+{
+    // take the most recently pushed task from our own deque to keep traversal depth first and cache friendly
+    {
+        auto& queue = *_queues[threadIndex];
+        std::scoped_lock<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // steal the oldest task from another thread, these tend to be the largest subgraphs
+    auto numQueues = size();
+    for (uint32_t i = 1; i < numQueues; ++i)
+    {
+        auto& queue = *_queues[(threadIndex + i) % numQueues];
+        std::scoped_lock<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingThreads::work(uint32_t threadIndex)
+{
+    Task task;
+    while (_pending > 0)
+    {
+        if (pop(threadIndex, task))
+        {
+            task(threadIndex);
+            task = nullptr;
+
+            // decrement after the task completes so any tasks it pushed keep _pending above zero
+            --_pending;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkStealingThreads::run(Task rootTask)
+{
+    push(0, std::move(rootTask));
+
+    // take the lock so worker threads can't miss the notification between testing _pending and waiting
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+    }
+    _cv.notify_all();
+
+    work(0);
+}
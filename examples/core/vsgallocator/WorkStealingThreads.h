@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vsg/core/Inherit.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Thread pool where each thread owns a deque of tasks, pushing and popping from the back of its own deque
+/// and stealing from the front of other threads' deques when it runs out of work.
+/// The thread calling run() participates as thread 0, so a pool of size 1 runs everything on the calling thread.
+class WorkStealingThreads : public vsg::Inherit<vsg::Object, WorkStealingThreads>
+{
+public:
+    using Task = std::function<void(uint32_t threadIndex)>;
+
+    explicit WorkStealingThreads(uint32_t numThreads = std::thread::hardware_concurrency());
+
+    uint32_t size() const { return static_cast<uint32_t>(_queues.size()); }
+
+    /// add task to the deque of the specified thread, may be called from within a running task.
+    void push(uint32_t threadIndex, Task task);
+
+    /// run the rootTask and any tasks it pushes, returning once all tasks have completed.
+    void run(Task rootTask);
+
+protected:
+    virtual ~WorkStealingThreads();
+
+    bool pop(uint32_t threadIndex, Task& task);
+    void work(uint32_t threadIndex);
+
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> _queues;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::atomic_uint64_t _pending{0};
+    bool _done = false;
+};
@@ -9,6 +9,10 @@
 #include <iostream>
 #include <thread>
 
+#include "AllocatorProfile.h"
+#include "ParallelVisitor.h"
+#include "ResidentSetSize.h"
+
 class StdAllocator : public vsg::Allocator
 {
 public:
@@ -62,6 +66,141 @@ struct SceneStatistics : public vsg::Inherit<vsg::ConstVisitor, SceneStatistics>
     }
 };
 
+struct ParallelSceneStatistics : public vsg::Inherit<ParallelVisitor<vsg::ConstVisitor>, ParallelSceneStatistics>
+{
+    using Base = ParallelVisitor<vsg::ConstVisitor>;
+
+    std::map<const char*, size_t> objectCounts;
+
+    void report(std::ostream& out)
+    {
+        for (auto& [str, count] : objectCounts) out << "  " << str << " " << count << std::endl;
+    }
+
+    vsg::ref_ptr<Base> cloneVisitor() const override
+    {
+        auto visitor = ParallelSceneStatistics::create();
+        visitor->threads = threads;
+        visitor->minChildrenToSplit = minChildrenToSplit;
+        visitor->maxSplitLevels = maxSplitLevels;
+        return visitor;
+    }
+
+    void merge(const Base& visitor) override
+    {
+        for (auto& [str, count] : static_cast<const ParallelSceneStatistics&>(visitor).objectCounts) objectCounts[str] += count;
+    }
+
+    void apply(const vsg::Node& node) override
+    {
+        ++objectCounts[node.className()];
+        node.traverse(*this);
+    }
+
+    void apply(const vsg::Group& group) override
+    {
+        ++objectCounts[group.className()];
+        if (!split(group)) group.traverse(*this);
+    }
+};
+
+struct ParallelComputeBounds : public vsg::Inherit<ParallelVisitor<vsg::ComputeBounds>, ParallelComputeBounds>
+{
+    using Base = ParallelVisitor<vsg::ComputeBounds>;
+
+    vsg::ref_ptr<Base> cloneVisitor() const override
+    {
+        auto visitor = ParallelComputeBounds::create();
+        visitor->threads = threads;
+        visitor->minChildrenToSplit = minChildrenToSplit;
+        visitor->maxSplitLevels = maxSplitLevels;
+        visitor->useNodeBounds = useNodeBounds;
+        return visitor;
+    }
+
+    void copyTraversalState(Base& visitor) const override
+    {
+        auto& cb = static_cast<ParallelComputeBounds&>(visitor);
+        cb.matrixStack = matrixStack;
+
+        // each thread needs its own ArrayState as it's updated when vertex arrays are visited
+        cb.arrayStateStack.clear();
+        cb.arrayStateStack.push_back(arrayStateStack.back()->cloneArrayState());
+    }
+
+    void merge(const Base& visitor) override
+    {
+        auto& cb = static_cast<const ParallelComputeBounds&>(visitor);
+        if (cb.bounds.valid()) bounds.add(cb.bounds);
+    }
+
+    void apply(const vsg::Group& group) override
+    {
+        if (!split(group)) vsg::ComputeBounds::apply(group);
+    }
+};
+
+struct LoadStats
+{
+    double loadDuration = 0.0;
+    uint32_t numTiles = 0;
+    int64_t residentSize = 0;
+    size_t reservedSize = 0;
+};
+
+// load the files, and the PagedLOD tiles down to loadLevels when it's greater than 0, recording the time taken and the resident size
+// gained since baseResidentSize was measured, before releasing the scene graph again.
+LoadStats loadScene(const std::vector<vsg::Path>& filenames, vsg::ref_ptr<const vsg::Options> options, int loadLevels, int64_t baseResidentSize)
+{
+    LoadStats loadStats;
+
+    auto startOfLoad = vsg::clock::now();
+
+    auto group = vsg::Group::create();
+    for (auto& filename : filenames)
+    {
+        if (auto node = vsg::read_cast<vsg::Node>(filename, options)) group->addChild(node);
+    }
+
+    if (loadLevels > 0)
+    {
+        // LoadPagedLOD needs a camera to select the tiles, so view the whole scene as the viewer would on startup
+        vsg::ComputeBounds computeBounds;
+        group->accept(computeBounds);
+        vsg::dvec3 centre = (computeBounds.bounds.min + computeBounds.bounds.max) * 0.5;
+        double radius = vsg::length(computeBounds.bounds.max - computeBounds.bounds.min) * 0.6;
+        double nearFarRatio = 0.001;
+        double aspectRatio = 1920.0 / 1080.0;
+
+        auto lookAt = vsg::LookAt::create(centre + vsg::dvec3(0.0, -radius * 3.5, 0.0), centre, vsg::dvec3(0.0, 0.0, 1.0));
+
+        vsg::ref_ptr<vsg::ProjectionMatrix> perspective;
+        auto ellipsoidModel = group->children.empty() ? vsg::ref_ptr<vsg::EllipsoidModel>() : group->children[0]->getRefObject<vsg::EllipsoidModel>("EllipsoidModel");
+        if (ellipsoidModel)
+            perspective = vsg::EllipsoidPerspective::create(lookAt, ellipsoidModel, 30.0, aspectRatio, nearFarRatio, 0.0);
+        else
+            perspective = vsg::Perspective::create(30.0, aspectRatio, nearFarRatio * radius, radius * 4.5);
+
+        auto camera = vsg::Camera::create(perspective, lookAt, vsg::ViewportState::create(0, 0, 1920, 1080));
+
+        vsg::LoadPagedLOD loadPagedLOD(camera, loadLevels);
+        group->accept(loadPagedLOD);
+        loadStats.numTiles = loadPagedLOD.numTiles;
+    }
+
+    loadStats.loadDuration = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startOfLoad).count();
+    loadStats.residentSize = residentSetSize() - baseResidentSize;
+    loadStats.reservedSize = vsg::Allocator::instance()->totalReservedSize();
+
+    return loadStats;
+}
+
+void report(const char* description, const LoadStats& loadStats)
+{
+    std::cout << "  " << description << ": load time = " << loadStats.loadDuration << "ms, tiles = " << loadStats.numTiles
+              << ", resident size = " << loadStats.residentSize / (1024 * 1024) << "MB, allocator reserved = " << loadStats.reservedSize / (1024 * 1024) << "MB" << std::endl;
+}
+
 int main(int argc, char** argv)
 {
     // set up defaults and read command line arguments to override them
@@ -75,6 +214,30 @@ int main(int argc, char** argv)
     if (size_t nodesBlockSize; arguments.read("--nodes", nodesBlockSize)) vsg::Allocator::instance()->setBlockSize(vsg::ALLOCATOR_AFFINITY_NODES, nodesBlockSize);
     if (size_t dataBlockSize; arguments.read("--data", dataBlockSize)) vsg::Allocator::instance()->setBlockSize(vsg::ALLOCATOR_AFFINITY_DATA, dataBlockSize);
 
+    // use an AllocatorProfile recorded by a previous run to size the allocator's blocks, and optionally reserve the memory up front
+    vsg::Path profileFilename;
+    if (arguments.read("--profile", profileFilename))
+    {
+        if (auto allocatorProfile = vsg::read_cast<AllocatorProfile>(profileFilename))
+        {
+            allocatorProfile->apply(*vsg::Allocator::instance(), !arguments.read("--no-reserve"));
+            allocatorProfile->report(std::cout);
+        }
+        else
+        {
+            std::cout << "Unable to read allocator profile " << profileFilename << std::endl;
+        }
+    }
+
+    // record a profile of allocations during this run, writing it out on exit
+    vsg::Path recordProfileFilename;
+    ProfilingAllocator* profilingAllocator = nullptr;
+    if (arguments.read("--record-profile", recordProfileFilename))
+    {
+        profilingAllocator = new ProfilingAllocator(std::move(vsg::Allocator::instance()));
+        vsg::Allocator::instance().reset(profilingAllocator);
+    }
+
     double loadDuration = 0.0;
     double frameRate = 0.0;
     vsg::time_point endOfViewerScope;
@@ -126,6 +289,15 @@ int main(int argc, char** argv)
 
         bool useViewer = !arguments.read("--no-viewer");
 
+        // load the scene with the default block sizes, then again with those of an AllocatorProfile, and compare them
+        auto compareProfileFilename = arguments.value<vsg::Path>("", "--compare-profile");
+        bool compareReserve = !arguments.read("--no-reserve");
+
+        // parallel traversal settings used when collecting stats
+        auto numThreads = arguments.value<uint32_t>(std::thread::hardware_concurrency(), "--threads");
+        auto minChildrenToSplit = arguments.value<size_t>(2, "--min-children");
+        auto maxSplitLevels = arguments.value<uint32_t>(4, "--split-levels");
+
         vsg::Affinity affinity;
         uint32_t cpu = 0;
         while (arguments.read({"--cpu", "-c"}, cpu))
@@ -144,6 +316,36 @@ int main(int argc, char** argv)
             return 1;
         }
 
+        if (compareProfileFilename)
+        {
+            auto allocatorProfile = vsg::read_cast<AllocatorProfile>(compareProfileFilename);
+            if (!allocatorProfile)
+            {
+                std::cout << "Unable to read allocator profile " << compareProfileFilename << std::endl;
+                return 1;
+            }
+
+            std::vector<vsg::Path> filenames;
+            for (int i = 1; i < argc; ++i) filenames.push_back(arguments[i]);
+
+            // the first load fills the OS file cache, so is discarded to keep the file reads the same for both allocator setups
+            loadScene(filenames, options, loadLevels, residentSetSize());
+            vsg::Allocator::instance()->deleteEmptyMemoryBlocks();
+
+            auto defaultStats = loadScene(filenames, options, loadLevels, residentSetSize());
+            vsg::Allocator::instance()->deleteEmptyMemoryBlocks();
+
+            // include the memory reserved up front by the profile in the profiled resident size
+            auto baseResidentSize = residentSetSize();
+            allocatorProfile->apply(*vsg::Allocator::instance(), compareReserve);
+            auto profiledStats = loadScene(filenames, options, loadLevels, baseResidentSize);
+
+            std::cout << "\nComparison of allocator setups loading " << filenames.size() << " file(s), load levels = " << loadLevels << std::endl;
+            report("default", defaultStats);
+            report("profiled", profiledStats);
+            return 0;
+        }
+
         // record time point just before loading the scene graph
         auto startOfLoad = vsg::clock::now();
 
@@ -177,6 +379,8 @@ int main(int argc, char** argv)
         // record the total time taken loading the scene graph
         loadDuration = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startOfLoad).count();
 
+        std::cout << "Memory reserved after load = " << vsg::Allocator::instance()->totalReservedSize() << std::endl;
+
         if (stats > 0)
         {
             auto startOfStats = vsg::clock::now();
@@ -194,6 +398,68 @@ int main(int argc, char** argv)
             std::cout << "Stats collection took " << statsDuration << "ms"
                       << " for " << stats << " traversals." << std::endl;
             sceneStatistics->report(std::cout);
+
+            if (numThreads > 1)
+            {
+                auto threads = WorkStealingThreads::create(numThreads);
+
+                auto startOfParallelStats = vsg::clock::now();
+
+                auto parallelSceneStatistics = ParallelSceneStatistics::create();
+                parallelSceneStatistics->threads = threads;
+                parallelSceneStatistics->minChildrenToSplit = minChildrenToSplit;
+                parallelSceneStatistics->maxSplitLevels = maxSplitLevels;
+
+                for (size_t i = 0; i < stats; ++i)
+                {
+                    parallelSceneStatistics->objectCounts.clear();
+                    parallelSceneStatistics->dispatch(*vsg_scene);
+                }
+
+                auto parallelStatsDuration = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startOfParallelStats).count();
+
+                std::cout << "Parallel stats collection took " << parallelStatsDuration << "ms"
+                          << " for " << stats << " traversals with " << numThreads << " threads, speedup = " << (statsDuration / parallelStatsDuration) << std::endl;
+                if (parallelSceneStatistics->objectCounts != sceneStatistics->objectCounts)
+                {
+                    std::cout << "Warning: parallel stats differ from single threaded stats." << std::endl;
+                    parallelSceneStatistics->report(std::cout);
+                }
+
+                auto startOfBounds = vsg::clock::now();
+
+                vsg::dbox bounds;
+                for (size_t i = 0; i < stats; ++i)
+                {
+                    vsg::ComputeBounds computeBounds;
+                    vsg_scene->accept(computeBounds);
+                    bounds = computeBounds.bounds;
+                }
+
+                auto boundsDuration = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startOfBounds).count();
+
+                auto startOfParallelBounds = vsg::clock::now();
+
+                vsg::dbox parallelBounds;
+                for (size_t i = 0; i < stats; ++i)
+                {
+                    auto parallelComputeBounds = ParallelComputeBounds::create();
+                    parallelComputeBounds->threads = threads;
+                    parallelComputeBounds->minChildrenToSplit = minChildrenToSplit;
+                    parallelComputeBounds->maxSplitLevels = maxSplitLevels;
+                    parallelComputeBounds->dispatch(*vsg_scene);
+                    parallelBounds = parallelComputeBounds->bounds;
+                }
+
+                auto parallelBoundsDuration = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startOfParallelBounds).count();
+
+                std::cout << "ComputeBounds took " << boundsDuration << "ms, parallel ComputeBounds took " << parallelBoundsDuration << "ms"
+                          << " for " << stats << " traversals with " << numThreads << " threads, speedup = " << (boundsDuration / parallelBoundsDuration) << std::endl;
+                if (bounds.min != parallelBounds.min || bounds.max != parallelBounds.max)
+                {
+                    std::cout << "Warning: parallel bounds " << parallelBounds.min << ", " << parallelBounds.max << " differ from " << bounds.min << ", " << bounds.max << std::endl;
+                }
+            }
         }
 
         if (useViewer)
@@ -301,6 +567,15 @@ int main(int argc, char** argv)
         std::cout << "\nBefore end of Viewer scope." << std::endl;
         vsg::Allocator::instance()->report(std::cout);
 
+        if (profilingAllocator)
+        {
+            auto allocatorProfile = profilingAllocator->profile();
+            if (vsg::write(allocatorProfile, recordProfileFilename))
+                std::cout << "Written allocator profile to " << recordProfileFilename << std::endl;
+            else
+                std::cout << "Unable to write allocator profile to " << recordProfileFilename << std::endl;
+        }
+
         // record the end of viewer scope
         endOfViewerScope = vsg::clock::now();
     }
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vsg/core/ref_ptr.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace experimental
+{
+
+    class ScopedThreadConfinement;
+
+    /// Intrusively reference counted base class, usable with vsg::ref_ptr<>, that supports a thread confined mode.
+    /// While confined to a single thread, such as during loading before a subgraph is published to other threads,
+    /// reference count updates use a plain load and store rather than an atomic read-modify-write.
+    class LocalRefObject
+    {
+    public:
+        LocalRefObject() {}
+
+        LocalRefObject(const LocalRefObject&) = delete;
+        LocalRefObject& operator=(const LocalRefObject&) = delete;
+
+        inline void ref() const noexcept
+        {
+            assert(!_confined || _threadId == std::this_thread::get_id());
+            if (_confined)
+                _referenceCount.store(_referenceCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            else
+                _referenceCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void unref() const noexcept
+        {
+            if (unref_nodelete() == 0) delete this;
+        }
+
+        inline unsigned int unref_nodelete() const noexcept
+        {
+            if (_confined)
+            {
+                assert(_threadId == std::this_thread::get_id());
+                auto count = _referenceCount.load(std::memory_order_relaxed) - 1;
+                _referenceCount.store(count, std::memory_order_relaxed);
+                return count;
+            }
+            return _referenceCount.fetch_sub(1, std::memory_order_seq_cst) - 1;
+        }
+
+        inline unsigned int referenceCount() const noexcept { return _referenceCount.load(); }
+
+        bool confined() const { return _confined; }
+
+    protected:
+        virtual ~LocalRefObject() {}
+
+        mutable std::atomic_uint _referenceCount{0};
+        bool _confined = false;
+#ifndef NDEBUG
+        // thread the object is confined to, checked by ref() and unref() in debug builds
+        std::thread::id _threadId;
+#endif
+
+        friend class ScopedThreadConfinement;
+    };
+
+    /// Confines objects added to it to the current thread for the lifetime of the scope.
+    /// On publish() or destruction the objects revert to atomic reference counting, the objects must not
+    /// be passed to other threads until then, and the hand over must be synchronized, e.g. via a mutex protected queue.
+    class ScopedThreadConfinement
+    {
+    public:
+        ScopedThreadConfinement() :
+            _threadId(std::this_thread::get_id()) {}
+
+        ScopedThreadConfinement(const ScopedThreadConfinement&) = delete;
+        ScopedThreadConfinement& operator=(const ScopedThreadConfinement&) = delete;
+
+        ~ScopedThreadConfinement() { publish(); }
+
+        /// add object to the scope, the scope holds a reference so the object remains valid until it's published.
+        void add(LocalRefObject* object)
+        {
+            assert(_threadId == std::this_thread::get_id());
+            if (!object || object->_confined) return;
+
+            object->_confined = true;
+#ifndef NDEBUG
+            object->_threadId = _threadId;
+#endif
+            _objects.emplace_back(object);
+        }
+
+        /// return all objects to atomic reference counting so they can be shared with other threads.
+        void publish()
+        {
+            for (auto& object : _objects) object->_confined = false;
+            std::atomic_thread_fence(std::memory_order_release);
+
+            // release our references now that the objects are back to atomic reference counting
+            _objects.clear();
+        }
+
+        std::thread::id threadId() const { return _threadId; }
+
+    protected:
+        std::thread::id _threadId;
+        std::vector<vsg::ref_ptr<LocalRefObject>> _objects;
+    };
+
+} // namespace experimental
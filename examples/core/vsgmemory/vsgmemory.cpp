@@ -9,18 +9,79 @@
 #include <vsg/nodes/QuadGroup.h>
 #include <vsg/utils/CommandLine.h>
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <memory>
 #include <stack>
+#include <thread>
 #include <typeindex>
 #include <unordered_map>
 #include <vector>
 
+#include "LocalRefObject.h"
+
+class LocalNode : public experimental::LocalRefObject
+{
+protected:
+    virtual ~LocalNode() {}
+};
+
+template<class T>
+void copyAndDestroy(const std::vector<vsg::ref_ptr<T>>& objects, unsigned int numCopies)
+{
+    std::vector<vsg::ref_ptr<T>> copy_objects;
+    for (unsigned int i = 0; i < numCopies; ++i)
+    {
+        copy_objects = objects;
+        copy_objects.clear();
+    }
+}
+
+// run work(state) on numThreads threads, with each thread's state created by setup() before timing starts and destroyed after it ends,
+// returning the time taken for all threads to complete their work.
+template<class Setup, class Work>
+double runThreads(unsigned int numThreads, Setup setup, Work work)
+{
+    std::atomic_uint ready{0};
+    std::atomic_uint done{0};
+    std::atomic_bool start{false};
+    std::atomic_bool finish{false};
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&]() {
+            auto state = setup();
+            ++ready;
+            while (!start) std::this_thread::yield();
+            work(state);
+            ++done;
+
+            // keep the state alive until timing has ended so its destruction isn't included
+            while (!finish) std::this_thread::yield();
+        });
+    }
+
+    while (ready < numThreads) std::this_thread::yield();
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    start = true;
+    while (done < numThreads) std::this_thread::yield();
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    finish = true;
+    for (auto& thread : threads) thread.join();
+
+    return std::chrono::duration<double>(endTime - startTime).count();
+}
+
 int main(int argc, char** argv)
 {
     vsg::CommandLine arguments(&argc, argv);
     auto numObjects = arguments.value(1000000u, {"---num-objects", "-n"});
+    auto maxThreads = arguments.value(std::thread::hardware_concurrency(), "--threads");
+    auto numCopies = arguments.value(10u, "--copies");
     if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
 
     using Objects = std::vector<vsg::ref_ptr<vsg::Object>>;
@@ -41,5 +102,63 @@ int main(int argc, char** argv)
 
     std::cout << "Time to copy container with " << numObjects << " objects : " << std::chrono::duration<double>(clock::now() - start).count() << " seconds." << std::endl;
 
+    // contention benchmark, each thread copies and destroys a container of numObjects ref_ptr<> numCopies times
+    using LocalObjects = std::vector<vsg::ref_ptr<LocalNode>>;
+    LocalObjects local_objects;
+    local_objects.reserve(numObjects);
+    for (unsigned int i = 0; i < numObjects; ++i)
+    {
+        local_objects.emplace_back(new LocalNode);
+    }
+
+    auto report = [&](const char* description, unsigned int numThreads, double time) {
+        double numRefUpdates = 2.0 * double(numObjects) * double(numCopies) * double(numThreads);
+        std::cout << "  " << description << " : " << time << " seconds, " << static_cast<size_t>(numRefUpdates / time) << " ref/unref per second." << std::endl;
+    };
+
+    std::cout << "\nCopy and destroy " << numObjects << " ref_ptr<> " << numCopies << " times per thread." << std::endl;
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int numThreads = 1; numThreads < maxThreads; numThreads *= 2) threadCounts.push_back(numThreads);
+    threadCounts.push_back(std::max(maxThreads, 1u));
+
+    for (auto numThreads : threadCounts)
+    {
+        std::cout << "threads = " << numThreads << std::endl;
+
+        // all threads share the same objects so contend for the same reference counts
+        report("shared vsg::Object", numThreads, runThreads(
+            numThreads, []() { return 0; }, [&](int) { copyAndDestroy(objects, numCopies); }));
+
+        report("shared LocalRefObject", numThreads, runThreads(
+            numThreads, []() { return 0; }, [&](int) { copyAndDestroy(local_objects, numCopies); }));
+
+        // each thread has its own objects, so there is no contention, just the cost of the atomic operations
+        report("thread local vsg::Object", numThreads, runThreads(
+            numThreads,
+            [&]() {
+                auto thread_objects = std::make_shared<Objects>();
+                thread_objects->reserve(numObjects);
+                for (unsigned int i = 0; i < numObjects; ++i) thread_objects->push_back(vsg::Node::create());
+                return thread_objects;
+            },
+            [&](std::shared_ptr<Objects>& thread_objects) { copyAndDestroy(*thread_objects, numCopies); }));
+
+        // each thread has its own objects confined to it, so reference counts use non atomic updates
+        report("confined LocalRefObject", numThreads, runThreads(
+            numThreads,
+            [&]() {
+                auto confinement = std::make_shared<experimental::ScopedThreadConfinement>();
+                auto thread_objects = std::make_shared<LocalObjects>();
+                thread_objects->reserve(numObjects);
+                for (unsigned int i = 0; i < numObjects; ++i)
+                {
+                    thread_objects->emplace_back(new LocalNode);
+                    confinement->add(thread_objects->back().get());
+                }
+                return std::make_pair(confinement, thread_objects);
+            },
+            [&](auto& state) { copyAndDestroy(*state.second, numCopies); }));
+    }
+
     return 0;
 }
@@ -0,0 +1,376 @@
+#include "AsyncReader.h"
+
+#include <vsg/io/mem_stream.h>
+
+#include <cerrno>
+
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <sys/uio.h>
+#    include <unistd.h>
+#endif
+
+#ifdef HAS_LIBURING
+#    include <liburing.h>
+#endif
+
+using namespace async;
+
+namespace
+{
+    struct DecodeRequest : public vsg::Inherit<vsg::Operation, DecodeRequest>
+    {
+        explicit DecodeRequest(std::shared_ptr<AsyncReader::Request> in_request) :
+            request(in_request) {}
+
+        std::shared_ptr<AsyncReader::Request> request;
+
+        void run() override
+        {
+            try
+            {
+                vsg::ref_ptr<vsg::Object> object;
+                if (!request->buffer.empty() && request->numBytesRead == request->buffer.size())
+                {
+                    auto options = request->options ? vsg::Options::create(*request->options) : vsg::Options::create();
+                    options->extensionHint = vsg::lowerCaseFileExtension(request->filenameToUse);
+                    options->paths.insert(options->paths.begin(), vsg::filePath(request->filenameToUse));
+
+                    // read from the file buffer without copying it
+                    vsg::mem_stream fin(reinterpret_cast<const uint8_t*>(request->buffer.data()), request->buffer.size());
+                    object = vsg::read(fin, options);
+
+                    std::vector<char>().swap(request->buffer);
+                }
+
+                // formats that can't be read from a stream, remote paths and files the I/O thread couldn't read are read directly
+                if (!object) object = vsg::read(request->filename, request->options);
+
+                request->promise.set_value(object);
+            }
+            catch (...)
+            {
+                request->promise.set_exception(std::current_exception());
+            }
+            request->completed = true;
+        }
+    };
+} // namespace
+
+AsyncReader::Request::~Request()
+{
+#ifndef _WIN32
+    if (fd >= 0) ::close(fd);
+#endif
+
+    // requests dropped at shutdown, still queued for I/O or decoding, complete with a null object rather than a broken promise
+    if (!completed) promise.set_value({});
+}
+
+AsyncReader::AsyncReader(uint32_t numDecodeThreads, uint32_t in_queueDepth) :
+    queueDepth(std::max(1u, in_queueDepth))
+{
+    _decodeThreads = vsg::OperationThreads::create(numDecodeThreads > 0 ? numDecodeThreads : std::max(1u, std::thread::hardware_concurrency()));
+
+#ifdef HAS_LIBURING
+    // io_uring can be disabled by the kernel or a container's seccomp profile, in which case fall back to preadv
+    auto ring = new io_uring;
+    if (io_uring_queue_init(queueDepth, ring, 0) == 0)
+    {
+        _ring = ring;
+        _usingIoUring = true;
+    }
+    else
+    {
+        delete ring;
+    }
+#endif
+
+    _ioThread = std::thread([this]() { run(); });
+}
+
+AsyncReader::~AsyncReader()
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _done = true;
+    }
+    _cv.notify_all();
+    _ioThread.join();
+
+#ifdef HAS_LIBURING
+    if (_ring)
+    {
+        auto ring = static_cast<io_uring*>(_ring);
+        io_uring_queue_exit(ring);
+        delete ring;
+    }
+#endif
+
+    // safe to release now the ring can no longer write into their buffers
+    _abandoned.clear();
+}
+
+std::future<vsg::ref_ptr<vsg::Object>> AsyncReader::load(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options)
+{
+    return std::move(load(vsg::Paths{filename}, options).front());
+}
+
+std::vector<std::future<vsg::ref_ptr<vsg::Object>>> AsyncReader::load(const vsg::Paths& filenames, vsg::ref_ptr<const vsg::Options> options)
+{
+    std::vector<std::future<vsg::ref_ptr<vsg::Object>>> futures;
+    futures.reserve(filenames.size());
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        for (auto& filename : filenames)
+        {
+            auto request = std::make_shared<Request>();
+            request->filename = filename;
+            request->options = options;
+            futures.push_back(request->promise.get_future());
+            _requests.push_back(request);
+        }
+    }
+    _cv.notify_one();
+    return futures;
+}
+
+void AsyncReader::run()
+{
+    while (true)
+    {
+        std::vector<std::shared_ptr<Request>> batch;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [&]() { return _done || !_requests.empty(); });
+            if (_done) return;
+
+            while (!_requests.empty() && batch.size() < queueDepth)
+            {
+                batch.push_back(_requests.front());
+                _requests.pop_front();
+            }
+        }
+
+        std::vector<std::shared_ptr<Request>> localFiles;
+        for (auto& request : batch)
+        {
+            if (open(*request))
+                localFiles.push_back(request);
+            else
+                decode(request);
+        }
+
+        if (localFiles.empty()) continue;
+
+        if (_usingIoUring)
+            readWithIoUring(localFiles);
+        else
+            readWithPreadv(localFiles);
+    }
+}
+
+bool AsyncReader::open(Request& request)
+{
+#ifndef _WIN32
+    request.filenameToUse = vsg::findFile(request.filename, request.options);
+    if (!request.filenameToUse) return false;
+
+    request.fd = ::open(request.filenameToUse.string().c_str(), O_RDONLY);
+    if (request.fd < 0) return false;
+
+    struct stat status;
+    if (fstat(request.fd, &status) != 0 || status.st_size == 0)
+    {
+        ::close(request.fd);
+        request.fd = -1;
+        return false;
+    }
+
+    request.buffer.resize(static_cast<size_t>(status.st_size));
+    return true;
+#else
+    // no preadv or io_uring, so leave the read to vsg::read(filename, options) on the decode threads
+    return false;
+#endif
+}
+
+void AsyncReader::decode(std::shared_ptr<Request> request)
+{
+#ifndef _WIN32
+    if (request->fd >= 0)
+    {
+        ::close(request->fd);
+        request->fd = -1;
+    }
+#endif
+    _decodeThreads->add(DecodeRequest::create(request));
+}
+
+void AsyncReader::readWithPreadv(std::vector<std::shared_ptr<Request>>& batch)
+{
+#ifndef _WIN32
+    constexpr size_t maxBlocks = 16;
+    iovec blocks[maxBlocks];
+
+    for (auto& request : batch)
+    {
+        auto size = request->buffer.size();
+        while (request->numBytesRead < size)
+        {
+            size_t numBlocks = 0;
+            for (size_t offset = request->numBytesRead; offset < size && numBlocks < maxBlocks; offset += blockSize, ++numBlocks)
+            {
+                blocks[numBlocks].iov_base = request->buffer.data() + offset;
+                blocks[numBlocks].iov_len = std::min(blockSize, size - offset);
+            }
+
+            auto result = preadv(request->fd, blocks, static_cast<int>(numBlocks), static_cast<off_t>(request->numBytesRead));
+            if (result <= 0) break;
+            request->numBytesRead += static_cast<size_t>(result);
+        }
+
+        decode(request);
+    }
+#else
+    for (auto& request : batch) decode(request);
+#endif
+}
+
+void AsyncReader::readWithIoUring(std::vector<std::shared_ptr<Request>>& batch)
+{
+#ifdef HAS_LIBURING
+    auto ring = static_cast<io_uring*>(_ring);
+
+    std::vector<bool> inFlight(batch.size(), false);
+
+    auto submit = [&](size_t index) -> bool {
+        auto& request = batch[index];
+        auto sqe = io_uring_get_sqe(ring);
+        if (!sqe) return false;
+
+        auto remaining = request->buffer.size() - request->numBytesRead;
+        io_uring_prep_read(sqe, request->fd, request->buffer.data() + request->numBytesRead, static_cast<unsigned>(std::min(remaining, size_t(1) << 30)), request->numBytesRead);
+        io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(index)));
+        inFlight[index] = true;
+        return true;
+    };
+
+    // wait for the next completion, returning its user data and result, or false if waiting failed
+    auto wait = [&](uintptr_t& data, int& result) -> bool {
+        io_uring_cqe* cqe = nullptr;
+        int status = 0;
+        while ((status = io_uring_wait_cqe(ring, &cqe)) == -EINTR) {}
+        if (status < 0) return false;
+
+        data = reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe));
+        result = cqe->res;
+        io_uring_cqe_seen(ring, cqe);
+        return true;
+    };
+
+    size_t pending = 0;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        if (submit(i)) ++pending;
+    }
+    io_uring_submit(ring);
+
+    std::vector<bool> completed(batch.size(), false);
+    while (pending > 0)
+    {
+        uintptr_t data = 0;
+        int result = 0;
+        if (!wait(data, result)) break;
+
+        auto index = static_cast<size_t>(data);
+        inFlight[index] = false;
+        --pending;
+
+        auto& request = batch[index];
+        if (result > 0)
+        {
+            request->numBytesRead += static_cast<size_t>(result);
+
+            // short read, queue the remainder
+            if (request->numBytesRead < request->buffer.size() && submit(index))
+            {
+                ++pending;
+                io_uring_submit(ring);
+                continue;
+            }
+        }
+
+        completed[index] = true;
+        decode(request);
+    }
+
+    if (pending > 0)
+    {
+        // waiting failed with reads still in flight, the kernel may still be writing into their buffers so cancel them
+        // and reap all their completions before the buffers are read into again
+        constexpr uintptr_t cancelData = ~uintptr_t(0);
+        size_t pendingCancels = 0;
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            if (!inFlight[i]) continue;
+
+            auto sqe = io_uring_get_sqe(ring);
+            if (!sqe)
+            {
+                io_uring_submit(ring);
+                sqe = io_uring_get_sqe(ring);
+            }
+            if (!sqe) break;
+
+            io_uring_prep_cancel(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(i)), 0);
+            io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(cancelData));
+            ++pendingCancels;
+        }
+        io_uring_submit(ring);
+
+        while (pending > 0 || pendingCancels > 0)
+        {
+            uintptr_t data = 0;
+            int result = 0;
+            if (!wait(data, result)) break;
+
+            if (data == cancelData)
+            {
+                --pendingCancels;
+            }
+            else
+            {
+                inFlight[static_cast<size_t>(data)] = false;
+                --pending;
+            }
+        }
+    }
+
+    // anything left over from a failed wait is read again from the start with preadv
+    std::vector<std::shared_ptr<Request>> remaining;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        if (completed[i]) continue;
+
+        auto& request = batch[i];
+        request->numBytesRead = 0;
+
+        if (inFlight[i])
+        {
+            // the read couldn't be reaped, so leave its buffer alone and keep it allocated until the ring is torn down,
+            // decoding falls back to reading the file directly as the buffer is incomplete
+            _abandoned.push_back(request);
+            decode(request);
+        }
+        else
+        {
+            remaining.push_back(request);
+        }
+    }
+    if (!remaining.empty()) readWithPreadv(remaining);
+#else
+    readWithPreadv(batch);
+#endif
+}
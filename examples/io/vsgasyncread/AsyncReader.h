@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+
+namespace async
+{
+
+    /// Reader that overlaps disk I/O with decoding. File reads are issued from a dedicated I/O thread, batched through io_uring where available
+    /// and falling back to preadv, with each completed buffer handed to OperationThreads for decoding through vsg::read(std::istream&, options).
+    /// Paths that can't be found locally, such as remote URLs, are passed straight to vsg::read(filename, options) on the decode threads.
+    /// Requests still pending when the AsyncReader is destroyed have their futures set to a null object, as with a failed read.
+    class AsyncReader : public vsg::Inherit<vsg::Object, AsyncReader>
+    {
+    public:
+        explicit AsyncReader(uint32_t numDecodeThreads = 0, uint32_t in_queueDepth = 32);
+
+        /// maximum number of reads in flight on the I/O thread.
+        const uint32_t queueDepth = 32;
+
+        /// size of the blocks read into with preadv.
+        size_t blockSize = 1024 * 1024;
+
+        /// queue the read of a single file.
+        std::future<vsg::ref_ptr<vsg::Object>> load(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {});
+
+        /// queue the reads of a list of files, returning a future per file in the same order.
+        std::vector<std::future<vsg::ref_ptr<vsg::Object>>> load(const vsg::Paths& filenames, vsg::ref_ptr<const vsg::Options> options = {});
+
+        /// true if reads are being issued through io_uring.
+        bool usingIoUring() const { return _usingIoUring; }
+
+        struct Request
+        {
+            ~Request();
+
+            vsg::Path filename;
+            vsg::Path filenameToUse;
+            vsg::ref_ptr<const vsg::Options> options;
+            std::promise<vsg::ref_ptr<vsg::Object>> promise;
+            bool completed = false;
+            std::vector<char> buffer;
+            size_t numBytesRead = 0;
+            int fd = -1;
+        };
+
+    protected:
+        virtual ~AsyncReader();
+
+        void run();
+        void readWithPreadv(std::vector<std::shared_ptr<Request>>& batch);
+        void readWithIoUring(std::vector<std::shared_ptr<Request>>& batch);
+        bool open(Request& request);
+        void decode(std::shared_ptr<Request> request);
+
+        vsg::ref_ptr<vsg::OperationThreads> _decodeThreads;
+
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<std::shared_ptr<Request>> _requests;
+        bool _done = false;
+        bool _usingIoUring = false;
+        void* _ring = nullptr;
+
+        /// requests whose io_uring reads couldn't be cancelled and reaped, kept until the ring is torn down
+        std::vector<std::shared_ptr<Request>> _abandoned;
+
+        std::thread _ioThread;
+    };
+
+} // namespace async
+
+EVSG_type_name(async::AsyncReader);
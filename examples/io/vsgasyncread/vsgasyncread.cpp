@@ -0,0 +1,175 @@
+#include <vsg/all.h>
+
+#ifdef vsgXchange_FOUND
+#    include <vsgXchange/all.h>
+#endif
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+
+#ifdef __linux__
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+#include "AsyncReader.h"
+
+// create a tile with its own vertex, normal and index arrays
+vsg::ref_ptr<vsg::Node> createTile(uint32_t index, uint32_t numVertices)
+{
+    std::mt19937 generator(index);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    auto vertices = vsg::vec3Array::create(numVertices);
+    auto normals = vsg::vec3Array::create(numVertices);
+    auto indices = vsg::uintArray::create(numVertices);
+    for (uint32_t i = 0; i < numVertices; ++i)
+    {
+        vertices->at(i).set(distribution(generator), distribution(generator), distribution(generator));
+        normals->at(i) = vsg::normalize(vertices->at(i));
+        indices->at(i) = i;
+    }
+
+    auto vid = vsg::VertexIndexDraw::create();
+    vid->assignArrays(vsg::DataList{vertices, normals});
+    vid->assignIndices(indices);
+    vid->indexCount = numVertices;
+    vid->instanceCount = 1;
+    return vid;
+}
+
+// ask the kernel to drop the cached pages of the files so the next read comes from disk, returns false where not supported.
+bool evictFromPageCache(const vsg::Paths& filenames)
+{
+#ifdef __linux__
+    for (auto& filename : filenames)
+    {
+        int fd = open(filename.string().c_str(), O_RDONLY);
+        if (fd < 0) continue;
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto directory = arguments.value<vsg::Path>("", "-d");
+    auto extension = arguments.value<vsg::Path>("", "--ext");
+    auto numTiles = arguments.value(256u, "--tiles");
+    auto numVertices = arguments.value(20000u, "--vertices");
+    auto numThreads = arguments.value(std::max(1u, std::thread::hardware_concurrency()), "--threads");
+    auto queueDepth = arguments.value(32u, "--queue-depth");
+
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+
+#ifdef vsgXchange_all
+    options->add(vsgXchange::all::create());
+#endif
+
+    options->readOptions(arguments);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    vsg::Paths filenames;
+    if (directory)
+    {
+        for (auto& name : vsg::getDirectoryContents(directory))
+        {
+            if (name == "." || name == "..") continue;
+            if (extension && vsg::lowerCaseFileExtension(name) != extension) continue;
+            filenames.push_back(directory / name);
+        }
+    }
+    else
+    {
+        // generate a directory of tiles to read
+        directory = "async_tiles";
+        vsg::makeDirectory(directory);
+        for (uint32_t i = 0; i < numTiles; ++i)
+        {
+            auto filename = directory / vsg::make_string("tile_", i, ".vsgb");
+            vsg::write(createTile(i, numVertices), filename, options);
+            filenames.push_back(filename);
+        }
+    }
+
+    if (filenames.empty())
+    {
+        std::cout << "No files to read." << std::endl;
+        return 1;
+    }
+
+    auto asyncReader = async::AsyncReader::create(numThreads, queueDepth);
+
+    auto threadedOptions = vsg::Options::create(*options);
+    threadedOptions->operationThreads = vsg::OperationThreads::create(numThreads);
+
+    using clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](clock::time_point start) { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
+
+    struct Method
+    {
+        std::string name;
+        std::function<size_t()> read;
+    };
+
+    std::vector<Method> methods{
+        {"vsg::read(filename) per file", [&]() {
+             size_t numRead = 0;
+             for (auto& filename : filenames)
+             {
+                 if (vsg::read(filename, options)) ++numRead;
+             }
+             return numRead;
+         }},
+        {"vsg::read(filenames) with operationThreads", [&]() {
+             size_t numRead = 0;
+             for (auto& [filename, object] : vsg::read(filenames, threadedOptions))
+             {
+                 if (object) ++numRead;
+             }
+             return numRead;
+         }},
+        {std::string("AsyncReader") + (asyncReader->usingIoUring() ? " (io_uring)" : " (preadv)"), [&]() {
+             size_t numRead = 0;
+             for (auto& future : asyncReader->load(filenames, options))
+             {
+                 if (future.get()) ++numRead;
+             }
+             return numRead;
+         }}};
+
+    std::cout << "Reading " << filenames.size() << " files from " << directory << " with " << numThreads << " threads" << std::endl;
+
+    for (bool cold : {true, false})
+    {
+        if (cold && !evictFromPageCache(filenames))
+        {
+            std::cout << "\nCold cache reads not supported on this platform." << std::endl;
+            continue;
+        }
+
+        std::cout << "\n" << (cold ? "Cold" : "Warm") << " cache:" << std::endl;
+        for (auto& method : methods)
+        {
+            if (cold) evictFromPageCache(filenames);
+
+            auto start = clock::now();
+            auto numRead = method.read();
+            auto time = milliseconds(start);
+
+            std::cout << "    " << method.name << " : " << time << "ms, " << numRead << " of " << filenames.size() << " read" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,460 @@
+#include "ChunkedReaderWriter.h"
+
+#include "FindSubgraphs.h"
+
+#include <vsg/io/mem_stream.h>
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace chunked;
+
+// Register the ChunkReference::create() method with vsg::ObjectFactory::instance() so it can be used for creating objects during reading.
+vsg::RegisterWithObjectFactoryProxy<ChunkReference> s_Register_ChunkReference;
+
+namespace
+{
+    const char s_magic[8] = {'v', 's', 'g', 'c', ' ', 'v', '1', '\n'};
+
+    struct Header
+    {
+        char magic[8];
+        vsg::VsgVersion version;
+        uint64_t numChunks = 0;
+        uint64_t indexOffset = 0;
+        uint64_t numDependencies = 0;
+    };
+
+    struct ChunkEntry
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t firstDependency = 0;
+        uint32_t numDependencies = 0;
+    };
+
+    using ChunkIndices = std::map<const vsg::Object*, uint32_t>;
+
+    // BinaryOutput to a null stream that records which chunk each object is first reached from, collecting large Data
+    // and objects reached from more than one chunk as new chunk roots. Using the serializer to walk the graph ensures
+    // all references are found, including ones not visited by Object::traverse().
+    class ReferenceCollector : public vsg::BinaryOutput
+    {
+    public:
+        ReferenceCollector(std::ostream& output, vsg::ref_ptr<const vsg::Options> in_options, const ChunkIndices& in_chunkIndices, size_t in_minimumChunkSize,
+                           std::map<const vsg::Object*, uint32_t>& in_owners, std::set<const vsg::Object*>& in_newRoots) :
+            vsg::BinaryOutput(output, in_options),
+            chunkIndices(in_chunkIndices),
+            minimumChunkSize(in_minimumChunkSize),
+            owners(in_owners),
+            newRoots(in_newRoots)
+        {
+        }
+
+        const ChunkIndices& chunkIndices;
+        size_t minimumChunkSize;
+        std::map<const vsg::Object*, uint32_t>& owners;
+        std::set<const vsg::Object*>& newRoots;
+
+        const vsg::Object* root = nullptr;
+        uint32_t chunk = 0;
+
+        using vsg::BinaryOutput::write;
+
+        void write(const vsg::Object* object) override
+        {
+            if (object && object != root)
+            {
+                // references to other chunks are analysed when that chunk is collected
+                if (chunkIndices.count(object) > 0) return;
+
+                auto data = object->cast<vsg::Data>();
+                if (data && data->dataSize() >= minimumChunkSize)
+                {
+                    newRoots.insert(object);
+                    return;
+                }
+
+                auto [itr, inserted] = owners.emplace(object, chunk);
+                if (!inserted && itr->second != chunk)
+                {
+                    newRoots.insert(object);
+                    return;
+                }
+            }
+
+            vsg::BinaryOutput::write(object);
+        }
+    };
+
+    // BinaryOutput that writes a ChunkReference in place of objects stored in other chunks, recording them as dependencies of this chunk
+    class ChunkOutput : public vsg::BinaryOutput
+    {
+    public:
+        ChunkOutput(std::ostream& output, vsg::ref_ptr<const vsg::Options> in_options, const ChunkIndices& in_chunkIndices, const vsg::Object* in_root) :
+            vsg::BinaryOutput(output, in_options),
+            chunkIndices(in_chunkIndices),
+            root(in_root)
+        {
+        }
+
+        const ChunkIndices& chunkIndices;
+        const vsg::Object* root = nullptr;
+        std::map<uint32_t, vsg::ref_ptr<ChunkReference>> references;
+        std::vector<uint32_t> dependencies;
+
+        using vsg::BinaryOutput::write;
+
+        void write(const vsg::Object* object) override
+        {
+            if (object && object != root)
+            {
+                if (auto itr = chunkIndices.find(object); itr != chunkIndices.end())
+                {
+                    auto& reference = references[itr->second];
+                    if (!reference)
+                    {
+                        reference = ChunkReference::create();
+                        reference->index = itr->second;
+                        dependencies.push_back(itr->second);
+                    }
+                    vsg::BinaryOutput::write(reference.get());
+                    return;
+                }
+            }
+
+            vsg::BinaryOutput::write(object);
+        }
+    };
+
+    // state shared by the decode operations of a read
+    struct DecodeContext : public vsg::Inherit<vsg::Object, DecodeContext>
+    {
+        std::vector<char> buffer;
+        vsg::VsgVersion version;
+        vsg::ref_ptr<const vsg::Options> options;
+        std::vector<ChunkEntry> entries;
+        std::vector<std::vector<uint32_t>> dependents;
+        std::unique_ptr<std::atomic_uint[]> remainingDependencies;
+        std::vector<vsg::ref_ptr<vsg::Object>> objects;
+        vsg::ref_ptr<vsg::OperationThreads> operationThreads;
+        vsg::ref_ptr<vsg::Latch> latch;
+    };
+
+    // BinaryInput that replaces ChunkReference with the already decoded object of that chunk
+    class ChunkInput : public vsg::BinaryInput
+    {
+    public:
+        ChunkInput(std::istream& input, DecodeContext& in_context) :
+            vsg::BinaryInput(input, vsg::ObjectFactory::instance(), in_context.options),
+            context(in_context)
+        {
+            version = context.version;
+        }
+
+        DecodeContext& context;
+
+        using vsg::BinaryInput::read;
+
+        vsg::ref_ptr<vsg::Object> read() override
+        {
+            auto object = vsg::BinaryInput::read();
+            if (auto reference = object.cast<ChunkReference>())
+            {
+                return (reference->index < context.objects.size()) ? context.objects[reference->index] : vsg::ref_ptr<vsg::Object>();
+            }
+            return object;
+        }
+    };
+
+    struct DecodeChunk : public vsg::Inherit<vsg::Operation, DecodeChunk>
+    {
+        DecodeChunk(vsg::ref_ptr<DecodeContext> in_context, uint32_t in_index) :
+            context(in_context),
+            index(in_index) {}
+
+        vsg::ref_ptr<DecodeContext> context;
+        uint32_t index = 0;
+
+        void run() override
+        {
+            auto& entry = context->entries[index];
+
+            // read directly from the file buffer without copying the chunk
+            vsg::mem_stream fin(reinterpret_cast<const uint8_t*>(context->buffer.data() + entry.offset), static_cast<size_t>(entry.size));
+
+            ChunkInput input(fin, *context);
+            context->objects[index] = input.readObject<vsg::Object>("Root");
+
+            // schedule any chunks that were waiting on this one
+            for (auto dependent : context->dependents[index])
+            {
+                if (--context->remainingDependencies[dependent] == 0) context->operationThreads->add(DecodeChunk::create(context, dependent));
+            }
+
+            context->latch->count_down();
+        }
+    };
+
+    // return true if the chunk dependencies contain a cycle, in which case the chunks couldn't be decoded in dependency order
+    bool hasCycle(const std::vector<std::vector<uint32_t>>& dependencies)
+    {
+        enum State : uint8_t
+        {
+            UNVISITED,
+            VISITING,
+            VISITED
+        };
+        std::vector<State> states(dependencies.size(), UNVISITED);
+
+        std::function<bool(uint32_t)> visit = [&](uint32_t i) -> bool {
+            if (states[i] == VISITING) return true;
+            if (states[i] == VISITED) return false;
+            states[i] = VISITING;
+            for (auto d : dependencies[i])
+            {
+                if (visit(d)) return true;
+            }
+            states[i] = VISITED;
+            return false;
+        };
+
+        for (uint32_t i = 0; i < dependencies.size(); ++i)
+        {
+            if (visit(i)) return true;
+        }
+        return false;
+    }
+} // namespace
+
+void ChunkReference::read(vsg::Input& input)
+{
+    vsg::Object::read(input);
+    input.read("index", index);
+}
+
+void ChunkReference::write(vsg::Output& output) const
+{
+    vsg::Object::write(output);
+    output.write("index", index);
+}
+
+bool ChunkedReaderWriter::getFeatures(Features& features) const
+{
+    features.extensionFeatureMap[".vsgc"] = static_cast<FeatureMask>(READ_FILENAME | WRITE_FILENAME);
+    return true;
+}
+
+bool ChunkedReaderWriter::write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgc" || !object) return false;
+
+    // chunk 0 is always the root object
+    std::vector<const vsg::Object*> chunkRoots{object};
+    ChunkIndices chunkIndices{{object, 0}};
+
+    auto addChunkRoot = [&](const vsg::Object* root) {
+        if (chunkIndices.emplace(root, static_cast<uint32_t>(chunkRoots.size())).second) chunkRoots.push_back(root);
+    };
+
+    FindSubgraphs findSubgraphs(splitLevel);
+    object->accept(findSubgraphs);
+    for (auto subgraph : findSubgraphs.subgraphs) addChunkRoot(subgraph);
+
+    // find large Data and shared objects, repeating until no more new chunk roots are found as each new chunk can make more objects shared
+    std::ostream nullStream(nullptr);
+    while (true)
+    {
+        std::map<const vsg::Object*, uint32_t> owners;
+        std::set<const vsg::Object*> newRoots;
+        for (uint32_t i = 0; i < chunkRoots.size(); ++i)
+        {
+            ReferenceCollector collector(nullStream, options, chunkIndices, minimumChunkSize, owners, newRoots);
+            collector.version = vsg::vsgGetVersion();
+            collector.root = chunkRoots[i];
+            collector.chunk = i;
+            collector.writeObject("Root", chunkRoots[i]);
+        }
+
+        if (newRoots.empty()) break;
+        for (auto root : newRoots) addChunkRoot(root);
+    }
+
+    // serialize each chunk
+    std::vector<std::string> chunks(chunkRoots.size());
+    std::vector<std::vector<uint32_t>> dependencies(chunkRoots.size());
+    for (uint32_t i = 0; i < chunkRoots.size(); ++i)
+    {
+        std::ostringstream chunkStream(std::ios::out | std::ios::binary);
+        ChunkOutput output(chunkStream, options, chunkIndices, chunkRoots[i]);
+        output.version = vsg::vsgGetVersion();
+        output.writeObject("Root", chunkRoots[i]);
+
+        chunks[i] = chunkStream.str();
+        dependencies[i] = output.dependencies;
+    }
+
+    if (hasCycle(dependencies))
+    {
+        vsg::warn("ChunkedReaderWriter::write(", filename, ") cyclic references between chunks, writing as a single chunk.");
+
+        std::ostringstream chunkStream(std::ios::out | std::ios::binary);
+        vsg::BinaryOutput output(chunkStream, options);
+        output.version = vsg::vsgGetVersion();
+        output.writeObject("Root", object);
+
+        chunks = {chunkStream.str()};
+        dependencies = {{}};
+    }
+
+    Header header;
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = vsg::vsgGetVersion();
+    header.numChunks = chunks.size();
+
+    std::vector<ChunkEntry> entries(chunks.size());
+    std::vector<uint32_t> allDependencies;
+    uint64_t offset = sizeof(Header);
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        auto& entry = entries[i];
+        entry.offset = offset;
+        entry.size = chunks[i].size();
+        entry.firstDependency = static_cast<uint32_t>(allDependencies.size());
+        entry.numDependencies = static_cast<uint32_t>(dependencies[i].size());
+        allDependencies.insert(allDependencies.end(), dependencies[i].begin(), dependencies[i].end());
+        offset += entry.size;
+    }
+    header.indexOffset = offset;
+    header.numDependencies = allDependencies.size();
+
+    std::ofstream fout(filename, std::ios::out | std::ios::binary);
+    if (!fout) return false;
+
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    for (auto& chunk : chunks) fout.write(chunk.data(), chunk.size());
+    fout.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ChunkEntry));
+    fout.write(reinterpret_cast<const char*>(allDependencies.data()), allDependencies.size() * sizeof(uint32_t));
+
+    return fout.good();
+}
+
+uint64_t ChunkedReaderWriter::readNumChunks(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgc") return 0;
+
+    auto filenameToUse = vsg::findFile(filename, options);
+    if (!filenameToUse) return 0;
+
+    std::ifstream fin(filenameToUse, std::ios::in | std::ios::binary);
+
+    Header header;
+    if (!fin.read(reinterpret_cast<char*>(&header), sizeof(Header))) return 0;
+    if (std::memcmp(header.magic, s_magic, sizeof(s_magic)) != 0) return 0;
+
+    return header.numChunks;
+}
+
+vsg::ref_ptr<vsg::Object> ChunkedReaderWriter::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgc") return {};
+
+    auto filenameToUse = vsg::findFile(filename, options);
+    if (!filenameToUse) return {};
+
+    auto context = DecodeContext::create();
+    context->options = options;
+
+    // read the whole file in a single read so decoding isn't interleaved with I/O
+    {
+        std::ifstream fin(filenameToUse, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!fin) return {};
+
+        auto fileSize = static_cast<size_t>(fin.tellg());
+        if (fileSize < sizeof(Header)) return {};
+
+        context->buffer.resize(fileSize);
+        fin.seekg(0);
+        fin.read(context->buffer.data(), fileSize);
+        if (!fin) return {};
+    }
+
+    Header header;
+    std::memcpy(&header, context->buffer.data(), sizeof(Header));
+    if (std::memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.numChunks == 0) return {};
+
+    auto indexSize = header.numChunks * sizeof(ChunkEntry) + header.numDependencies * sizeof(uint32_t);
+    if (header.indexOffset + indexSize > context->buffer.size())
+    {
+        vsg::warn("ChunkedReaderWriter::read(", filenameToUse, ") file truncated.");
+        return {};
+    }
+
+    auto numChunks = static_cast<uint32_t>(header.numChunks);
+    context->version = header.version;
+    context->entries.resize(numChunks);
+    std::memcpy(context->entries.data(), context->buffer.data() + header.indexOffset, numChunks * sizeof(ChunkEntry));
+
+    std::vector<uint32_t> allDependencies(header.numDependencies);
+    std::memcpy(allDependencies.data(), context->buffer.data() + header.indexOffset + numChunks * sizeof(ChunkEntry), allDependencies.size() * sizeof(uint32_t));
+
+    context->objects.resize(numChunks);
+    context->dependents.resize(numChunks);
+    context->remainingDependencies.reset(new std::atomic_uint[numChunks]);
+    std::vector<std::vector<uint32_t>> dependencies(numChunks);
+    for (uint32_t i = 0; i < numChunks; ++i)
+    {
+        auto& entry = context->entries[i];
+        if (entry.offset + entry.size > header.indexOffset || entry.firstDependency + entry.numDependencies > allDependencies.size())
+        {
+            vsg::warn("ChunkedReaderWriter::read(", filenameToUse, ") invalid chunk index.");
+            return {};
+        }
+
+        context->remainingDependencies[i] = entry.numDependencies;
+        for (uint32_t d = 0; d < entry.numDependencies; ++d)
+        {
+            auto dependency = allDependencies[entry.firstDependency + d];
+            if (dependency >= numChunks)
+            {
+                vsg::warn("ChunkedReaderWriter::read(", filenameToUse, ") invalid chunk dependency.");
+                return {};
+            }
+            context->dependents[dependency].push_back(i);
+            dependencies[i].push_back(dependency);
+        }
+    }
+
+    // chunks in a cycle would never have their dependencies complete, leaving the latch below waiting forever
+    if (hasCycle(dependencies))
+    {
+        vsg::warn("ChunkedReaderWriter::read(", filenameToUse, ") cyclic dependencies between chunks.");
+        return {};
+    }
+
+    context->operationThreads = options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>();
+    if (!context->operationThreads) context->operationThreads = vsg::OperationThreads::create(numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency()));
+
+    context->latch = vsg::Latch::create(static_cast<int>(numChunks));
+
+    // start with the chunks that don't depend on any others, the rest are scheduled as their dependencies complete
+    for (uint32_t i = 0; i < numChunks; ++i)
+    {
+        if (context->entries[i].numDependencies == 0) context->operationThreads->add(DecodeChunk::create(context, i));
+    }
+
+    context->latch->wait();
+
+    auto root = context->objects[0];
+
+    // release the references the operations hold, breaking the cycle between the context and its operationThreads
+    context->objects.clear();
+    context->operationThreads = {};
+
+    return root;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vsg/all.h>
+
+namespace chunked
+{
+
+    /// Placeholder written in place of an object stored in another chunk.
+    class ChunkReference : public vsg::Inherit<vsg::Object, ChunkReference>
+    {
+    public:
+        uint32_t index = 0;
+
+        void read(vsg::Input& input) override;
+        void write(vsg::Output& output) const override;
+    };
+
+    /// ReaderWriter for .vsgc files, a chunked variant of the native binary format.
+    /// The scene graph is split into separately indexed chunks, each a native binary stream: the root chunk, the subgraphs below splitLevel,
+    /// large Data payloads, and any objects shared between chunks. On read the chunks are decoded in parallel on OperationThreads,
+    /// each chunk being decoded once the chunks it references are available, so shared objects are stitched back together as single instances.
+    class ChunkedReaderWriter : public vsg::Inherit<vsg::ReaderWriter, ChunkedReaderWriter>
+    {
+    public:
+        /// depth of Group nesting at which children are written as separate chunks, the default of 1 splits out the children of the root's child groups.
+        uint32_t splitLevel = 1;
+
+        /// Data objects of at least this size are written as separate chunks.
+        size_t minimumChunkSize = 1024 * 1024;
+
+        /// number of threads to decode with when Options::operationThreads isn't assigned.
+        uint32_t numThreads = 0;
+
+        vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+        bool write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+        /// return the number of chunks in a .vsgc file from its header, 0 if the file can't be read or isn't a .vsgc file.
+        uint64_t readNumChunks(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const;
+
+        bool getFeatures(Features& features) const override;
+    };
+
+} // namespace chunked
+
+EVSG_type_name(chunked::ChunkReference);
+EVSG_type_name(chunked::ChunkedReaderWriter);
@@ -0,0 +1,153 @@
+#include <vsg/all.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+#include <thread>
+
+#include "ChunkedReaderWriter.h"
+
+// create a scene graph of numSubgraphs VertexIndexDraw, with a total of numVertices vertices, all sharing a single index array
+vsg::ref_ptr<vsg::Node> createLargeModel(uint32_t numVertices, uint32_t numSubgraphs)
+{
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+
+    uint32_t verticesPerSubgraph = std::max(1u, numVertices / numSubgraphs);
+    uint32_t subgraphsPerGroup = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(numSubgraphs))));
+
+    auto indices = vsg::uintArray::create(verticesPerSubgraph);
+    for (uint32_t i = 0; i < verticesPerSubgraph; ++i) indices->at(i) = i;
+
+    auto root = vsg::Group::create();
+    vsg::ref_ptr<vsg::Group> group;
+    for (uint32_t s = 0; s < numSubgraphs; ++s)
+    {
+        if (s % subgraphsPerGroup == 0)
+        {
+            group = vsg::Group::create();
+            root->addChild(group);
+        }
+
+        auto vertices = vsg::vec3Array::create(verticesPerSubgraph);
+        auto normals = vsg::vec3Array::create(verticesPerSubgraph);
+        for (uint32_t i = 0; i < verticesPerSubgraph; ++i)
+        {
+            vertices->at(i).set(distribution(generator), distribution(generator), distribution(generator));
+            normals->at(i) = vsg::normalize(vertices->at(i));
+        }
+
+        auto vid = vsg::VertexIndexDraw::create();
+        vid->assignArrays(vsg::DataList{vertices, normals});
+        vid->assignIndices(indices);
+        vid->indexCount = verticesPerSubgraph;
+        vid->instanceCount = 1;
+
+        group->addChild(vid);
+    }
+    return root;
+}
+
+// count the vertices and the distinct index arrays to check the graph read back matches, including the sharing of the index array
+struct CheckModel : public vsg::Inherit<vsg::ConstVisitor, CheckModel>
+{
+    size_t numVertices = 0;
+    std::set<const vsg::Data*> indexArrays;
+
+    void apply(const vsg::Node& node) override
+    {
+        node.traverse(*this);
+    }
+
+    void apply(const vsg::VertexIndexDraw& vid) override
+    {
+        if (!vid.arrays.empty() && vid.arrays[0]->data) numVertices += vid.arrays[0]->data->valueCount();
+        if (vid.indices && vid.indices->data) indexArrays.insert(vid.indices->data.get());
+    }
+};
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto numVertices = arguments.value(10000000u, "--vertices");
+    auto numSubgraphs = arguments.value(256u, "--subgraphs");
+    auto inputFilename = arguments.value<vsg::Path>("", "-i");
+    auto outputFilename = arguments.value<vsg::Path>("chunked_test", "-o");
+    auto maxThreads = arguments.value(std::thread::hardware_concurrency(), "--threads");
+
+    auto chunkedReaderWriter = chunked::ChunkedReaderWriter::create();
+    arguments.read("--split-level", chunkedReaderWriter->splitLevel);
+    arguments.read("--min-chunk-size", chunkedReaderWriter->minimumChunkSize);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto options = vsg::Options::create();
+    options->add(chunkedReaderWriter);
+
+    vsg::Path binaryFilename = outputFilename.string() + ".vsgb";
+    vsg::Path chunkedFilename = outputFilename.string() + ".vsgc";
+
+    using clock = std::chrono::high_resolution_clock;
+    auto seconds = [](clock::time_point start) { return std::chrono::duration<double>(clock::now() - start).count(); };
+
+    vsg::ref_ptr<vsg::Object> object;
+    if (inputFilename)
+    {
+        object = vsg::read(inputFilename, options);
+        if (!object)
+        {
+            std::cout << "Warning: file not read : " << inputFilename << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        object = createLargeModel(numVertices, numSubgraphs);
+    }
+
+    auto start = clock::now();
+    vsg::write(object, binaryFilename, options);
+    std::cout << "Written " << binaryFilename << " in " << seconds(start) << " seconds." << std::endl;
+
+    start = clock::now();
+    vsg::write(object, chunkedFilename, options);
+    std::cout << "Written " << chunkedFilename << " in " << seconds(start) << " seconds." << std::endl;
+
+    // a single chunk is decoded on one thread whatever the thread count, so there would be no speed up to report
+    auto numChunks = chunkedReaderWriter->readNumChunks(chunkedFilename, options);
+    std::cout << chunkedFilename << " has " << numChunks << " chunks." << std::endl;
+    if (numChunks <= 1)
+    {
+        std::cout << "Warning: model was written as a single chunk, use a lower --split-level or --min-chunk-size to split it." << std::endl;
+        return 1;
+    }
+
+    auto report = [&](const std::string& description, vsg::ref_ptr<vsg::Object> loaded, double time) {
+        CheckModel checkModel;
+        if (loaded) loaded->accept(checkModel);
+        std::cout << description << " : " << time * 1000.0 << "ms, vertices = " << checkModel.numVertices << ", index arrays = " << checkModel.indexArrays.size() << std::endl;
+    };
+
+    object = {};
+
+    start = clock::now();
+    auto binaryObject = vsg::read(binaryFilename, options);
+    report("vsg::VSG read " + binaryFilename.string(), binaryObject, seconds(start));
+    binaryObject = {};
+
+    for (uint32_t numThreads = 1; numThreads <= std::max(maxThreads, 1u); numThreads *= 2)
+    {
+        // start the threads before timing so only the read and decode is measured
+        options->operationThreads = vsg::OperationThreads::create(numThreads);
+
+        start = clock::now();
+        auto chunkedObject = vsg::read(chunkedFilename, options);
+        report("ChunkedReaderWriter read " + chunkedFilename.string() + " threads = " + std::to_string(numThreads), chunkedObject, seconds(start));
+
+        options->operationThreads = {};
+    }
+
+    return 0;
+}
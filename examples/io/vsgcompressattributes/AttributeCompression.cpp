@@ -0,0 +1,746 @@
+#include "AttributeCompression.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+using namespace compress;
+
+// Register the EncodedArray::create() method with vsg::ObjectFactory::instance() so it can be used for creating objects during reading.
+vsg::RegisterWithObjectFactoryProxy<EncodedArray> s_Register_EncodedArray;
+
+namespace
+{
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        uint32_t sign = (bits >> 16) & 0x8000;
+        int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+        uint32_t mantissa = bits & 0x7fffff;
+
+        if (((bits >> 23) & 0xff) == 0xff) return static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+        if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7c00);
+
+        if (exponent <= 0)
+        {
+            // subnormal half
+            if (exponent < -10) return static_cast<uint16_t>(sign);
+
+            mantissa |= 0x800000;
+            uint32_t shift = static_cast<uint32_t>(14 - exponent);
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1))) ++half;
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        // round to nearest even, a carry out of the mantissa correctly increments the exponent
+        uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        uint32_t remainder = mantissa & 0x1fff;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ++half;
+        return static_cast<uint16_t>(half);
+    }
+
+    float halfToFloat(uint16_t half)
+    {
+        uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+        uint32_t exponent = (half >> 10) & 0x1f;
+        uint32_t mantissa = half & 0x3ff;
+
+        uint32_t bits;
+        if (exponent == 0)
+        {
+            if (mantissa == 0)
+            {
+                bits = sign;
+            }
+            else
+            {
+                // normalize the subnormal half
+                exponent = 127 - 15 + 1;
+                while ((mantissa & 0x400) == 0)
+                {
+                    mantissa <<= 1;
+                    --exponent;
+                }
+                bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+            }
+        }
+        else if (exponent == 31)
+        {
+            bits = sign | 0x7f800000 | (mantissa << 13);
+        }
+        else
+        {
+            bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    float signNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+    vsg::vec2 octahedralEncode(const vsg::vec3& n)
+    {
+        float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        vsg::vec2 p(n.x / l1, n.y / l1);
+        if (n.z < 0.0f) p.set((1.0f - std::abs(p.y)) * signNotZero(p.x), (1.0f - std::abs(p.x)) * signNotZero(p.y));
+        return p;
+    }
+
+    vsg::vec3 octahedralDecode(const vsg::vec2& p)
+    {
+        vsg::vec3 n(p.x, p.y, 1.0f - std::abs(p.x) - std::abs(p.y));
+        if (n.z < 0.0f) n.set((1.0f - std::abs(p.y)) * signNotZero(p.x), (1.0f - std::abs(p.x)) * signNotZero(p.y), n.z);
+        return vsg::normalize(n);
+    }
+
+    // delta encode values against their predecessor, zigzag the signed delta and write it as a LEB128 varint,
+    // so runs of similar values, such as quantized attributes of neighbouring vertices, take one or two bytes each.
+    void encodeStream(std::vector<uint8_t>& out, const std::vector<int64_t>& values)
+    {
+        int64_t previous = 0;
+        for (auto value : values)
+        {
+            int64_t delta = value - previous;
+            previous = value;
+
+            uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+            while (zigzag >= 0x80)
+            {
+                out.push_back(static_cast<uint8_t>(zigzag | 0x80));
+                zigzag >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(zigzag));
+        }
+    }
+
+    bool decodeStream(const uint8_t* ptr, const uint8_t* end, std::vector<int64_t>& values)
+    {
+        int64_t previous = 0;
+        for (auto& value : values)
+        {
+            uint64_t zigzag = 0;
+            for (uint32_t shift = 0;; shift += 7)
+            {
+                if (ptr == end || shift > 63) return false;
+                uint8_t byte = *ptr++;
+                zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) break;
+            }
+
+            previous += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+            value = previous;
+        }
+        return ptr == end;
+    }
+
+    template<class A>
+    double maximumDifference(const vsg::Data& lhs, const vsg::Data& rhs)
+    {
+        auto a = lhs.cast<A>();
+        auto b = rhs.cast<A>();
+        if (!a || !b || a->size() != b->size()) return std::numeric_limits<double>::max();
+
+        double maxDifference = 0.0;
+        for (uint32_t i = 0; i < a->size(); ++i)
+        {
+            auto& va = a->at(i);
+            auto& vb = b->at(i);
+            for (size_t c = 0; c < va.size(); ++c) maxDifference = std::max(maxDifference, static_cast<double>(std::abs(va[c] - vb[c])));
+        }
+        return maxDifference;
+    }
+
+    /// collect the arrays used as vertex attributes and indices, and the codec suited to each.
+    class AttributeRoles : public vsg::ConstVisitor
+    {
+    public:
+        explicit AttributeRoles(uint32_t in_minimumArraySize) :
+            minimumArraySize(in_minimumArraySize) {}
+
+        uint32_t minimumArraySize;
+        std::map<const vsg::Object*, EncodedArray::Codec> roles;
+
+        bool suitable(const vsg::Data* data) const
+        {
+            return data && data->properties.dataVariance == vsg::STATIC_DATA && data->valueCount() >= minimumArraySize;
+        }
+
+        void assignArrays(const vsg::BufferInfoList& arrays)
+        {
+            bool positionsAssigned = false;
+            for (auto& bufferInfo : arrays)
+            {
+                auto data = bufferInfo ? bufferInfo->data.get() : nullptr;
+                if (!data) continue;
+
+                if (data->cast<vsg::vec3Array>())
+                {
+                    auto codec = positionsAssigned ? EncodedArray::OCTAHEDRAL_NORMALS : EncodedArray::QUANTIZED_POSITIONS;
+                    positionsAssigned = true;
+                    if (suitable(data)) roles.emplace(data, codec);
+                }
+                else if (data->cast<vsg::vec2Array>() && suitable(data))
+                {
+                    roles.emplace(data, EncodedArray::HALF_FLOAT_TEXCOORDS);
+                }
+            }
+        }
+
+        void assignIndices(const vsg::BufferInfo* indices)
+        {
+            auto data = indices ? indices->data.get() : nullptr;
+            if (suitable(data) && (data->cast<vsg::ushortArray>() || data->cast<vsg::uintArray>())) roles.emplace(data, EncodedArray::DELTA_INDICES);
+        }
+
+        void apply(const vsg::Object& object) override
+        {
+            object.traverse(*this);
+        }
+
+        void apply(const vsg::VertexIndexDraw& vid) override
+        {
+            assignArrays(vid.arrays);
+            assignIndices(vid.indices);
+        }
+
+        void apply(const vsg::Geometry& geometry) override
+        {
+            assignArrays(geometry.arrays);
+            assignIndices(geometry.indices);
+            geometry.traverse(*this);
+        }
+
+        void apply(const vsg::BindVertexBuffers& bvb) override
+        {
+            assignArrays(bvb.arrays);
+        }
+
+        void apply(const vsg::BindIndexBuffer& bib) override
+        {
+            assignIndices(bib.indices);
+        }
+    };
+
+    /// Output that writes an EncodedArray in place of each array assigned a role, sharing the encoding between all references to the array.
+    template<class OutputBase>
+    class CompressingOutput : public OutputBase
+    {
+    public:
+        CompressingOutput(std::ostream& output, vsg::ref_ptr<const vsg::Options> in_options, const CompressedVSG& in_compressedVSG, std::map<const vsg::Object*, EncodedArray::Codec>& in_roles) :
+            OutputBase(output, in_options),
+            compressedVSG(in_compressedVSG),
+            roles(in_roles)
+        {
+        }
+
+        const CompressedVSG& compressedVSG;
+        std::map<const vsg::Object*, EncodedArray::Codec>& roles;
+        std::map<const vsg::Object*, vsg::ref_ptr<EncodedArray>> encodedArrays;
+
+        using OutputBase::write;
+
+        void write(const vsg::Object* object) override
+        {
+            if (auto itr = roles.find(object); itr != roles.end())
+            {
+                auto& encodedArray = encodedArrays[object];
+                if (!encodedArray) encodedArray = compressedVSG.encode(*static_cast<const vsg::Data*>(object), itr->second);
+
+                if (encodedArray)
+                {
+                    OutputBase::write(encodedArray.get());
+                    return;
+                }
+
+                // data out of range of its codec, write it as is
+                roles.erase(itr);
+            }
+
+            OutputBase::write(object);
+        }
+    };
+
+    /// Input that replaces each EncodedArray read with its decoded Data.
+    template<class InputBase>
+    class DecodingInput : public InputBase
+    {
+    public:
+        DecodingInput(std::istream& input, vsg::ref_ptr<const vsg::Options> in_options, const CompressedVSG& in_compressedVSG) :
+            InputBase(input, vsg::ObjectFactory::instance(), in_options),
+            compressedVSG(in_compressedVSG)
+        {
+        }
+
+        const CompressedVSG& compressedVSG;
+
+        // later references to an EncodedArray return the same decoded Data
+        std::unordered_map<const vsg::Object*, vsg::ref_ptr<vsg::Data>> decoded;
+
+        using InputBase::read;
+
+        vsg::ref_ptr<vsg::Object> read() override
+        {
+            auto object = InputBase::read();
+            if (auto encodedArray = object.template cast<EncodedArray>())
+            {
+                auto& data = decoded[encodedArray.get()];
+                if (!data) data = compressedVSG.decode(*encodedArray);
+                return data;
+            }
+            return object;
+        }
+    };
+} // namespace
+
+vsg::ref_ptr<EncodedArray> EncodedArray::encode(const vsg::Data& data, Codec codec, uint32_t bits)
+{
+    auto encodedArray = EncodedArray::create();
+    encodedArray->codec = codec;
+    encodedArray->bits = bits;
+
+    std::vector<int64_t> values;
+
+    // component streams are laid out one after another so deltas are taken between the same component of neighbouring vertices
+    switch (codec)
+    {
+    case QUANTIZED_POSITIONS: {
+        auto positions = data.cast<vsg::vec3Array>();
+        if (!positions || bits < 2 || bits > 16) return {};
+
+        uint32_t numElements = positions->size();
+        vsg::vec3 minimum(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+        vsg::vec3 maximum(-minimum.x, -minimum.y, -minimum.z);
+        for (auto& v : *positions)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                if (!std::isfinite(v[c])) return {};
+                minimum[c] = std::min(minimum[c], v[c]);
+                maximum[c] = std::max(maximum[c], v[c]);
+            }
+        }
+
+        float levels = static_cast<float>((1u << bits) - 1);
+        encodedArray->offset = minimum;
+        for (int c = 0; c < 3; ++c) encodedArray->scale[c] = (maximum[c] - minimum[c]) / levels;
+
+        values.resize(numElements * 3);
+        for (uint32_t i = 0; i < numElements; ++i)
+        {
+            auto& v = positions->at(i);
+            for (int c = 0; c < 3; ++c)
+            {
+                float scale = encodedArray->scale[c];
+                float q = scale > 0.0f ? std::round((v[c] - minimum[c]) / scale) : 0.0f;
+                values[c * numElements + i] = static_cast<int64_t>(std::clamp(q, 0.0f, levels));
+            }
+        }
+        encodedArray->numElements = numElements;
+        break;
+    }
+    case OCTAHEDRAL_NORMALS: {
+        auto normals = data.cast<vsg::vec3Array>();
+        if (!normals || bits < 2 || bits > 16) return {};
+
+        uint32_t numElements = normals->size();
+        float maxValue = static_cast<float>((1u << (bits - 1)) - 1);
+
+        values.resize(numElements * 2);
+        for (uint32_t i = 0; i < numElements; ++i)
+        {
+            auto& n = normals->at(i);
+            if (!std::isfinite(n.x) || !std::isfinite(n.y) || !std::isfinite(n.z) || std::abs(vsg::length(n) - 1.0f) > 1e-3f) return {};
+
+            auto p = octahedralEncode(n);
+            values[i] = static_cast<int64_t>(std::round(std::clamp(p.x, -1.0f, 1.0f) * maxValue));
+            values[numElements + i] = static_cast<int64_t>(std::round(std::clamp(p.y, -1.0f, 1.0f) * maxValue));
+        }
+        encodedArray->numElements = numElements;
+        break;
+    }
+    case HALF_FLOAT_TEXCOORDS: {
+        auto texcoords = data.cast<vsg::vec2Array>();
+        if (!texcoords) return {};
+
+        uint32_t numElements = texcoords->size();
+        values.resize(numElements * 2);
+        for (uint32_t i = 0; i < numElements; ++i)
+        {
+            auto& tc = texcoords->at(i);
+            for (int c = 0; c < 2; ++c)
+            {
+                if (!std::isfinite(tc[c]) || std::abs(tc[c]) > 65504.0f) return {};
+                values[c * numElements + i] = floatToHalf(tc[c]);
+            }
+        }
+        encodedArray->bits = 16;
+        encodedArray->numElements = numElements;
+        break;
+    }
+    case DELTA_INDICES: {
+        if (auto ushortIndices = data.cast<vsg::ushortArray>())
+        {
+            for (auto index : *ushortIndices) values.push_back(index);
+            encodedArray->bits = 16;
+        }
+        else if (auto uintIndices = data.cast<vsg::uintArray>())
+        {
+            for (auto index : *uintIndices) values.push_back(index);
+            encodedArray->bits = 32;
+        }
+        else
+        {
+            return {};
+        }
+        encodedArray->numElements = static_cast<uint32_t>(values.size());
+        break;
+    }
+    default:
+        return {};
+    }
+
+    std::vector<uint8_t> stream;
+    stream.reserve(values.size() * 2);
+    encodeStream(stream, values);
+
+    encodedArray->encoded = vsg::ubyteArray::create(static_cast<uint32_t>(stream.size()));
+    if (!stream.empty()) std::memcpy(encodedArray->encoded->dataPointer(), stream.data(), stream.size());
+
+    // carry the original's properties and user objects so they can be restored on decode
+    encodedArray->properties = data.properties;
+    if (auto auxiliary = data.getAuxiliary())
+    {
+        for (auto& [key, object] : auxiliary->userObjects) encodedArray->setObject(key, object);
+    }
+
+    return encodedArray;
+}
+
+vsg::ref_ptr<vsg::Data> EncodedArray::decode(bool quantized) const
+{
+    auto data = decodeValues(quantized);
+    if (!data) return data;
+
+    // the quantized forms have their own layout, so only restore the original format and stride when decoding to the original type
+    auto decodedProperties = data->properties;
+    data->properties = properties;
+    data->properties.allocatorType = decodedProperties.allocatorType;
+    if (quantized && codec != DELTA_INDICES)
+    {
+        data->properties.format = decodedProperties.format;
+        data->properties.stride = decodedProperties.stride;
+    }
+
+    // user objects assigned by the decoding, such as the quantization values, take precedence over the original's
+    if (auto auxiliary = getAuxiliary())
+    {
+        for (auto& [key, object] : auxiliary->userObjects)
+        {
+            if (!data->getObject(key)) data->setObject(key, object);
+        }
+    }
+
+    return data;
+}
+
+vsg::ref_ptr<vsg::Data> EncodedArray::decodeValues(bool quantized) const
+{
+    static const uint32_t s_numComponents[CODEC_COUNT] = {3, 2, 2, 1};
+    if (codec >= CODEC_COUNT || !encoded) return {};
+
+    std::vector<int64_t> values(static_cast<size_t>(numElements) * s_numComponents[codec]);
+    auto begin = static_cast<const uint8_t*>(encoded->dataPointer());
+    if (!decodeStream(begin, begin + encoded->dataSize(), values))
+    {
+        vsg::warn("EncodedArray::decode() corrupt stream for ", numElements, " elements.");
+        return {};
+    }
+
+    auto value = [&](uint32_t c, uint32_t i) { return values[static_cast<size_t>(c) * numElements + i]; };
+
+    switch (codec)
+    {
+    case QUANTIZED_POSITIONS: {
+        if (quantized)
+        {
+            // dequantized in the vertex shader using the quantizationOffset and quantizationScale values
+            auto positions = vsg::usvec4Array::create(numElements);
+            positions->properties.format = VK_FORMAT_R16G16B16A16_UINT;
+            for (uint32_t i = 0; i < numElements; ++i)
+            {
+                positions->set(i, vsg::usvec4(static_cast<uint16_t>(value(0, i)), static_cast<uint16_t>(value(1, i)), static_cast<uint16_t>(value(2, i)), 1));
+            }
+            positions->setValue("quantizationOffset", offset);
+            positions->setValue("quantizationScale", scale);
+            return positions;
+        }
+
+        auto positions = vsg::vec3Array::create(numElements);
+        for (uint32_t i = 0; i < numElements; ++i)
+        {
+            positions->set(i, vsg::vec3(offset.x + static_cast<float>(value(0, i)) * scale.x,
+                                        offset.y + static_cast<float>(value(1, i)) * scale.y,
+                                        offset.z + static_cast<float>(value(2, i)) * scale.z));
+        }
+        return positions;
+    }
+    case OCTAHEDRAL_NORMALS: {
+        float maxValue = static_cast<float>((1u << (bits - 1)) - 1);
+        if (quantized)
+        {
+            // octahedral decoding is left to the vertex shader
+            auto normals = vsg::svec2Array::create(numElements);
+            normals->properties.format = VK_FORMAT_R16G16_SNORM;
+            for (uint32_t i = 0; i < numElements; ++i)
+            {
+                auto x = std::round(static_cast<float>(value(0, i)) / maxValue * 32767.0f);
+                auto y = std::round(static_cast<float>(value(1, i)) / maxValue * 32767.0f);
+                normals->set(i, vsg::svec2(static_cast<int16_t>(x), static_cast<int16_t>(y)));
+            }
+            return normals;
+        }
+
+        auto normals = vsg::vec3Array::create(numElements);
+        for (uint32_t i = 0; i < numElements; ++i)
+        {
+            normals->set(i, octahedralDecode(vsg::vec2(static_cast<float>(value(0, i)) / maxValue, static_cast<float>(value(1, i)) / maxValue)));
+        }
+        return normals;
+    }
+    case HALF_FLOAT_TEXCOORDS: {
+        if (quantized)
+        {
+            auto texcoords = vsg::usvec2Array::create(numElements);
+            texcoords->properties.format = VK_FORMAT_R16G16_SFLOAT;
+            for (uint32_t i = 0; i < numElements; ++i)
+            {
+                texcoords->set(i, vsg::usvec2(static_cast<uint16_t>(value(0, i)), static_cast<uint16_t>(value(1, i))));
+            }
+            return texcoords;
+        }
+
+        auto texcoords = vsg::vec2Array::create(numElements);
+        for (uint32_t i = 0; i < numElements; ++i)
+        {
+            texcoords->set(i, vsg::vec2(halfToFloat(static_cast<uint16_t>(value(0, i))), halfToFloat(static_cast<uint16_t>(value(1, i)))));
+        }
+        return texcoords;
+    }
+    case DELTA_INDICES: {
+        if (bits == 16)
+        {
+            auto indices = vsg::ushortArray::create(numElements);
+            for (uint32_t i = 0; i < numElements; ++i) indices->set(i, static_cast<uint16_t>(values[i]));
+            return indices;
+        }
+
+        auto indices = vsg::uintArray::create(numElements);
+        for (uint32_t i = 0; i < numElements; ++i) indices->set(i, static_cast<uint32_t>(values[i]));
+        return indices;
+    }
+    default:
+        return {};
+    }
+}
+
+void EncodedArray::read(vsg::Input& input)
+{
+    vsg::Object::read(input);
+
+    input.readValue<uint32_t>("codec", codec);
+    input.read("numElements", numElements);
+    input.read("bits", bits);
+    input.read("offset", offset);
+    input.read("scale", scale);
+    input.readValue<uint32_t>("format", properties.format);
+    input.read("stride", properties.stride);
+    input.read("maxNumMipmaps", properties.maxNumMipmaps);
+    input.read("blockWidth", properties.blockWidth);
+    input.read("blockHeight", properties.blockHeight);
+    input.read("blockDepth", properties.blockDepth);
+    input.read("origin", properties.origin);
+    input.read("imageViewType", properties.imageViewType);
+    input.readValue<uint32_t>("dataVariance", properties.dataVariance);
+    input.read("encoded", encoded);
+}
+
+void EncodedArray::write(vsg::Output& output) const
+{
+    vsg::Object::write(output);
+
+    output.writeValue<uint32_t>("codec", codec);
+    output.write("numElements", numElements);
+    output.write("bits", bits);
+    output.write("offset", offset);
+    output.write("scale", scale);
+    output.writeValue<uint32_t>("format", properties.format);
+    output.write("stride", properties.stride);
+    output.write("maxNumMipmaps", properties.maxNumMipmaps);
+    output.write("blockWidth", properties.blockWidth);
+    output.write("blockHeight", properties.blockHeight);
+    output.write("blockDepth", properties.blockDepth);
+    output.write("origin", properties.origin);
+    output.write("imageViewType", properties.imageViewType);
+    output.writeValue<uint32_t>("dataVariance", properties.dataVariance);
+    output.write("encoded", encoded);
+}
+
+vsg::ref_ptr<EncodedArray> CompressedVSG::encode(const vsg::Data& data, EncodedArray::Codec codec) const
+{
+    uint32_t bits = 16;
+    if (codec == EncodedArray::QUANTIZED_POSITIONS) bits = positionBits;
+    else if (codec == EncodedArray::OCTAHEDRAL_NORMALS) bits = normalBits;
+
+    auto start = std::chrono::steady_clock::now();
+    auto encodedArray = EncodedArray::encode(data, codec, bits);
+    auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!encodedArray) return {};
+
+    double error = 0.0;
+    if (verify)
+    {
+        auto decoded = encodedArray->decode();
+        if (!decoded) error = std::numeric_limits<double>::max();
+        else if (codec == EncodedArray::HALF_FLOAT_TEXCOORDS) error = maximumDifference<vsg::vec2Array>(data, *decoded);
+        else if (codec == EncodedArray::DELTA_INDICES) error = (data.compare(*decoded) == 0) ? 0.0 : 1.0;
+        else error = maximumDifference<vsg::vec3Array>(data, *decoded);
+    }
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    auto& stats = codecStats[codec];
+    ++stats.numArrays;
+    stats.originalBytes += data.dataSize();
+    stats.encodedBytes += encodedArray->encoded->dataSize();
+    stats.maxError = std::max(stats.maxError, error);
+    encodeTime += duration;
+
+    return encodedArray;
+}
+
+vsg::ref_ptr<vsg::Data> CompressedVSG::decode(const EncodedArray& encodedArray) const
+{
+    auto start = std::chrono::steady_clock::now();
+    auto data = encodedArray.decode(keepQuantized);
+    auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    ++numArraysDecoded;
+    if (data) numBytesDecoded += data->dataSize();
+    decodeTime += duration;
+
+    return data;
+}
+
+void CompressedVSG::clearStats()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    for (auto& stats : codecStats) stats = {};
+    encodeTime = 0.0;
+    numArraysDecoded = 0;
+    numBytesDecoded = 0;
+    decodeTime = 0.0;
+}
+
+void CompressedVSG::report(std::ostream& out) const
+{
+    static const char* s_codecNames[EncodedArray::CODEC_COUNT] = {"positions", "normals", "texcoords", "indices"};
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    out << "CompressedVSG::report() " << this << std::endl;
+
+    size_t originalBytes = 0;
+    size_t encodedBytes = 0;
+    for (uint32_t codec = 0; codec < EncodedArray::CODEC_COUNT; ++codec)
+    {
+        auto& stats = codecStats[codec];
+        originalBytes += stats.originalBytes;
+        encodedBytes += stats.encodedBytes;
+
+        out << "    " << s_codecNames[codec] << " : " << stats.numArrays << " arrays, " << stats.originalBytes << " -> " << stats.encodedBytes << " bytes";
+        if (stats.encodedBytes > 0) out << ", ratio " << static_cast<double>(stats.originalBytes) / static_cast<double>(stats.encodedBytes);
+        if (verify && stats.numArrays > 0) out << ", max error " << stats.maxError;
+        out << std::endl;
+    }
+
+    out << "    encoded " << originalBytes << " -> " << encodedBytes << " bytes in " << encodeTime * 1000.0 << "ms" << std::endl;
+    out << "    decoded " << numArraysDecoded << " arrays, " << numBytesDecoded << " bytes in " << decodeTime * 1000.0 << "ms";
+    if (decodeTime > 0.0) out << ", " << static_cast<double>(numBytesDecoded) / (decodeTime * 1024.0 * 1024.0) << " MB/s";
+    out << std::endl;
+}
+
+bool CompressedVSG::getFeatures(Features& features) const
+{
+    features.extensionFeatureMap[".vsgz"] = static_cast<FeatureMask>(READ_FILENAME | READ_ISTREAM | WRITE_FILENAME);
+    return true;
+}
+
+vsg::ref_ptr<vsg::Object> CompressedVSG::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgz") return {};
+
+    auto filenameToUse = vsg::findFile(filename, options);
+    if (!filenameToUse) return {};
+
+    std::ifstream fin(filenameToUse, std::ios::in | std::ios::binary);
+    if (!fin) return {};
+
+    return read(fin, options);
+}
+
+vsg::ref_ptr<vsg::Object> CompressedVSG::read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options) const
+{
+    // leave streams hinted as another format, such as .vsgb, to their own ReaderWriter
+    if (options && options->extensionHint && vsg::lowerCaseFileExtension(options->extensionHint) != ".vsgz") return {};
+
+    auto [type, version] = readHeader(fin);
+    if (type == BINARY)
+    {
+        DecodingInput<vsg::BinaryInput> input(fin, options, *this);
+        input.version = version;
+        return input.readObject<vsg::Object>("Root");
+    }
+    else if (type == ASCII)
+    {
+        DecodingInput<vsg::AsciiInput> input(fin, options, *this);
+        input.version = version;
+        return input.readObject<vsg::Object>("Root");
+    }
+
+    return {};
+}
+
+bool CompressedVSG::write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgz" || !object) return false;
+
+    AttributeRoles attributeRoles(minimumArraySize);
+    object->accept(attributeRoles);
+
+    std::ofstream fout(filename, std::ios::out | std::ios::binary);
+    if (!fout) return false;
+
+    auto version = vsg::vsgGetVersion();
+    writeHeader(fout, FormatInfo(BINARY, version));
+
+    CompressingOutput<vsg::BinaryOutput> output(fout, options, *this, attributeRoles.roles);
+    output.version = version;
+    output.writeObject("Root", object);
+    return !fout.fail();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <mutex>
+
+namespace compress
+{
+
+    /// Compressed form of a vertex or index array, written to native files in place of the original Data.
+    /// Positions are quantized relative to their bounds, normals octahedral encoded, texcoords stored as half floats,
+    /// with each component stream then delta and varint encoded in the style of meshoptimizer's vertex and index codecs.
+    /// The original array's properties and user objects are carried by the EncodedArray and restored on the decoded array.
+    class EncodedArray : public vsg::Inherit<vsg::Object, EncodedArray>
+    {
+    public:
+        enum Codec : uint32_t
+        {
+            QUANTIZED_POSITIONS,
+            OCTAHEDRAL_NORMALS,
+            HALF_FLOAT_TEXCOORDS,
+            DELTA_INDICES,
+            CODEC_COUNT
+        };
+
+        Codec codec = QUANTIZED_POSITIONS;
+        uint32_t numElements = 0;
+        uint32_t bits = 16; // bits per quantized component, or bits per index for DELTA_INDICES
+        vsg::vec3 offset;   // QUANTIZED_POSITIONS dequantization, position = offset + quantized * scale
+        vsg::vec3 scale;
+        vsg::Data::Properties properties; // properties of the original array
+        vsg::ref_ptr<vsg::ubyteArray> encoded;
+
+        /// encode data with the specified codec, returning null if the data isn't a type the codec supports or is out of range.
+        static vsg::ref_ptr<EncodedArray> encode(const vsg::Data& data, Codec codec, uint32_t bits = 16);
+
+        /// decode back to float arrays, or when quantized is true to arrays in the quantized form for use directly as GPU vertex attributes:
+        /// usvec4Array positions with quantizationOffset/quantizationScale values, SNORM svec2Array octahedral normals and SFLOAT usvec2Array texcoords.
+        vsg::ref_ptr<vsg::Data> decode(bool quantized = false) const;
+
+        void read(vsg::Input& input) override;
+        void write(vsg::Output& output) const override;
+
+    protected:
+        vsg::ref_ptr<vsg::Data> decodeValues(bool quantized) const;
+    };
+
+    /// ReaderWriter for .vsgz files, the native binary format with vertex attributes and indices compressed on write and decoded on read.
+    /// A distinct extension is used so that .vsgb and .vsgt files are left to vsg::VSG, and compressed files aren't mistaken for them.
+    /// The role of each array is taken from its place in VertexIndexDraw, Geometry, BindVertexBuffers and BindIndexBuffer:
+    /// the first vec3Array is treated as positions, later unit length vec3Arrays as normals and vec2Arrays as texcoords.
+    class CompressedVSG : public vsg::Inherit<vsg::VSG, CompressedVSG>
+    {
+    public:
+        uint32_t positionBits = 16;
+        uint32_t normalBits = 16;
+
+        /// arrays smaller than this, and dynamic arrays, are written uncompressed.
+        uint32_t minimumArraySize = 32;
+
+        /// keep decoded attributes in their quantized form rather than converting back to float.
+        bool keepQuantized = false;
+
+        /// decode each array after encoding to record the maximum error per codec.
+        bool verify = false;
+
+        struct CodecStats
+        {
+            size_t numArrays = 0;
+            size_t originalBytes = 0;
+            size_t encodedBytes = 0;
+            double maxError = 0.0;
+        };
+
+        // statistics, updated by the const read and write methods
+        mutable CodecStats codecStats[EncodedArray::CODEC_COUNT];
+        mutable double encodeTime = 0.0;
+        mutable size_t numArraysDecoded = 0;
+        mutable size_t numBytesDecoded = 0;
+        mutable double decodeTime = 0.0;
+
+        /// encode or decode an array, accumulating statistics.
+        vsg::ref_ptr<EncodedArray> encode(const vsg::Data& data, EncodedArray::Codec codec) const;
+        vsg::ref_ptr<vsg::Data> decode(const EncodedArray& encodedArray) const;
+
+        void clearStats();
+        void report(std::ostream& out) const;
+
+        using vsg::VSG::read;
+        vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+        vsg::ref_ptr<vsg::Object> read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+        using vsg::VSG::write;
+        bool write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+        bool getFeatures(Features& features) const override;
+
+    protected:
+        mutable std::mutex _mutex;
+    };
+
+} // namespace compress
+
+EVSG_type_name(compress::EncodedArray);
+EVSG_type_name(compress::CompressedVSG);
@@ -0,0 +1,97 @@
+#include <vsg/all.h>
+
+#ifdef vsgXchange_FOUND
+#    include <vsgXchange/all.h>
+#endif
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include "AttributeCompression.h"
+
+size_t fileSize(const vsg::Path& filename)
+{
+    std::ifstream fin(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    return fin ? static_cast<size_t>(fin.tellg()) : 0;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto compressedVSG = compress::CompressedVSG::create();
+    arguments.read("--position-bits", compressedVSG->positionBits);
+    arguments.read("--normal-bits", compressedVSG->normalBits);
+    arguments.read("--minimum-size", compressedVSG->minimumArraySize);
+    compressedVSG->keepQuantized = arguments.read("--quantized");
+    compressedVSG->verify = !arguments.read("--no-verify");
+
+    auto iterations = arguments.value(10, "--iterations");
+    auto outputDirectory = arguments.value<vsg::Path>(".", "-o");
+
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+
+#ifdef vsgXchange_all
+    options->add(vsgXchange::all::create());
+#endif
+
+    // .vsgz files can also be read with vsg::read(), the CompressedVSG leaves .vsgb and .vsgt files to vsg::VSG
+    options->add(compressedVSG);
+
+    options->readOptions(arguments);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    vsg::Paths filenames;
+    for (int i = 1; i < argc; ++i) filenames.push_back(arguments[i]);
+    if (filenames.empty()) filenames = {"models/teapot.vsgt", "models/lz.vsgt", "models/openstreetmap_flat_shaded.vsgt", "models/readymap_flat_shaded.vsgt"};
+
+    auto standardVSG = vsg::VSG::create();
+
+    using clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](clock::time_point start) { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
+
+    for (auto& filename : filenames)
+    {
+        auto object = vsg::read(filename, options);
+        if (!object)
+        {
+            std::cout << "Unable to load file " << filename << std::endl;
+            continue;
+        }
+
+        auto stem = vsg::simpleFilename(filename);
+        auto standardFilename = outputDirectory / vsg::make_string(stem, ".vsgb");
+        auto compressedFilename = outputDirectory / vsg::make_string(stem, ".vsgz");
+
+        compressedVSG->clearStats();
+        if (!standardVSG->write(object, standardFilename, options) || !compressedVSG->write(object, compressedFilename, options))
+        {
+            std::cout << "Unable to write " << standardFilename << " or " << compressedFilename << std::endl;
+            continue;
+        }
+
+        auto start = clock::now();
+        for (int i = 0; i < iterations; ++i) standardVSG->read(standardFilename, options);
+        auto standardReadTime = milliseconds(start) / static_cast<double>(iterations);
+
+        start = clock::now();
+        for (int i = 0; i < iterations; ++i) compressedVSG->read(compressedFilename, options);
+        auto compressedReadTime = milliseconds(start) / static_cast<double>(iterations);
+
+        auto standardSize = fileSize(standardFilename);
+        auto compressedSize = fileSize(compressedFilename);
+
+        std::cout << "\n" << filename << std::endl;
+        std::cout << "    standard .vsgb   : " << standardSize << " bytes, read " << standardReadTime << "ms" << std::endl;
+        std::cout << "    compressed .vsgz : " << compressedSize << " bytes, read " << compressedReadTime << "ms";
+        if (compressedSize > 0) std::cout << ", size ratio " << static_cast<double>(standardSize) / static_cast<double>(compressedSize);
+        std::cout << std::endl;
+
+        compressedVSG->report(std::cout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,343 @@
+#include "ContentDeduplicator.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <typeinfo>
+
+using namespace dedup;
+
+namespace
+{
+    constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t rotl(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+    inline uint64_t hashRound(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME64_2;
+        acc = rotl(acc, 31);
+        return acc * PRIME64_1;
+    }
+
+    inline uint64_t mergeRound(uint64_t acc, uint64_t lane)
+    {
+        acc ^= hashRound(0, lane);
+        return acc * PRIME64_1 + PRIME64_4;
+    }
+
+    inline uint64_t read64(const uint8_t* ptr)
+    {
+        uint64_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    // std::streambuf that feeds everything written to it into a ContentHash
+    class HashStreamBuffer : public std::streambuf
+    {
+    public:
+        ContentHash contentHash;
+        size_t numBytes = 0;
+
+    protected:
+        std::streamsize xsputn(const char* ptr, std::streamsize count) override
+        {
+            contentHash.update(ptr, static_cast<size_t>(count));
+            numBytes += static_cast<size_t>(count);
+            return count;
+        }
+
+        int_type overflow(int_type ch) override
+        {
+            if (ch != traits_type::eof())
+            {
+                char c = traits_type::to_char_type(ch);
+                xsputn(&c, 1);
+            }
+            return traits_type::not_eof(ch);
+        }
+    };
+
+    // BinaryOutput that serializes an object's own members, writing the addresses of the objects it references rather than the objects themselves
+    class HashOutput : public vsg::BinaryOutput
+    {
+    public:
+        HashOutput(std::ostream& output, const vsg::Object* in_root) :
+            vsg::BinaryOutput(output, {}),
+            root(in_root)
+        {
+            version = vsg::vsgGetVersion();
+        }
+
+        const vsg::Object* root = nullptr;
+
+        using vsg::BinaryOutput::write;
+
+        void write(const vsg::Object* object) override
+        {
+            if (object == root)
+            {
+                vsg::BinaryOutput::write(object);
+                return;
+            }
+
+            auto address = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(object));
+            _output.write(reinterpret_cast<const char*>(&address), sizeof(address));
+        }
+    };
+
+    // Input that passes each newly read object to the ContentDeduplicator, substituting any previously loaded identical object
+    template<class InputBase>
+    class DeduplicatingInput : public InputBase
+    {
+    public:
+        DeduplicatingInput(std::istream& input, vsg::ref_ptr<const vsg::Options> in_options, ContentDeduplicator& in_deduplicator) :
+            InputBase(input, vsg::ObjectFactory::instance(), in_options),
+            deduplicator(in_deduplicator)
+        {
+        }
+
+        ContentDeduplicator& deduplicator;
+
+        // the objects read are kept alive by Input::objectIDMap so their addresses remain unique for the duration of the read
+        std::unordered_map<const vsg::Object*, vsg::ref_ptr<vsg::Object>> replacements;
+        std::set<const vsg::Object*> visited;
+
+        using InputBase::read;
+
+        vsg::ref_ptr<vsg::Object> read() override
+        {
+            auto object = InputBase::read();
+            if (!object) return object;
+
+            // later references to an object that was replaced return the replacement
+            if (auto itr = replacements.find(object.get()); itr != replacements.end()) return itr->second;
+            if (!visited.insert(object.get()).second) return object;
+
+            auto shared = deduplicator.deduplicate(object);
+            if (shared != object) replacements[object.get()] = shared;
+            return shared;
+        }
+    };
+} // namespace
+
+ContentHash::ContentHash()
+{
+    _lanes[0] = PRIME64_1 + PRIME64_2;
+    _lanes[1] = PRIME64_2;
+    _lanes[2] = 0;
+    _lanes[3] = 0 - PRIME64_1;
+}
+
+void ContentHash::stripe(const uint8_t* ptr)
+{
+    _lanes[0] = hashRound(_lanes[0], read64(ptr));
+    _lanes[1] = hashRound(_lanes[1], read64(ptr + 8));
+    _lanes[2] = hashRound(_lanes[2], read64(ptr + 16));
+    _lanes[3] = hashRound(_lanes[3], read64(ptr + 24));
+}
+
+void ContentHash::update(const void* data, size_t size)
+{
+    auto ptr = static_cast<const uint8_t*>(data);
+    _totalSize += size;
+
+    // complete any partial stripe left from the previous update
+    if (_bufferSize > 0)
+    {
+        size_t count = std::min(size, sizeof(_buffer) - _bufferSize);
+        std::memcpy(_buffer + _bufferSize, ptr, count);
+        _bufferSize += count;
+        ptr += count;
+        size -= count;
+
+        if (_bufferSize < sizeof(_buffer)) return;
+
+        stripe(_buffer);
+        _bufferSize = 0;
+    }
+
+    for (; size >= 32; ptr += 32, size -= 32) stripe(ptr);
+
+    std::memcpy(_buffer, ptr, size);
+    _bufferSize = size;
+}
+
+uint64_t ContentHash::digest() const
+{
+    uint64_t h = rotl(_lanes[0], 1) + rotl(_lanes[1], 7) + rotl(_lanes[2], 12) + rotl(_lanes[3], 18);
+    for (auto lane : _lanes) h = mergeRound(h, lane);
+
+    h += _totalSize;
+
+    const uint8_t* ptr = _buffer;
+    size_t size = _bufferSize;
+    for (; size >= 8; ptr += 8, size -= 8) h = rotl(h ^ hashRound(0, read64(ptr)), 27) * PRIME64_1 + PRIME64_4;
+    for (; size > 0; ++ptr, --size) h = rotl(h ^ (*ptr * PRIME64_5), 11) * PRIME64_1;
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool ContentDeduplicator::suitable(const vsg::Object& object) const
+{
+    if (auto data = object.cast<vsg::Data>())
+    {
+        // dynamic data is updated per instance so mustn't be shared
+        return data->properties.dataVariance == vsg::STATIC_DATA && data->dataPointer() != nullptr;
+    }
+
+    return object.cast<vsg::StateCommand>() || object.cast<vsg::Descriptor>() || object.cast<vsg::DescriptorSet>() ||
+           object.cast<vsg::DescriptorSetLayout>() || object.cast<vsg::PipelineLayout>() || object.cast<vsg::ShaderStage>() ||
+           object.cast<vsg::ShaderModule>() || object.cast<vsg::Sampler>() || object.cast<vsg::GraphicsPipelineState>();
+}
+
+uint64_t ContentDeduplicator::hash(const vsg::Object& object, size_t* numBytes) const
+{
+    if (auto data = object.cast<vsg::Data>())
+    {
+        // hash the payload directly rather than through the serializer
+        ContentHash contentHash;
+        std::string className = data->className();
+        uint32_t dimensions[3] = {data->width(), data->height(), data->depth()};
+        contentHash.update(className.data(), className.size());
+        contentHash.update(dimensions, sizeof(dimensions));
+        contentHash.update(&data->properties.format, sizeof(data->properties.format));
+        contentHash.update(data->dataPointer(), data->dataSize());
+        if (numBytes) *numBytes += data->dataSize();
+        return contentHash.digest();
+    }
+
+    HashStreamBuffer hashStreamBuffer;
+    std::ostream hashStream(&hashStreamBuffer);
+
+    HashOutput output(hashStream, &object);
+    output.writeObject("Root", &object);
+
+    if (numBytes) *numBytes += hashStreamBuffer.numBytes;
+    return hashStreamBuffer.contentHash.digest();
+}
+
+vsg::ref_ptr<vsg::Object> ContentDeduplicator::deduplicate(vsg::ref_ptr<vsg::Object> object)
+{
+    if (!object || !suitable(*object)) return object;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t numBytes = 0;
+    auto contentHash = hash(*object, &numBytes);
+    auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    ++numObjectsHashed;
+    numBytesHashed += numBytes;
+    hashTime += duration;
+
+    auto [itr, end] = _objects.equal_range(contentHash);
+    while (itr != end)
+    {
+        vsg::ref_ptr<vsg::Object> candidate = itr->second;
+        if (!candidate)
+        {
+            // the object has been deleted since it was loaded
+            itr = _objects.erase(itr);
+            continue;
+        }
+
+        if (typeid(*candidate) == typeid(*object) && candidate->compare(*object) == 0)
+        {
+            ++numDuplicates;
+            if (auto data = object->cast<vsg::Data>())
+            {
+                ++numDataDuplicates;
+                numBytesSaved += data->dataSize();
+            }
+            return candidate;
+        }
+        ++itr;
+    }
+
+    _objects.emplace(contentHash, object);
+    return object;
+}
+
+size_t ContentDeduplicator::prune()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    size_t previousSize = _objects.size();
+    for (auto itr = _objects.begin(); itr != _objects.end();)
+    {
+        if (itr->second.valid())
+            ++itr;
+        else
+            itr = _objects.erase(itr);
+    }
+    return previousSize - _objects.size();
+}
+
+void ContentDeduplicator::clear()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _objects.clear();
+}
+
+void ContentDeduplicator::report(std::ostream& out) const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    out << "ContentDeduplicator::report() " << this << std::endl;
+    out << "    unique objects = " << _objects.size() << std::endl;
+    out << "    objects hashed = " << numObjectsHashed << ", bytes hashed = " << numBytesHashed << ", hash time = " << hashTime * 1000.0 << "ms";
+    if (hashTime > 0.0) out << ", " << static_cast<double>(numBytesHashed) / (hashTime * 1024.0 * 1024.0) << " MB/s";
+    out << std::endl;
+    out << "    duplicates replaced = " << numDuplicates << ", of which Data = " << numDataDuplicates << ", Data bytes saved = " << numBytesSaved << std::endl;
+}
+
+DeduplicatingVSG::DeduplicatingVSG() :
+    deduplicator(ContentDeduplicator::create())
+{
+}
+
+vsg::ref_ptr<vsg::Object> DeduplicatingVSG::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    auto ext = vsg::lowerCaseFileExtension(filename);
+    if (ext != ".vsgb" && ext != ".vsgt") return {};
+
+    auto filenameToUse = vsg::findFile(filename, options);
+    if (!filenameToUse) return {};
+
+    std::ifstream fin(filenameToUse, std::ios::in | std::ios::binary);
+    if (!fin) return {};
+
+    return read(fin, options);
+}
+
+vsg::ref_ptr<vsg::Object> DeduplicatingVSG::read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options) const
+{
+    auto [type, version] = readHeader(fin);
+    if (type == BINARY)
+    {
+        DeduplicatingInput<vsg::BinaryInput> input(fin, options, *deduplicator);
+        input.version = version;
+        return input.readObject<vsg::Object>("Root");
+    }
+    else if (type == ASCII)
+    {
+        DeduplicatingInput<vsg::AsciiInput> input(fin, options, *deduplicator);
+        input.version = version;
+        return input.readObject<vsg::Object>("Root");
+    }
+
+    return {};
+}
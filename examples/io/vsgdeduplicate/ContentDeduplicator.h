@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace dedup
+{
+
+    /// Streaming 64 bit hash, processing 32 byte stripes across four lanes in the style of xxHash64.
+    class ContentHash
+    {
+    public:
+        ContentHash();
+
+        void update(const void* ptr, size_t size);
+        uint64_t digest() const;
+
+    protected:
+        void stripe(const uint8_t* ptr);
+
+        uint64_t _lanes[4];
+        uint8_t _buffer[32];
+        size_t _bufferSize = 0;
+        uint64_t _totalSize = 0;
+    };
+
+    /// Cache of loaded objects keyed by a hash of their contents, used to replace objects that are identical to ones already loaded.
+    /// Data is hashed over its properties and payload, state objects over their serialized form, with the objects they reference hashed
+    /// by address. Objects are read depth first so references have already been deduplicated, so identical state referencing identical
+    /// Data hashes the same. Candidates that match on hash are confirmed with Object::compare() before being replaced.
+    /// The cache only observes the objects, so they are released once the scene graphs using them are, and their entries are removed
+    /// when next looked up or by prune().
+    class ContentDeduplicator : public vsg::Inherit<vsg::Object, ContentDeduplicator>
+    {
+    public:
+        /// return the previously loaded object identical to object, or object itself if it's the first of its kind or can't be shared.
+        vsg::ref_ptr<vsg::Object> deduplicate(vsg::ref_ptr<vsg::Object> object);
+
+        /// return true if object is a type that is shared when identical.
+        virtual bool suitable(const vsg::Object& object) const;
+
+        /// compute the content hash of an object, adding the number of bytes hashed to numBytes if assigned.
+        uint64_t hash(const vsg::Object& object, size_t* numBytes = nullptr) const;
+
+        /// remove the entries of objects that have since been deleted, returning the number removed.
+        size_t prune();
+
+        void clear();
+        void report(std::ostream& out) const;
+
+        // statistics
+        size_t numObjectsHashed = 0;
+        size_t numBytesHashed = 0;
+        size_t numDuplicates = 0;
+        size_t numDataDuplicates = 0;
+        size_t numBytesSaved = 0;
+        double hashTime = 0.0;
+
+    protected:
+        mutable std::mutex _mutex;
+        std::unordered_multimap<uint64_t, vsg::observer_ptr<vsg::Object>> _objects;
+    };
+
+    /// Native format ReaderWriter that deduplicates objects as they are read from .vsgb and .vsgt files.
+    class DeduplicatingVSG : public vsg::Inherit<vsg::VSG, DeduplicatingVSG>
+    {
+    public:
+        DeduplicatingVSG();
+
+        vsg::ref_ptr<ContentDeduplicator> deduplicator;
+
+        using vsg::VSG::read;
+        vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+        vsg::ref_ptr<vsg::Object> read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+    };
+
+} // namespace dedup
+
+EVSG_type_name(dedup::ContentDeduplicator);
+EVSG_type_name(dedup::DeduplicatingVSG);
@@ -0,0 +1,92 @@
+#include <vsg/all.h>
+
+#ifdef vsgXchange_FOUND
+#    include <vsgXchange/all.h>
+#endif
+
+#include <chrono>
+#include <iostream>
+
+#include "ContentDeduplicator.h"
+
+// sum the size of the distinct Data objects in the loaded scene graphs, using a BinaryOutput to a null stream
+// so all the objects the serializer would write are reached, including state that isn't visited by Object::traverse().
+class CountData : public vsg::BinaryOutput
+{
+public:
+    explicit CountData(std::ostream& output) :
+        vsg::BinaryOutput(output, {})
+    {
+        version = vsg::vsgGetVersion();
+    }
+
+    size_t numData = 0;
+    size_t dataSize = 0;
+
+    using vsg::BinaryOutput::write;
+
+    void write(const vsg::Object* object) override
+    {
+        bool newObject = object && objectIDMap.count(object) == 0;
+        if (auto data = newObject ? object->cast<vsg::Data>() : nullptr)
+        {
+            ++numData;
+            dataSize += data->dataSize();
+        }
+        vsg::BinaryOutput::write(object);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+
+#ifdef vsgXchange_all
+    options->add(vsgXchange::all::create());
+#endif
+
+    options->readOptions(arguments);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    if (argc <= 1)
+    {
+        std::cout << "Usage:\n    vsgdeduplicate models/lz.vsgt models/teapot.vsgt ..." << std::endl;
+        return 1;
+    }
+
+    auto deduplicatingVSG = dedup::DeduplicatingVSG::create();
+    auto deduplicatingOptions = vsg::Options::create(*options);
+    deduplicatingOptions->readerWriters.insert(deduplicatingOptions->readerWriters.begin(), deduplicatingVSG);
+
+    using clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](clock::time_point start) { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
+
+    for (auto [description, readOptions] : {std::make_pair("vsg::read()", options), std::make_pair("vsg::read() with DeduplicatingVSG", deduplicatingOptions)})
+    {
+        std::vector<vsg::ref_ptr<vsg::Object>> objects;
+
+        auto start = clock::now();
+        for (int i = 1; i < argc; ++i)
+        {
+            if (auto object = vsg::read(arguments[i], readOptions)) objects.push_back(object);
+            else std::cout << "Unable to load file " << arguments[i] << std::endl;
+        }
+        auto readTime = milliseconds(start);
+
+        std::ostream nullStream(nullptr);
+        CountData countData(nullStream);
+        for (auto& object : objects) countData.writeObject("Root", object);
+
+        std::cout << "\n" << description << " : " << objects.size() << " files read in " << readTime << "ms, "
+                  << countData.numData << " distinct Data totalling " << countData.dataSize << " bytes" << std::endl;
+    }
+
+    std::cout << std::endl;
+    deduplicatingVSG->deduplicator->report(std::cout);
+
+    return 0;
+}
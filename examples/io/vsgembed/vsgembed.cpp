@@ -0,0 +1,186 @@
+#include <vsg/all.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// extract the model from an existing embedded model source file, either a sequence of concatenated R"( raw string literals as in
+// vsgiosnative/lz.cpp, or a brace enclosed list of byte values as in the model_teapot.cpp files
+std::string extractEmbeddedModel(const std::string& source)
+{
+    if (source.find("R\"(") != std::string::npos)
+    {
+        // join the contents of each R"(...)" piece, skipping the )" R"( delimiters and whitespace between them
+        std::string model;
+        for (auto rawStart = source.find("R\"("); rawStart != std::string::npos; rawStart = source.find("R\"(", rawStart))
+        {
+            rawStart += 3;
+            auto rawEnd = source.find(")\"", rawStart);
+            if (rawEnd == std::string::npos) return {};
+            model.append(source, rawStart, rawEnd - rawStart);
+            rawStart = rawEnd + 2;
+        }
+        return model;
+    }
+
+    auto listStart = source.find('{');
+    auto listEnd = source.find('}', listStart);
+    if (listStart == std::string::npos || listEnd == std::string::npos) return {};
+
+    std::string model;
+    std::istringstream values(source.substr(listStart + 1, listEnd - listStart - 1));
+    unsigned int value = 0;
+    char separator;
+    while (values >> value)
+    {
+        model.push_back(static_cast<char>(value));
+        values >> separator;
+    }
+    return model;
+}
+
+// write the native binary form of a model as a C++ source file defining a static lambda with the same signature as the existing embedded models
+void writeEmbeddedSource(std::ostream& fout, const std::string& binary, const std::string& name, const std::string& type, const vsg::Path& source)
+{
+    fout << "// generated by vsgembed from " << source.string() << ", do not edit." << std::endl;
+    fout << "#include <vsg/io/VSG.h>" << std::endl;
+    fout << "static constexpr uint8_t " << name << "_data[] = {" << std::endl;
+
+    fout << std::hex << std::setfill('0');
+    for (size_t i = 0; i < binary.size(); ++i)
+    {
+        fout << "0x" << std::setw(2) << static_cast<unsigned int>(static_cast<uint8_t>(binary[i]));
+        if (i + 1 < binary.size()) fout << ((i % 16 == 15) ? ",\n" : ", ");
+    }
+    fout << std::dec << " };" << std::endl;
+
+    fout << "static auto " << name << " = []() {" << std::endl;
+    fout << "vsg::VSG io;" << std::endl;
+    fout << "return io.read_cast<" << type << ">(" << name << "_data, sizeof(" << name << "_data));" << std::endl;
+    fout << "};" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto name = arguments.value<std::string>("", "--name");
+    auto type = arguments.value<std::string>("", "--type");
+    auto benchmark = arguments.read("--benchmark");
+    auto iterations = arguments.value(10u, "--iterations");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    if (argc < 2 || (argc < 3 && !benchmark))
+    {
+        std::cout << "Usage:\n    vsgembed input.vsgt|input.vsgb|embedded_model.cpp output.cpp [--name variable] [--type vsg::ClassName]" << std::endl;
+        std::cout << "    vsgembed input.vsgt|input.vsgb|embedded_model.cpp --benchmark [--iterations count]" << std::endl;
+        return 1;
+    }
+
+    vsg::Path inputFilename = argv[1];
+
+    std::string inputData;
+    {
+        std::ifstream fin(inputFilename, std::ios::in | std::ios::binary);
+        if (!fin)
+        {
+            std::cout << "Warning: unable to open " << inputFilename << std::endl;
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << fin.rdbuf();
+        inputData = contents.str();
+    }
+
+    if (vsg::lowerCaseFileExtension(inputFilename) == ".cpp")
+    {
+        inputData = extractEmbeddedModel(inputData);
+        if (inputData.empty())
+        {
+            std::cout << "Warning: no embedded model found in " << inputFilename << std::endl;
+            return 1;
+        }
+    }
+
+    vsg::VSG io;
+
+    auto object = io.read(reinterpret_cast<const uint8_t*>(inputData.data()), inputData.size());
+    if (!object)
+    {
+        std::cout << "Warning: unable to read model from " << inputFilename << std::endl;
+        return 1;
+    }
+
+    // convert to the native binary form
+    auto binaryOptions = vsg::Options::create();
+    binaryOptions->extensionHint = ".vsgb";
+
+    std::ostringstream binaryStream;
+    io.write(object, binaryStream, binaryOptions);
+    auto binary = binaryStream.str();
+
+    // check the binary form reads back through vsg::read() to the same scene graph, comparing their .vsgt text forms
+    {
+        auto textOptions = vsg::Options::create();
+        textOptions->extensionHint = ".vsgt";
+
+        auto asText = [&](const vsg::Object* model) {
+            std::ostringstream text;
+            if (model) io.write(model, text, textOptions);
+            return text.str();
+        };
+
+        std::istringstream binaryInput(binary);
+        auto roundTripped = vsg::read(binaryInput, binaryOptions);
+        if (!roundTripped || asText(roundTripped) != asText(object))
+        {
+            std::cout << "Warning: model from " << inputFilename << " doesn't round trip through the native binary format." << std::endl;
+            return 1;
+        }
+    }
+
+    if (benchmark)
+    {
+        using clock = std::chrono::high_resolution_clock;
+        auto milliseconds = [](clock::time_point start) { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
+
+        // match the startup path of the existing embedded models, constructing the std::istringstream from the literal on each call
+        auto start = clock::now();
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            std::istringstream str(inputData);
+            io.read(str);
+        }
+        auto sourceTime = milliseconds(start) / static_cast<double>(iterations);
+
+        start = clock::now();
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            io.read(reinterpret_cast<const uint8_t*>(binary.data()), binary.size());
+        }
+        auto binaryTime = milliseconds(start) / static_cast<double>(iterations);
+
+        std::cout << inputFilename << " : source " << inputData.size() << " bytes, read in " << sourceTime << "ms" << std::endl;
+        std::cout << inputFilename << " : binary " << binary.size() << " bytes, read in " << binaryTime << "ms, speedup " << sourceTime / binaryTime << std::endl;
+    }
+
+    if (argc < 3) return 0;
+
+    vsg::Path outputFilename = argv[2];
+
+    if (name.empty()) name = vsg::simpleFilename(outputFilename).string();
+    if (type.empty()) type = object->className();
+
+    std::ofstream fout(outputFilename);
+    if (!fout)
+    {
+        std::cout << "Warning: unable to write " << outputFilename << std::endl;
+        return 1;
+    }
+
+    writeEmbeddedSource(fout, binary, name, type, vsg::filename(inputFilename));
+
+    return 0;
+}
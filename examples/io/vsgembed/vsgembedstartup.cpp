@@ -0,0 +1,60 @@
+#include <vsg/all.h>
+
+#include <chrono>
+#include <iostream>
+#include <set>
+
+#include "lz.cpp"
+#include "lz_binary.cpp"
+
+// count the objects in the loaded graph to check both forms of the model match
+struct CountObjects : public vsg::Inherit<vsg::ConstVisitor, CountObjects>
+{
+    std::set<const vsg::Object*> objects;
+
+    void apply(const vsg::Object& object) override
+    {
+        if (objects.insert(&object).second) object.traverse(*this);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto iterations = arguments.value(10u, "--iterations");
+    auto binaryFirst = arguments.read("--binary-first");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    using clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](clock::time_point start) { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
+
+    auto benchmark = [&](const std::string& description, auto& model) {
+        // the first call is what an application pays at startup, the following calls show the cost once the caches are warm
+        auto start = clock::now();
+        auto scene = model();
+        auto firstTime = milliseconds(start);
+
+        start = clock::now();
+        for (uint32_t i = 0; i < iterations; ++i) model();
+        auto averageTime = milliseconds(start) / static_cast<double>(iterations);
+
+        CountObjects countObjects;
+        if (scene) scene->accept(countObjects);
+
+        std::cout << description << " : first read " << firstTime << "ms, average read " << averageTime << "ms, objects " << countObjects.objects.size() << std::endl;
+    };
+
+    if (binaryFirst)
+    {
+        benchmark("lz embedded native binary (" + std::to_string(sizeof(lz_binary_data)) + " bytes)", lz_binary);
+        benchmark("lz embedded .vsgt text", lz);
+    }
+    else
+    {
+        benchmark("lz embedded .vsgt text", lz);
+        benchmark("lz embedded native binary (" + std::to_string(sizeof(lz_binary_data)) + " bytes)", lz_binary);
+    }
+
+    return 0;
+}
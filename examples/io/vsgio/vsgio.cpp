@@ -1,7 +1,12 @@
 #include <vsg/all.h>
 
+#include <chrono>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <set>
+#include <sstream>
 #include <unordered_map>
 
 vsg::ref_ptr<vsg::Node> createQuadTree(unsigned int numLevels, vsg::Node* sharedLeaf)
@@ -36,6 +41,114 @@ vsg::ref_ptr<vsg::Node> createQuadGroupTree(unsigned int numLevels, vsg::Node* s
     return t;
 }
 
+vsg::ref_ptr<vsg::Object> createArrayHeavyObject(uint32_t numElements)
+{
+    auto group = vsg::Group::create();
+
+    auto vertices = vsg::vec3Array::create(numElements);
+    for (uint32_t i = 0; i < numElements; ++i) vertices->at(i).set(static_cast<float>(i), static_cast<float>(i % 1024), static_cast<float>(i % 7));
+    group->setObject("vertices", vertices);
+
+    uint32_t width = static_cast<uint32_t>(std::sqrt(static_cast<double>(numElements)));
+    auto image = vsg::vec4Array2D::create(width, width);
+    for (uint32_t i = 0; i < image->width(); ++i)
+    {
+        for (uint32_t j = 0; j < image->height(); ++j)
+        {
+            image->at(i, j) = vsg::vec4(static_cast<float>(i), static_cast<float>(j), static_cast<float>(i * j), 1.0f);
+        }
+    }
+    group->setObject("image", image);
+
+    return group;
+}
+
+// count the objects in a graph so throughput can be reported in objects per second
+struct CountObjects : public vsg::Inherit<vsg::ConstVisitor, CountObjects>
+{
+    std::set<const vsg::Object*> objects;
+
+    void apply(const vsg::Object& object) override
+    {
+        if (!objects.insert(&object).second) return;
+
+        // objects attached with setObject() are written out with their owner so count them too
+        if (auto auxiliary = object.getAuxiliary())
+        {
+            for (auto& [key, userObject] : auxiliary->userObjects)
+            {
+                if (userObject) userObject->accept(*this);
+            }
+        }
+
+        object.traverse(*this);
+    }
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string format;
+    size_t numObjects = 0;
+    size_t numBytes = 0;
+    double writeTime = 0.0;
+    double readTime = 0.0;
+};
+
+// write the object to memory, then read it back, numIterations times in the specified format, recording the fastest times
+BenchmarkResult benchmark(const std::string& name, const vsg::Object* object, const vsg::Path& extension, unsigned int numIterations)
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    CountObjects countObjects;
+    object->accept(countObjects);
+
+    BenchmarkResult result;
+    result.name = name;
+    result.format = extension.string();
+    result.numObjects = countObjects.objects.size();
+    result.writeTime = std::numeric_limits<double>::max();
+    result.readTime = std::numeric_limits<double>::max();
+
+    auto options = vsg::Options::create();
+    options->extensionHint = extension;
+
+    vsg::VSG io;
+    for (unsigned int i = 0; i < numIterations; ++i)
+    {
+        std::ostringstream out(std::ios::out | std::ios::binary);
+
+        auto start = clock::now();
+        io.write(object, out, options);
+        result.writeTime = std::min(result.writeTime, std::chrono::duration<double>(clock::now() - start).count());
+
+        auto buffer = out.str();
+        result.numBytes = buffer.size();
+
+        std::istringstream in(buffer, std::ios::in | std::ios::binary);
+
+        start = clock::now();
+        auto read_object = io.read(in, options);
+        result.readTime = std::min(result.readTime, std::chrono::duration<double>(clock::now() - start).count());
+
+        if (!read_object) std::cout << "Warning: failed to read back " << name << " in " << extension << " format." << std::endl;
+    }
+
+    return result;
+}
+
+void writeCSV(std::ostream& out, const std::vector<BenchmarkResult>& results)
+{
+    out << "name,format,objects,bytes,write_ms,write_MBps,write_objects_per_s,read_ms,read_MBps,read_objects_per_s" << std::endl;
+    for (auto& r : results)
+    {
+        double MB = static_cast<double>(r.numBytes) / (1024.0 * 1024.0);
+        out << r.name << "," << r.format << "," << r.numObjects << "," << r.numBytes << ","
+            << r.writeTime * 1000.0 << "," << MB / r.writeTime << "," << static_cast<double>(r.numObjects) / r.writeTime << ","
+            << r.readTime * 1000.0 << "," << MB / r.readTime << "," << static_cast<double>(r.numObjects) / r.readTime << std::endl;
+    }
+}
+
 int main(int argc, char** argv)
 {
     vsg::CommandLine arguments(&argc, argv);
@@ -44,8 +157,50 @@ int main(int argc, char** argv)
     auto inputFilename = arguments.value(std::string(), "-i");
     auto outputFilename = arguments.value<vsg::Path>("", "-o");
 
+    // benchmark mode, reporting serialization throughput of .vsgt and .vsgb as CSV
+    auto runBenchmark = arguments.read("--benchmark");
+    auto numIterations = arguments.value(5u, "--iterations");
+    auto arraySize = arguments.value(1000000u, "--array-size");
+    auto csvFilename = arguments.value<vsg::Path>("", "--csv");
+
     if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
 
+    if (runBenchmark)
+    {
+        std::vector<std::pair<std::string, vsg::ref_ptr<vsg::Object>>> objects;
+        objects.emplace_back("QuadTree levels=" + std::to_string(numLevels), createQuadTree(numLevels, nullptr));
+        objects.emplace_back("QuadGroupTree levels=" + std::to_string(numLevels), createQuadGroupTree(numLevels, nullptr));
+        objects.emplace_back("Arrays elements=" + std::to_string(arraySize), createArrayHeavyObject(arraySize));
+
+        // add any models specified on the command line, such as data/models/*.vsgt
+        for (int i = 1; i < argc; ++i)
+        {
+            vsg::Path filename = arguments[i];
+            if (auto object = vsg::read(filename))
+                objects.emplace_back(vsg::simpleFilename(filename).string(), object);
+            else
+                std::cout << "Warning: file not read : " << filename << std::endl;
+        }
+
+        std::vector<BenchmarkResult> results;
+        for (auto& [name, object] : objects)
+        {
+            results.push_back(benchmark(name, object, ".vsgt", numIterations));
+            results.push_back(benchmark(name, object, ".vsgb", numIterations));
+        }
+
+        if (csvFilename)
+        {
+            std::ofstream fout(csvFilename);
+            writeCSV(fout, results);
+        }
+        else
+        {
+            writeCSV(std::cout, results);
+        }
+        return 0;
+    }
+
     vsg::ref_ptr<vsg::Object> object;
     if (inputFilename.empty())
     {
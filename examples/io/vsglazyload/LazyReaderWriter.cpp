@@ -0,0 +1,286 @@
+#include "LazyReaderWriter.h"
+
+#include "FindSubgraphs.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace lazy;
+
+// Register the LazySubgraph::create() method with vsg::ObjectFactory::instance() so it can be used for creating objects during reading.
+vsg::RegisterWithObjectFactoryProxy<LazySubgraph> s_Register_LazySubgraph;
+
+namespace
+{
+    const char s_magic[8] = {'v', 's', 'g', 'l', ' ', 'v', '1', '\n'};
+
+    struct Header
+    {
+        char magic[8];
+        vsg::VsgVersion version;
+        uint64_t numEntries = 0;
+        uint64_t indexOffset = 0;
+    };
+
+    using SubgraphIndices = std::map<const vsg::Object*, uint32_t>;
+
+    // BinaryOutput that writes a LazySubgraph in place of the subgraphs stored separately
+    class LazyOutput : public vsg::BinaryOutput
+    {
+    public:
+        LazyOutput(std::ostream& output, vsg::ref_ptr<const vsg::Options> in_options, const SubgraphIndices& in_subgraphIndices) :
+            vsg::BinaryOutput(output, in_options),
+            subgraphIndices(in_subgraphIndices)
+        {
+        }
+
+        const SubgraphIndices& subgraphIndices;
+        std::map<uint32_t, vsg::ref_ptr<LazySubgraph>> placeholders;
+
+        using vsg::BinaryOutput::write;
+
+        void write(const vsg::Object* object) override
+        {
+            if (auto itr = subgraphIndices.find(object); itr != subgraphIndices.end())
+            {
+                auto& placeholder = placeholders[itr->second];
+                if (!placeholder)
+                {
+                    placeholder = LazySubgraph::create();
+                    placeholder->index = itr->second;
+                }
+                vsg::BinaryOutput::write(placeholder.get());
+                return;
+            }
+
+            vsg::BinaryOutput::write(object);
+        }
+    };
+
+    // BinaryInput that replaces each LazySubgraph with a PagedLOD proxy that loads the subgraph when it's first traversed
+    class LazyInput : public vsg::BinaryInput
+    {
+    public:
+        LazyInput(std::istream& input, vsg::ref_ptr<const vsg::Options> in_options, const std::vector<LazyReaderWriter::Entry>& in_entries, const vsg::Path& in_filename) :
+            vsg::BinaryInput(input, vsg::ObjectFactory::instance(), in_options),
+            entries(in_entries),
+            filename(in_filename)
+        {
+        }
+
+        const std::vector<LazyReaderWriter::Entry>& entries;
+        vsg::Path filename;
+        std::map<uint32_t, vsg::ref_ptr<vsg::PagedLOD>> proxies;
+
+        using vsg::BinaryInput::read;
+
+        vsg::ref_ptr<vsg::Object> read() override
+        {
+            auto object = vsg::BinaryInput::read();
+            auto placeholder = object.cast<LazySubgraph>();
+            if (!placeholder || placeholder->index == 0 || placeholder->index >= entries.size()) return object;
+
+            auto& proxy = proxies[placeholder->index];
+            if (!proxy)
+            {
+                auto subgraphOptions = options ? vsg::Options::create(*options) : vsg::Options::create();
+                subgraphOptions->setValue(LazyReaderWriter::subgraphIndex, placeholder->index);
+
+                proxy = vsg::PagedLOD::create();
+                proxy->bound = entries[placeholder->index].bound;
+                proxy->filename = filename;
+                proxy->options = subgraphOptions;
+
+                // a minimumScreenHeightRatio of 0 selects the subgraph whenever the proxy's bound is in view, requesting it if it's not yet loaded
+                proxy->children[0] = vsg::PagedLOD::Child{0.0, {}};
+                proxy->children[1] = vsg::PagedLOD::Child{0.0, {}};
+            }
+            return proxy;
+        }
+    };
+} // namespace
+
+void LazySubgraph::read(vsg::Input& input)
+{
+    vsg::Object::read(input);
+    input.read("index", index);
+}
+
+void LazySubgraph::write(vsg::Output& output) const
+{
+    vsg::Object::write(output);
+    output.write("index", index);
+}
+
+bool LazyReaderWriter::getFeatures(Features& features) const
+{
+    features.extensionFeatureMap[".vsgl"] = static_cast<FeatureMask>(READ_FILENAME | WRITE_FILENAME);
+    return true;
+}
+
+bool LazyReaderWriter::write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgl" || !object) return false;
+
+    FindSubgraphs findSubgraphs(splitLevel);
+    object->accept(findSubgraphs);
+
+    // entry 0 is always the root
+    SubgraphIndices subgraphIndices;
+    std::vector<const vsg::Node*> subgraphs{nullptr};
+    for (auto subgraph : findSubgraphs.subgraphs)
+    {
+        if (subgraphIndices.emplace(subgraph, static_cast<uint32_t>(subgraphs.size())).second) subgraphs.push_back(subgraph);
+    }
+
+    // the file's cached index won't match what's about to be written
+    {
+        std::scoped_lock<std::mutex> lock(_indexMutex);
+        _indices.erase(filename);
+    }
+
+    std::ofstream fout(filename, std::ios::out | std::ios::binary);
+    if (!fout) return false;
+
+    Header header;
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = vsg::vsgGetVersion();
+    header.numEntries = subgraphs.size();
+
+    // write the header with the index offset once all the streams have been written
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    std::vector<Entry> entries(subgraphs.size());
+
+    auto writeStream = [&](vsg::BinaryOutput& output, const vsg::Object* root, Entry& entry) {
+        entry.offset = static_cast<uint64_t>(fout.tellp());
+        output.version = vsg::vsgGetVersion();
+        output.writeObject("Root", root);
+        entry.size = static_cast<uint64_t>(fout.tellp()) - entry.offset;
+    };
+
+    LazyOutput rootOutput(fout, options, subgraphIndices);
+    writeStream(rootOutput, object, entries[0]);
+
+    // subgraphs are written as independent streams so objects shared between them are duplicated,
+    // use Options::sharedObjects when reading to share state again.
+    for (size_t i = 1; i < subgraphs.size(); ++i)
+    {
+        vsg::BinaryOutput output(fout, options);
+        writeStream(output, subgraphs[i], entries[i]);
+
+        vsg::ComputeBounds computeBounds;
+        subgraphs[i]->accept(computeBounds);
+        if (computeBounds.bounds.valid())
+        {
+            entries[i].bound.center = (computeBounds.bounds.min + computeBounds.bounds.max) * 0.5;
+            entries[i].bound.radius = vsg::length(computeBounds.bounds.max - computeBounds.bounds.min) * 0.5;
+        }
+    }
+
+    header.indexOffset = static_cast<uint64_t>(fout.tellp());
+    fout.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+
+    fout.seekp(0);
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    return fout.good();
+}
+
+bool LazyReaderWriter::readIndex(std::istream& fin, const vsg::Path& filename, Index& index) const
+{
+    Header header;
+    fin.read(reinterpret_cast<char*>(&header), sizeof(Header));
+    if (!fin || std::memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.numEntries == 0) return false;
+
+    fin.seekg(0, std::ios::end);
+    auto fileSize = static_cast<uint64_t>(fin.tellg());
+
+    std::scoped_lock<std::mutex> lock(_indexMutex);
+
+    // the file may have been rewritten since its index was cached, by another process or a ReaderWriter other than this one
+    if (auto itr = _indices.find(filename); itr != _indices.end())
+    {
+        auto& cached = itr->second;
+        if (cached.fileSize == fileSize && cached.indexOffset == header.indexOffset && cached.entries.size() == header.numEntries &&
+            cached.version.major == header.version.major && cached.version.minor == header.version.minor &&
+            cached.version.patch == header.version.patch && cached.version.soversion == header.version.soversion)
+        {
+            index = cached;
+            return true;
+        }
+        _indices.erase(itr);
+    }
+
+    if (header.indexOffset + header.numEntries * sizeof(Entry) > fileSize)
+    {
+        vsg::warn("LazyReaderWriter::read(", filename, ") file truncated.");
+        return false;
+    }
+
+    index.version = header.version;
+    index.indexOffset = header.indexOffset;
+    index.fileSize = fileSize;
+    index.entries.resize(static_cast<size_t>(header.numEntries));
+    fin.seekg(static_cast<std::streamoff>(header.indexOffset));
+    fin.read(reinterpret_cast<char*>(index.entries.data()), index.entries.size() * sizeof(Entry));
+    if (!fin)
+    {
+        vsg::warn("LazyReaderWriter::read(", filename, ") file truncated.");
+        return false;
+    }
+
+    _indices[filename] = index;
+    return true;
+}
+
+vsg::ref_ptr<vsg::Object> LazyReaderWriter::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgl") return {};
+
+    auto filenameToUse = vsg::findFile(filename, options);
+    if (!filenameToUse) return {};
+
+    std::ifstream fin(filenameToUse, std::ios::in | std::ios::binary);
+    if (!fin) return {};
+
+    Index fileIndex;
+    if (!readIndex(fin, filenameToUse, fileIndex)) return {};
+
+    auto& version = fileIndex.version;
+    auto& entries = fileIndex.entries;
+
+    uint32_t index = 0;
+    if (options) options->getValue(subgraphIndex, index);
+    if (index >= entries.size()) return {};
+
+    fin.clear();
+    fin.seekg(static_cast<std::streamoff>(entries[index].offset));
+
+    if (index > 0)
+    {
+        // subgraphs are plain native binary streams
+        vsg::BinaryInput input(fin, vsg::ObjectFactory::instance(), options);
+        input.version = version;
+        return input.readObject<vsg::Object>("Root");
+    }
+
+    // make sure the proxies can find this ReaderWriter when the DatabasePager reads their subgraphs
+    auto rootOptions = options ? vsg::Options::create(*options) : vsg::Options::create();
+    if (std::find(rootOptions->readerWriters.begin(), rootOptions->readerWriters.end(), this) == rootOptions->readerWriters.end())
+    {
+        rootOptions->add(vsg::ref_ptr<vsg::ReaderWriter>(const_cast<LazyReaderWriter*>(this)));
+    }
+
+    LazyInput input(fin, rootOptions, entries, filenameToUse);
+    input.version = version;
+    return input.readObject<vsg::Object>("Root");
+}
+
+vsg::ref_ptr<vsg::Node> lazy::loadSubgraph(vsg::PagedLOD& proxy)
+{
+    auto& child = proxy.children[0];
+    if (!child.node) child.node = vsg::read_cast<vsg::Node>(proxy.filename, proxy.options);
+    return child.node;
+}
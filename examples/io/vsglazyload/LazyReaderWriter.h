@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <mutex>
+
+namespace lazy
+{
+
+    /// Placeholder written in place of a subgraph that is stored separately and loaded on demand.
+    class LazySubgraph : public vsg::Inherit<vsg::Object, LazySubgraph>
+    {
+    public:
+        uint32_t index = 0;
+
+        void read(vsg::Input& input) override;
+        void write(vsg::Output& output) const override;
+    };
+
+    /// ReaderWriter for .vsgl files, a lazy loading variant of the native binary format.
+    /// The subgraphs below splitLevel are written as separate native binary streams, with an index of their offsets and bounds.
+    /// Reading a .vsgl file only deserializes the top of the scene graph, returning a vsg::PagedLOD proxy with the stored bounds in place of each subgraph.
+    /// The subgraphs are then deserialized by the DatabasePager on first traversal, or on explicit request with loadSubgraph().
+    class LazyReaderWriter : public vsg::Inherit<vsg::ReaderWriter, LazyReaderWriter>
+    {
+    public:
+        struct Entry
+        {
+            uint64_t offset = 0;
+            uint64_t size = 0;
+            vsg::dsphere bound;
+        };
+
+        /// depth of Group nesting at which children are written as separate, lazily loaded subgraphs, the default of 1 splits out the children of the root's child groups.
+        uint32_t splitLevel = 1;
+
+        vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+        bool write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+        bool getFeatures(Features& features) const override;
+
+        /// name of the Options value used to pass the subgraph index to read.
+        static constexpr const char* subgraphIndex = "lazy::subgraph";
+
+    protected:
+        struct Index
+        {
+            vsg::VsgVersion version;
+            uint64_t indexOffset = 0;
+            uint64_t fileSize = 0;
+            std::vector<Entry> entries;
+        };
+
+        /// read the header and index of an open .vsgl file, reusing the cached index if the file's header and size still match it.
+        bool readIndex(std::istream& fin, const vsg::Path& filename, Index& index) const;
+
+        mutable std::mutex _indexMutex;
+        mutable std::map<vsg::Path, Index> _indices;
+    };
+
+    /// deserialize the subgraph of a proxy created by LazyReaderWriter if it hasn't already been loaded, returning the subgraph.
+    /// Subgraphs loaded this way aren't compiled, so use vsg::CompileManager before rendering them.
+    vsg::ref_ptr<vsg::Node> loadSubgraph(vsg::PagedLOD& proxy);
+
+} // namespace lazy
+
+EVSG_type_name(lazy::LazySubgraph);
+EVSG_type_name(lazy::LazyReaderWriter);
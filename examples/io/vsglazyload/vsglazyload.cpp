@@ -0,0 +1,143 @@
+#include <vsg/all.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "LazyReaderWriter.h"
+#include "ResidentSetSize.h"
+
+// create a two level scene graph of numSubgraphs VertexIndexDraw, spread out in a grid, with a total of numVertices vertices
+vsg::ref_ptr<vsg::Node> createLargeModel(uint32_t numVertices, uint32_t numSubgraphs)
+{
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    uint32_t verticesPerSubgraph = std::max(1u, numVertices / numSubgraphs);
+    uint32_t subgraphsPerGroup = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(numSubgraphs))));
+
+    auto root = vsg::Group::create();
+    vsg::ref_ptr<vsg::Group> group;
+    for (uint32_t s = 0; s < numSubgraphs; ++s)
+    {
+        if (s % subgraphsPerGroup == 0)
+        {
+            group = vsg::Group::create();
+            root->addChild(group);
+        }
+
+        vsg::vec3 origin(static_cast<float>(s % subgraphsPerGroup) * 4.0f, static_cast<float>(s / subgraphsPerGroup) * 4.0f, 0.0f);
+
+        auto vertices = vsg::vec3Array::create(verticesPerSubgraph);
+        auto normals = vsg::vec3Array::create(verticesPerSubgraph);
+        auto indices = vsg::uintArray::create(verticesPerSubgraph);
+        for (uint32_t i = 0; i < verticesPerSubgraph; ++i)
+        {
+            vsg::vec3 v(distribution(generator), distribution(generator), distribution(generator));
+            vertices->at(i) = origin + v;
+            normals->at(i) = vsg::normalize(v);
+            indices->at(i) = i;
+        }
+
+        auto vid = vsg::VertexIndexDraw::create();
+        vid->assignArrays(vsg::DataList{vertices, normals});
+        vid->assignIndices(indices);
+        vid->indexCount = verticesPerSubgraph;
+        vid->instanceCount = 1;
+
+        group->addChild(vid);
+    }
+    return root;
+}
+
+// collect the proxies created by LazyReaderWriter
+struct FindProxies : public vsg::Inherit<vsg::Visitor, FindProxies>
+{
+    std::vector<vsg::ref_ptr<vsg::PagedLOD>> proxies;
+
+    void apply(vsg::Node& node) override
+    {
+        node.traverse(*this);
+    }
+
+    void apply(vsg::PagedLOD& plod) override
+    {
+        proxies.emplace_back(&plod);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto numVertices = arguments.value(10000000u, "--vertices");
+    auto numSubgraphs = arguments.value(256u, "--subgraphs");
+    auto inputFilename = arguments.value<vsg::Path>("", "-i");
+    auto outputFilename = arguments.value<vsg::Path>("lazy_test", "-o");
+    auto numRequests = arguments.value(16u, "--requests");
+
+    auto lazyReaderWriter = lazy::LazyReaderWriter::create();
+    arguments.read("--split-level", lazyReaderWriter->splitLevel);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto options = vsg::Options::create();
+    options->add(lazyReaderWriter);
+
+    vsg::Path binaryFilename = outputFilename.string() + ".vsgb";
+    vsg::Path lazyFilename = outputFilename.string() + ".vsgl";
+
+    using clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](clock::time_point start) { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
+
+    {
+        vsg::ref_ptr<vsg::Object> object;
+        if (inputFilename)
+        {
+            object = vsg::read(inputFilename, options);
+            if (!object)
+            {
+                std::cout << "Warning: file not read : " << inputFilename << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            object = createLargeModel(numVertices, numSubgraphs);
+        }
+
+        vsg::write(object, binaryFilename, options);
+        vsg::write(object, lazyFilename, options);
+    }
+
+    for (auto& filename : {binaryFilename, lazyFilename})
+    {
+        auto rssBefore = residentSetSize();
+
+        auto start = clock::now();
+        auto object = vsg::read(filename, options);
+        auto readTime = milliseconds(start);
+
+        if (!object)
+        {
+            std::cout << "Warning: file not read : " << filename << std::endl;
+            continue;
+        }
+
+        std::cout << "\nRead " << filename << " in " << readTime << "ms, RSS increase " << (residentSetSize() - rssBefore) / 1024 << " KB" << std::endl;
+
+        auto proxies = vsg::visit<FindProxies>(object).proxies;
+        if (proxies.empty()) continue;
+
+        // explicitly request a subset of the subgraphs, as an application would for the regions it needs
+        numRequests = std::min(numRequests, static_cast<uint32_t>(proxies.size()));
+
+        start = clock::now();
+        for (uint32_t i = 0; i < numRequests; ++i) lazy::loadSubgraph(*proxies[i]);
+        auto requestTime = milliseconds(start);
+
+        std::cout << "Loaded " << numRequests << " of " << proxies.size() << " subgraphs in " << requestTime << "ms, RSS increase " << (residentSetSize() - rssBefore) / 1024 << " KB" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,394 @@
+#include "MappedData.h"
+
+#include <vsg/io/mem_stream.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+using namespace mapped;
+
+// Register the MappedDataReference::create() method with vsg::ObjectFactory::instance() so it can be used for creating objects during reading.
+vsg::RegisterWithObjectFactoryProxy<MappedDataReference> s_Register_MappedDataReference;
+
+namespace
+{
+    const char s_magic[8] = {'v', 's', 'g', 'm', ' ', 'v', '1', '\n'};
+
+    // payload section starts on a page boundary, with each payload aligned so the mapped arrays are suitably aligned for SIMD access
+    const uint64_t s_pageAlignment = 4096;
+    const uint64_t s_payloadAlignment = 64;
+
+    struct Header
+    {
+        char magic[8];
+        vsg::VsgVersion version;
+        uint64_t graphOffset = 0;
+        uint64_t graphSize = 0;
+        uint64_t payloadOffset = 0;
+        uint64_t payloadSize = 0;
+    };
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return ((value + alignment - 1) / alignment) * alignment;
+    }
+
+    // BinaryOutput that replaces large Data objects with MappedDataReference, collecting the payloads to write after the scene graph
+    class MappedDataOutput : public vsg::BinaryOutput
+    {
+    public:
+        MappedDataOutput(std::ostream& output, vsg::ref_ptr<const vsg::Options> in_options, const MappedDataReaderWriter& in_readerWriter) :
+            vsg::BinaryOutput(output, in_options),
+            readerWriter(in_readerWriter)
+        {
+        }
+
+        struct Payload
+        {
+            const vsg::Data* data = nullptr;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+        };
+
+        const MappedDataReaderWriter& readerWriter;
+        std::vector<Payload> payloads;
+        uint64_t payloadSize = 0;
+        std::map<const vsg::Data*, vsg::ref_ptr<MappedDataReference>> references;
+
+        using vsg::BinaryOutput::write;
+
+        void write(const vsg::Object* object) override
+        {
+            auto data = object ? object->cast<vsg::Data>() : nullptr;
+            if (!data || !readerWriter.supported(*data))
+            {
+                vsg::BinaryOutput::write(object);
+                return;
+            }
+
+            auto& reference = references[data];
+            if (!reference)
+            {
+                reference = MappedDataReference::create();
+                reference->className = data->className();
+                reference->width = data->width();
+                reference->height = data->height();
+                reference->depth = data->depth();
+                reference->properties = data->properties;
+                reference->offset = alignUp(payloadSize, s_payloadAlignment);
+                reference->size = data->dataSize();
+
+                // carry the Data's user objects on the reference so they're written with it and restored on read
+                if (auto auxiliary = data->getAuxiliary())
+                {
+                    for (auto& [key, userObject] : auxiliary->userObjects) reference->setObject(key, userObject);
+                }
+
+                payloads.push_back(Payload{data, reference->offset, reference->size});
+                payloadSize = reference->offset + reference->size;
+            }
+
+            vsg::BinaryOutput::write(reference.get());
+        }
+    };
+
+    // BinaryInput that replaces MappedDataReference with Data referencing the mapped payloads
+    class MappedDataInput : public vsg::BinaryInput
+    {
+    public:
+        MappedDataInput(std::istream& input, vsg::ref_ptr<const vsg::Options> in_options, const MappedDataReaderWriter& in_readerWriter, vsg::ref_ptr<MappedFile> in_mappedFile, const uint8_t* in_payloads, uint64_t in_payloadSize) :
+            vsg::BinaryInput(input, vsg::ObjectFactory::instance(), in_options),
+            readerWriter(in_readerWriter),
+            mappedFile(in_mappedFile),
+            payloads(in_payloads),
+            payloadSize(in_payloadSize)
+        {
+        }
+
+        const MappedDataReaderWriter& readerWriter;
+        vsg::ref_ptr<MappedFile> mappedFile;
+        const uint8_t* payloads = nullptr;
+        uint64_t payloadSize = 0;
+        std::map<const MappedDataReference*, vsg::ref_ptr<vsg::Data>> mappedData;
+
+        using vsg::BinaryInput::read;
+
+        vsg::ref_ptr<vsg::Object> read() override
+        {
+            auto object = vsg::BinaryInput::read();
+            auto reference = object.cast<MappedDataReference>();
+            if (!reference) return object;
+
+            auto& data = mappedData[reference.get()];
+            if (!data)
+            {
+                if (reference->offset + reference->size > payloadSize)
+                {
+                    vsg::warn("MappedDataReaderWriter payload of ", reference->className, " outside of mapped file.");
+                    return {};
+                }
+
+                data = readerWriter.create(*reference, payloads + reference->offset);
+                if (!data) return {};
+
+                if (auto auxiliary = reference->getAuxiliary())
+                {
+                    for (auto& [key, userObject] : auxiliary->userObjects) data->setObject(key, userObject);
+                }
+                data->setObject("MappedFile", mappedFile);
+            }
+            return data;
+        }
+    };
+} // namespace
+
+vsg::ref_ptr<MappedFile> MappedFile::open(const vsg::Path& filename)
+{
+    vsg::ref_ptr<MappedFile> mappedFile(new MappedFile);
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return {};
+    mappedFile->_fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return {};
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping) return {};
+    mappedFile->_mappingHandle = mapping;
+
+    auto ptr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!ptr) return {};
+
+    mappedFile->_data = static_cast<const uint8_t*>(ptr);
+    mappedFile->_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filename.string().c_str(), O_RDONLY);
+    if (fd < 0) return {};
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        ::close(fd);
+        return {};
+    }
+
+    // copy-on-write, so pages are shared via the OS page cache with any other processes mapping the same file until they're written to,
+    // when the written pages are copied into memory private to this process and the file is left unchanged
+    auto ptr = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) return {};
+
+    mappedFile->_data = static_cast<const uint8_t*>(ptr);
+    mappedFile->_size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    return mappedFile;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (_data) UnmapViewOfFile(_data);
+    if (_mappingHandle) CloseHandle(_mappingHandle);
+    if (_fileHandle) CloseHandle(_fileHandle);
+#else
+    if (_data) munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+}
+
+void MappedDataReference::read(vsg::Input& input)
+{
+    vsg::Object::read(input);
+
+    input.read("className", className);
+    input.read("width", width);
+    input.read("height", height);
+    input.read("depth", depth);
+
+    input.readValue<uint32_t>("format", properties.format);
+    input.read("stride", properties.stride);
+    input.read("maxNumMipmaps", properties.maxNumMipmaps);
+    input.read("blockWidth", properties.blockWidth);
+    input.read("blockHeight", properties.blockHeight);
+    input.read("blockDepth", properties.blockDepth);
+    input.read("origin", properties.origin);
+    input.read("imageViewType", properties.imageViewType);
+    input.readValue<uint32_t>("dataVariance", properties.dataVariance);
+
+    input.read("offset", offset);
+    input.read("size", size);
+}
+
+void MappedDataReference::write(vsg::Output& output) const
+{
+    vsg::Object::write(output);
+
+    output.write("className", className);
+    output.write("width", width);
+    output.write("height", height);
+    output.write("depth", depth);
+
+    output.writeValue<uint32_t>("format", properties.format);
+    output.write("stride", properties.stride);
+    output.write("maxNumMipmaps", properties.maxNumMipmaps);
+    output.write("blockWidth", properties.blockWidth);
+    output.write("blockHeight", properties.blockHeight);
+    output.write("blockDepth", properties.blockDepth);
+    output.write("origin", properties.origin);
+    output.write("imageViewType", properties.imageViewType);
+    output.writeValue<uint32_t>("dataVariance", properties.dataVariance);
+
+    output.write("offset", offset);
+    output.write("size", size);
+}
+
+MappedDataReaderWriter::MappedDataReaderWriter()
+{
+    addArray<vsg::ubyteArray>();
+    addArray<vsg::ushortArray>();
+    addArray<vsg::uintArray>();
+    addArray<vsg::floatArray>();
+    addArray<vsg::doubleArray>();
+    addArray<vsg::vec2Array>();
+    addArray<vsg::vec3Array>();
+    addArray<vsg::vec4Array>();
+    addArray<vsg::dvec3Array>();
+    addArray<vsg::ubvec4Array>();
+
+    addArray2D<vsg::ubyteArray2D>();
+    addArray2D<vsg::ushortArray2D>();
+    addArray2D<vsg::floatArray2D>();
+    addArray2D<vsg::ubvec2Array2D>();
+    addArray2D<vsg::ubvec3Array2D>();
+    addArray2D<vsg::ubvec4Array2D>();
+    addArray2D<vsg::vec4Array2D>();
+    addArray2D<vsg::block64Array2D>();
+    addArray2D<vsg::block128Array2D>();
+
+    addArray3D<vsg::ubyteArray3D>();
+    addArray3D<vsg::ubvec4Array3D>();
+    addArray3D<vsg::floatArray3D>();
+}
+
+bool MappedDataReaderWriter::supported(const vsg::Data& data) const
+{
+    // mapped data is intended for static data, and must be contiguous as it's written in a single block
+    if (data.properties.dataVariance >= vsg::DYNAMIC_DATA) return false;
+    if (data.properties.stride != data.valueSize()) return false;
+    if (data.dataSize() < minimumMappedSize) return false;
+
+    return _creators.count(data.className()) > 0;
+}
+
+vsg::ref_ptr<vsg::Data> MappedDataReaderWriter::create(const MappedDataReference& reference, const uint8_t* ptr) const
+{
+    auto itr = _creators.find(reference.className);
+    if (itr == _creators.end()) return {};
+
+    // the memory is owned by the MappedFile so the Data mustn't delete it, the mapping is copy-on-write so the Data may modify it
+    MappedDataReference mappedReference;
+    mappedReference.className = reference.className;
+    mappedReference.width = reference.width;
+    mappedReference.height = reference.height;
+    mappedReference.depth = reference.depth;
+    mappedReference.properties = reference.properties;
+    mappedReference.properties.allocatorType = vsg::ALLOCATOR_TYPE_NO_DELETE;
+
+    return itr->second(mappedReference, const_cast<uint8_t*>(ptr));
+}
+
+bool MappedDataReaderWriter::getFeatures(Features& features) const
+{
+    features.extensionFeatureMap[".vsgm"] = static_cast<FeatureMask>(READ_FILENAME | WRITE_FILENAME);
+    return true;
+}
+
+vsg::ref_ptr<vsg::Object> MappedDataReaderWriter::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgm") return {};
+
+    auto filenameToUse = vsg::findFile(filename, options);
+    if (!filenameToUse) return {};
+
+    auto mappedFile = MappedFile::open(filenameToUse);
+    if (!mappedFile || mappedFile->size() < sizeof(Header)) return {};
+
+    Header header;
+    std::memcpy(&header, mappedFile->data(), sizeof(Header));
+    if (std::memcmp(header.magic, s_magic, sizeof(s_magic)) != 0) return {};
+
+    if (header.graphOffset + header.graphSize > mappedFile->size() || header.payloadOffset + header.payloadSize > mappedFile->size())
+    {
+        vsg::warn("MappedDataReaderWriter::read(", filenameToUse, ") file truncated.");
+        return {};
+    }
+
+    // read the scene graph section directly from the mapping without copying it
+    vsg::mem_stream fin(mappedFile->data() + header.graphOffset, header.graphSize);
+
+    MappedDataInput input(fin, options, *this, mappedFile, mappedFile->data() + header.payloadOffset, header.payloadSize);
+    input.version = header.version;
+
+    return input.readObject<vsg::Object>("Root");
+}
+
+bool MappedDataReaderWriter::write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    if (vsg::lowerCaseFileExtension(filename) != ".vsgm") return false;
+
+    std::ostringstream graphStream(std::ios::out | std::ios::binary);
+
+    MappedDataOutput output(graphStream, options, *this);
+    output.version = vsg::vsgGetVersion();
+    output.writeObject("Root", object);
+
+    auto graph = graphStream.str();
+
+    Header header;
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = output.version;
+    header.graphOffset = sizeof(Header);
+    header.graphSize = graph.size();
+    header.payloadOffset = alignUp(header.graphOffset + header.graphSize, s_pageAlignment);
+    header.payloadSize = output.payloadSize;
+
+    std::ofstream fout(filename, std::ios::out | std::ios::binary);
+    if (!fout) return false;
+
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    fout.write(graph.data(), graph.size());
+
+    uint64_t position = header.graphOffset + header.graphSize;
+    auto padTo = [&](uint64_t offset) {
+        static const char zeros[s_pageAlignment] = {};
+        while (position < offset)
+        {
+            auto size = std::min(offset - position, s_pageAlignment);
+            fout.write(zeros, size);
+            position += size;
+        }
+    };
+
+    // write the payloads straight from the Data objects' storage
+    for (auto& payload : output.payloads)
+    {
+        padTo(header.payloadOffset + payload.offset);
+        fout.write(static_cast<const char*>(payload.data->dataPointer()), payload.size);
+        position += payload.size;
+    }
+
+    return fout.good();
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <functional>
+#include <map>
+
+namespace mapped
+{
+
+    /// Copy-on-write memory mapping of a whole file, writes to the mapping are private to the process and never reach the file.
+    /// The mapping is released when the last reference to the MappedFile is released.
+    class MappedFile : public vsg::Inherit<vsg::Object, MappedFile>
+    {
+    public:
+        /// map the file, returning null on failure.
+        static vsg::ref_ptr<MappedFile> open(const vsg::Path& filename);
+
+        const uint8_t* data() const { return _data; }
+        size_t size() const { return _size; }
+
+    protected:
+        MappedFile() = default;
+        virtual ~MappedFile();
+
+        const uint8_t* _data = nullptr;
+        size_t _size = 0;
+
+#ifdef _WIN32
+        void* _fileHandle = nullptr;
+        void* _mappingHandle = nullptr;
+#endif
+    };
+
+    /// Placeholder written into the scene graph stream in place of a Data object whose payload is stored in the mapped section of the file.
+    class MappedDataReference : public vsg::Inherit<vsg::Object, MappedDataReference>
+    {
+    public:
+        std::string className;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t depth = 0;
+        vsg::Data::Properties properties;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+
+        void read(vsg::Input& input) override;
+        void write(vsg::Output& output) const override;
+    };
+
+    /// ReaderWriter for .vsgm files, the native binary format with the payloads of large Data objects stored in a separate aligned section
+    /// that is memory mapped on read, so the arrays reference the OS page cache directly rather than being copied into allocator owned memory.
+    /// Mapped arrays use ALLOCATOR_TYPE_NO_DELETE and hold a reference to the MappedFile so the mapping stays valid while they're in use.
+    /// They can be modified, the pages written to are copied into process memory, and user objects attached to the arrays are written and restored.
+    class MappedDataReaderWriter : public vsg::Inherit<vsg::ReaderWriter, MappedDataReaderWriter>
+    {
+    public:
+        MappedDataReaderWriter();
+
+        /// Data objects smaller than this are written inline in the scene graph stream.
+        size_t minimumMappedSize = 65536;
+
+        vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+        bool write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+        bool getFeatures(Features& features) const override;
+
+        /// return true if Data of this type can be mapped.
+        bool supported(const vsg::Data& data) const;
+
+        /// create a Data object that references the mapped payload described by the reference.
+        vsg::ref_ptr<vsg::Data> create(const MappedDataReference& reference, const uint8_t* ptr) const;
+
+    protected:
+        using Creator = std::function<vsg::ref_ptr<vsg::Data>(const MappedDataReference& reference, void* ptr)>;
+        std::map<std::string, Creator> _creators;
+
+        template<class A>
+        void addArray()
+        {
+            _creators[vsg::type_name<A>()] = [](const MappedDataReference& reference, void* ptr) -> vsg::ref_ptr<vsg::Data> {
+                return A::create(reference.width, static_cast<typename A::value_type*>(ptr), reference.properties);
+            };
+        }
+
+        template<class A>
+        void addArray2D()
+        {
+            _creators[vsg::type_name<A>()] = [](const MappedDataReference& reference, void* ptr) -> vsg::ref_ptr<vsg::Data> {
+                return A::create(reference.width, reference.height, static_cast<typename A::value_type*>(ptr), reference.properties);
+            };
+        }
+
+        template<class A>
+        void addArray3D()
+        {
+            _creators[vsg::type_name<A>()] = [](const MappedDataReference& reference, void* ptr) -> vsg::ref_ptr<vsg::Data> {
+                return A::create(reference.width, reference.height, reference.depth, static_cast<typename A::value_type*>(ptr), reference.properties);
+            };
+        }
+    };
+
+} // namespace mapped
+
+EVSG_type_name(mapped::MappedFile);
+EVSG_type_name(mapped::MappedDataReference);
+EVSG_type_name(mapped::MappedDataReaderWriter);
@@ -0,0 +1,151 @@
+#include <vsg/all.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "MappedData.h"
+#include "ResidentSetSize.h"
+
+// create a scene graph with large vertex, normal and index arrays to stand in for a big static dataset
+vsg::ref_ptr<vsg::Node> createLargeModel(uint32_t numArrays, uint32_t numVertices)
+{
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+
+    auto group = vsg::Group::create();
+    for (uint32_t a = 0; a < numArrays; ++a)
+    {
+        auto vertices = vsg::vec3Array::create(numVertices);
+        auto normals = vsg::vec3Array::create(numVertices);
+        for (uint32_t i = 0; i < numVertices; ++i)
+        {
+            vertices->at(i).set(distribution(generator), distribution(generator), distribution(generator));
+            normals->at(i) = vsg::normalize(vertices->at(i));
+        }
+
+        auto indices = vsg::uintArray::create(numVertices);
+        for (uint32_t i = 0; i < numVertices; ++i) indices->at(i) = i;
+
+        auto vid = vsg::VertexIndexDraw::create();
+        vid->assignArrays(vsg::DataList{vertices, normals});
+        vid->assignIndices(indices);
+        vid->indexCount = numVertices;
+        vid->instanceCount = 1;
+
+        group->addChild(vid);
+    }
+    return group;
+}
+
+// visit all the arrays to fault in their pages, returning a checksum so the reads can't be optimized away
+struct TouchData : public vsg::Inherit<vsg::ConstVisitor, TouchData>
+{
+    double sum = 0.0;
+    size_t numBytes = 0;
+
+    void apply(const vsg::Object& object) override
+    {
+        object.traverse(*this);
+    }
+
+    void apply(const vsg::Data& data) override
+    {
+        auto ptr = static_cast<const uint8_t*>(data.dataPointer());
+        if (!ptr) return;
+
+        auto size = data.dataSize();
+        for (size_t i = 0; i < size; i += 4096) sum += ptr[i];
+        numBytes += size;
+    }
+
+    void apply(const vsg::VertexIndexDraw& vid) override
+    {
+        for (auto& array : vid.arrays)
+        {
+            if (array->data) array->data->accept(*this);
+        }
+        if (vid.indices && vid.indices->data) vid.indices->data->accept(*this);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto numArrays = arguments.value(16u, "--arrays");
+    auto numVertices = arguments.value(1000000u, "--vertices");
+    auto inputFilename = arguments.value<vsg::Path>("", "-i");
+    auto outputFilename = arguments.value<vsg::Path>("mapped_test", "-o");
+    auto touch = arguments.read("--touch");
+    auto readOnly = arguments.read("--read-only");
+
+    auto mappedDataReaderWriter = mapped::MappedDataReaderWriter::create();
+    arguments.read("--min-size", mappedDataReaderWriter->minimumMappedSize);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto options = vsg::Options::create();
+    options->add(mappedDataReaderWriter);
+
+    vsg::Path binaryFilename = outputFilename.string() + ".vsgb";
+    vsg::Path mappedFilename = outputFilename.string() + ".vsgm";
+
+    using clock = std::chrono::high_resolution_clock;
+    auto seconds = [](clock::time_point start) { return std::chrono::duration<double>(clock::now() - start).count(); };
+
+    if (!readOnly)
+    {
+        vsg::ref_ptr<vsg::Object> object;
+        if (inputFilename)
+        {
+            object = vsg::read(inputFilename, options);
+            if (!object)
+            {
+                std::cout << "Warning: file not read : " << inputFilename << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            object = createLargeModel(numArrays, numVertices);
+        }
+
+        auto start = clock::now();
+        vsg::write(object, binaryFilename, options);
+        std::cout << "Written " << binaryFilename << " in " << seconds(start) << " seconds." << std::endl;
+
+        start = clock::now();
+        vsg::write(object, mappedFilename, options);
+        std::cout << "Written " << mappedFilename << " in " << seconds(start) << " seconds." << std::endl;
+    }
+
+    for (auto& filename : {binaryFilename, mappedFilename})
+    {
+        auto rssBefore = residentSetSize();
+
+        auto start = clock::now();
+        auto object = vsg::read(filename, options);
+        auto readTime = seconds(start);
+
+        if (!object)
+        {
+            std::cout << "Warning: file not read : " << filename << std::endl;
+            continue;
+        }
+
+        auto rssAfterRead = residentSetSize();
+        std::cout << "\nRead " << filename << " in " << readTime << " seconds, RSS increase " << (rssAfterRead - rssBefore) / 1024 << " KB" << std::endl;
+
+        if (touch)
+        {
+            start = clock::now();
+            TouchData touchData;
+            object->accept(touchData);
+            auto touchTime = seconds(start);
+
+            std::cout << "Touched " << touchData.numBytes << " bytes in " << touchTime << " seconds, RSS increase " << (residentSetSize() - rssBefore) / 1024 << " KB, checksum " << touchData.sum << std::endl;
+        }
+    }
+
+    return 0;
+}
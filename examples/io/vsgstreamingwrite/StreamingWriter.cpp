@@ -0,0 +1,69 @@
+#include "StreamingWriter.h"
+
+#include <fstream>
+
+using namespace streaming;
+
+void StreamedGroup::write(vsg::Output& output) const
+{
+    // matches vsg::Group::write(), generating each child as it's written and releasing it once it has been written
+    vsg::Node::write(output);
+
+    output.writeValue<uint32_t>("children", numChildren);
+    for (uint32_t i = 0; i < numChildren; ++i)
+    {
+        auto child = generator(i);
+        output.writeObject("vsg::Node", child.get());
+    }
+}
+
+StreamingOutput::StreamingOutput(std::ostream& output, vsg::ref_ptr<const vsg::Options> in_options) :
+    vsg::BinaryOutput(output, in_options)
+{
+}
+
+void StreamingOutput::write(const vsg::Object* object)
+{
+    bool newObject = object && objectIDMap.count(object) == 0;
+
+    vsg::BinaryOutput::write(object);
+
+    if (!newObject) return;
+
+    ++numObjectsWritten;
+
+    if (object->referenceCount() > 1)
+    {
+        sharedObjects.emplace_back(object);
+    }
+    else
+    {
+        // only one reference so it can't be written again, drop it from the mapping so the mapping doesn't grow with the scene graph
+        objectIDMap.erase(object);
+    }
+}
+
+bool StreamingVSG::write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    auto ext = vsg::lowerCaseFileExtension(filename);
+    if (ext != ".vsgb" || !object) return false;
+
+    // gather small writes in a large aligned buffer, writes larger than the buffer, such as Data payloads, go straight from the Data's storage to the file
+    std::vector<char> buffer(bufferSize + alignment);
+    auto offset = (alignment - reinterpret_cast<uintptr_t>(buffer.data()) % alignment) % alignment;
+
+    std::ofstream fout;
+    fout.rdbuf()->pubsetbuf(buffer.data() + offset, static_cast<std::streamsize>(bufferSize));
+    fout.open(filename, std::ios::out | std::ios::binary);
+    if (!fout) return false;
+
+    auto version = vsg::vsgGetVersion();
+    writeHeader(fout, FormatInfo(BINARY, version));
+
+    StreamingOutput output(fout, options);
+    output.version = version;
+    output.writeObject("Root", object);
+
+    fout.close();
+    return !fout.fail();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <functional>
+
+namespace streaming
+{
+
+    /// Group whose children are generated one at a time while it's being written, so a scene graph larger than memory can be written
+    /// without ever being held in memory as a whole. It's serialized as a vsg::Group, so the written file is read back with the standard loaders.
+    class StreamedGroup : public vsg::Inherit<vsg::Group, StreamedGroup>
+    {
+    public:
+        using Generator = std::function<vsg::ref_ptr<vsg::Node>(uint32_t index)>;
+
+        StreamedGroup(uint32_t in_numChildren, Generator in_generator) :
+            numChildren(in_numChildren),
+            generator(in_generator) {}
+
+        uint32_t numChildren = 0;
+        Generator generator;
+
+        const char* className() const noexcept override { return "vsg::Group"; }
+
+        void write(vsg::Output& output) const override;
+    };
+
+    /// ReaderWriter that writes the native binary format through a StreamingOutput, keeping the memory used for bookkeeping bounded
+    /// by the number of shared objects rather than the size of the scene graph.
+    class StreamingVSG : public vsg::Inherit<vsg::VSG, StreamingVSG>
+    {
+    public:
+        /// size of the output file buffer, aligned to alignment, that small objects are gathered in before being written.
+        size_t bufferSize = 4 * 1024 * 1024;
+        size_t alignment = 4096;
+
+        using vsg::VSG::write;
+        bool write(const vsg::Object* object, const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+    };
+
+    /// BinaryOutput that only keeps the object to ID mapping for objects with more than one reference, as those are the only ones that
+    /// can be written again. Objects that are kept in the mapping are also kept alive so their address can't be reused by a later object.
+    class StreamingOutput : public vsg::BinaryOutput
+    {
+    public:
+        StreamingOutput(std::ostream& output, vsg::ref_ptr<const vsg::Options> in_options);
+
+        using vsg::BinaryOutput::write;
+        void write(const vsg::Object* object) override;
+
+        std::vector<vsg::ref_ptr<const vsg::Object>> sharedObjects;
+        size_t numObjectsWritten = 0;
+    };
+
+} // namespace streaming
+
+EVSG_type_name(streaming::StreamingVSG);
@@ -0,0 +1,125 @@
+#include <vsg/all.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "StreamingWriter.h"
+
+// peak resident set size of the process in bytes, 0 where not supported.
+int64_t peakResidentSetSize()
+{
+#ifdef __linux__
+    std::ifstream fin("/proc/self/status");
+    std::string line;
+    while (std::getline(fin, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            int64_t kilobytes = 0;
+            std::istringstream str(line.substr(6));
+            str >> kilobytes;
+            return kilobytes * 1024;
+        }
+    }
+#endif
+    return 0;
+}
+
+// create a tile with its own vertex and normal arrays, sharing the index array between all tiles
+vsg::ref_ptr<vsg::Node> createTile(uint32_t index, uint32_t numTilesAcross, vsg::ref_ptr<vsg::uintArray> indices)
+{
+    std::mt19937 generator(index);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    auto numVertices = static_cast<uint32_t>(indices->size());
+    auto vertices = vsg::vec3Array::create(numVertices);
+    auto normals = vsg::vec3Array::create(numVertices);
+    for (uint32_t i = 0; i < numVertices; ++i)
+    {
+        vertices->at(i).set(distribution(generator), distribution(generator), distribution(generator));
+        normals->at(i) = vsg::normalize(vertices->at(i));
+    }
+
+    auto vid = vsg::VertexIndexDraw::create();
+    vid->assignArrays(vsg::DataList{vertices, normals});
+    vid->assignIndices(indices);
+    vid->indexCount = numVertices;
+    vid->instanceCount = 1;
+
+    auto transform = vsg::MatrixTransform::create(vsg::translate(static_cast<double>(index % numTilesAcross) * 2.0, static_cast<double>(index / numTilesAcross) * 2.0, 0.0));
+    transform->addChild(vid);
+    return transform;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto numTiles = arguments.value(1024u, "--tiles");
+    auto numVertices = arguments.value(100000u, "--vertices");
+    auto outputFilename = arguments.value<vsg::Path>("streaming_test.vsgb", "-o");
+    auto standard = arguments.read("--standard");
+    auto verify = arguments.read("--verify");
+
+    auto streamingVSG = streaming::StreamingVSG::create();
+    arguments.read("--buffer-size", streamingVSG->bufferSize);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    auto indices = vsg::uintArray::create(numVertices);
+    for (uint32_t i = 0; i < numVertices; ++i) indices->at(i) = i;
+
+    auto numTilesAcross = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(numTiles))));
+    auto generator = [&](uint32_t index) { return createTile(index, numTilesAcross, indices); };
+
+    using clock = std::chrono::high_resolution_clock;
+    auto seconds = [](clock::time_point start) { return std::chrono::duration<double>(clock::now() - start).count(); };
+
+    auto start = clock::now();
+    bool result = false;
+
+    if (standard)
+    {
+        // build the whole scene graph in memory and write it with vsg::write() for comparison
+        auto group = vsg::Group::create();
+        for (uint32_t i = 0; i < numTiles; ++i) group->addChild(generator(i));
+
+        std::cout << "Scene graph created in " << seconds(start) << " seconds." << std::endl;
+
+        result = vsg::write(group, outputFilename);
+    }
+    else
+    {
+        auto group = streaming::StreamedGroup::create(numTiles, generator);
+        result = streamingVSG->write(group, outputFilename);
+    }
+
+    auto writeTime = seconds(start);
+    if (!result)
+    {
+        std::cout << "Warning: unable to write " << outputFilename << std::endl;
+        return 1;
+    }
+
+    std::ifstream fin(outputFilename, std::ios::in | std::ios::binary | std::ios::ate);
+    auto fileSize = static_cast<double>(fin.tellg());
+
+    std::cout << (standard ? "vsg::write() " : "StreamingVSG::write() ") << outputFilename << " : " << fileSize / (1024.0 * 1024.0) << " MB in " << writeTime << " seconds, "
+              << fileSize / (1024.0 * 1024.0) / writeTime << " MB/s, peak RSS " << peakResidentSetSize() / (1024 * 1024) << " MB" << std::endl;
+
+    if (verify)
+    {
+        auto group = vsg::read_cast<vsg::Group>(outputFilename);
+        if (!group || group->children.size() != numTiles)
+        {
+            std::cout << "Warning: " << outputFilename << " didn't read back with " << numTiles << " tiles." << std::endl;
+            return 1;
+        }
+        std::cout << "Verified " << group->children.size() << " tiles read back." << std::endl;
+    }
+
+    return 0;
+}
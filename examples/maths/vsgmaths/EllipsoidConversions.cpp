@@ -0,0 +1,240 @@
+#include "EllipsoidConversions.h"
+
+#include <algorithm>
+
+using namespace simd;
+
+namespace
+{
+    constexpr double PI = 3.14159265358979323846;
+
+    //
+    // sin, cos and atan for lane types, using the fdlibm and Cephes minimax polynomials.
+    //
+    template<class L>
+    L floor(L value)
+    {
+        L rounded = round(value);
+        return select(rounded > value, rounded - L::set(1.0), rounded);
+    }
+
+    // valid for the |x| < 1e9 radians, far beyond latitude and longitude
+    template<class L>
+    void sincos(L x, L& s, L& c)
+    {
+        // reduce to r in [-pi/4, pi/4] about a multiple j of pi/2, with pi/2 split into two parts so j * pio2_1 is exact
+        L j = round(x * L::set(2.0 / PI));
+        L r = (x - j * L::set(1.57079632673412561417e+00)) - j * L::set(6.07710050650619224932e-11);
+        L z = r * r;
+
+        L sinR = r + r * z * (L::set(-1.66666666666666324348e-01) + z * (L::set(8.33333333332248946124e-03) + z * (L::set(-1.98412698298579493134e-04) + z * (L::set(2.75573137070700676789e-06) + z * (L::set(-2.50507602534068634195e-08) + z * L::set(1.58969099521155010221e-10))))));
+        L cosR = (L::set(1.0) - L::set(0.5) * z) + z * z * (L::set(4.16666666666666019037e-02) + z * (L::set(-1.38888888888741095749e-03) + z * (L::set(2.48015872894767294178e-05) + z * (L::set(-2.75573143513906633035e-07) + z * (L::set(2.08757232129817482790e-09) + z * L::set(-1.13596475577881948265e-11))))));
+
+        // quadrant 0..3
+        L quadrant = j - L::set(4.0) * floor(j * L::set(0.25));
+        L one = quadrant == L::set(1.0), two = quadrant == L::set(2.0), three = quadrant == L::set(3.0);
+
+        L swap = one | three;
+        L sinQ = select(swap, cosR, sinR);
+        L cosQ = select(swap, sinR, cosR);
+        s = select(two | three, -sinQ, sinQ);
+        c = select(one | two, -cosQ, cosQ);
+    }
+
+    template<class L>
+    L atan(L x)
+    {
+        const double MOREBITS = 6.123233995736765886130e-17;
+
+        L a = abs(x);
+        L large = a > L::set(2.41421356237309504880); // tan(3pi/8)
+        L medium = a > L::set(0.66);
+
+        L reduced = select(large, L::set(-1.0) / a, select(medium, (a - L::set(1.0)) / (a + L::set(1.0)), a));
+        L offset = select(large, L::set(PI * 0.5), select(medium, L::set(PI * 0.25), L::set(0.0)));
+        L moreBits = select(large, L::set(MOREBITS), select(medium, L::set(0.5 * MOREBITS), L::set(0.0)));
+
+        L z = reduced * reduced;
+        L p = (((L::set(-8.750608600031904122785e-01) * z + L::set(-1.615753718733365076637e+01)) * z + L::set(-7.500855792314704667340e+01)) * z + L::set(-1.228866684490136173410e+02)) * z + L::set(-6.485021904942025371773e+01);
+        L q = ((((z + L::set(2.485846490142306297962e+01)) * z + L::set(1.650270098316988542046e+02)) * z + L::set(4.328810604912902668951e+02)) * z + L::set(4.853903996359136964868e+02)) * z + L::set(1.945506571482613964425e+02);
+
+        L result = offset + ((reduced * (z * p / q) + reduced) + moreBits);
+        return select(x < L::set(0.0), -result, result);
+    }
+
+    // x == 0 passes +/-inf to atan() giving +/-pi/2, x == y == 0 is left to the caller
+    template<class L>
+    L atan2(L y, L x)
+    {
+        L t = atan(y / x);
+        return select(x < L::set(0.0), t + select(y < L::set(0.0), L::set(-PI), L::set(PI)), t);
+    }
+
+    struct Ellipsoid
+    {
+        const vsg::EllipsoidModel& model;
+        double a;   // equatorial radius
+        double b;   // polar radius
+        double e2;  // eccentricity squared
+        double ep2; // second eccentricity squared
+
+        explicit Ellipsoid(const vsg::EllipsoidModel& in_model) :
+            model(in_model),
+            a(model.radiusEquator()),
+            b(model.radiusPolar()),
+            e2((a * a - b * b) / (a * a)),
+            ep2((a * a - b * b) / (b * b))
+        {
+        }
+    };
+
+    template<class L>
+    void latLongAltitudeToECEF(const Ellipsoid& ellipsoid, const vsg::dvec3Array& input, vsg::dvec3Array& output)
+    {
+        using T = typename L::value_type;
+        constexpr size_t W = L::width;
+        const T toRadians = PI / 180.0;
+
+        size_t count = input.size();
+        size_t i = 0;
+        for (; (i + W) <= count; i += W)
+        {
+            T lanes[3][W];
+            for (size_t l = 0; l < W; ++l)
+            {
+                auto& lla = input[i + l];
+                lanes[0][l] = lla.x;
+                lanes[1][l] = lla.y;
+                lanes[2][l] = lla.z;
+            }
+
+            L sinLatitude, cosLatitude, sinLongitude, cosLongitude;
+            sincos(L::load(lanes[0]) * L::set(toRadians), sinLatitude, cosLatitude);
+            sincos(L::load(lanes[1]) * L::set(toRadians), sinLongitude, cosLongitude);
+            L height = L::load(lanes[2]);
+
+            L N = L::set(ellipsoid.a) / sqrt(L::set(1.0) - L::set(ellipsoid.e2) * sinLatitude * sinLatitude);
+            ((N + height) * cosLatitude * cosLongitude).store(lanes[0]);
+            ((N + height) * cosLatitude * sinLongitude).store(lanes[1]);
+            ((N * L::set(1.0 - ellipsoid.e2) + height) * sinLatitude).store(lanes[2]);
+
+            for (size_t l = 0; l < W; ++l)
+            {
+                output[i + l].set(lanes[0][l], lanes[1][l], lanes[2][l]);
+            }
+        }
+
+        for (; i < count; ++i) output[i] = ellipsoid.model.convertLatLongAltitudeToECEF(input[i]);
+    }
+
+    // Bowring's method iterated on the reduced latitude beta, keeping sin and cos as the unnormalized numerator and
+    // denominator of tan so there are no divisions by cos(latitude) near the poles, then one atan2 for the latitude.
+    template<class L>
+    void ecefToLatLongAltitude(const Ellipsoid& ellipsoid, const vsg::dvec3Array& input, vsg::dvec3Array& output, uint32_t iterations)
+    {
+        using T = typename L::value_type;
+        constexpr size_t W = L::width;
+        const T toDegrees = 180.0 / PI;
+
+        L a = L::set(ellipsoid.a), b = L::set(ellipsoid.b);
+        L e2a = L::set(ellipsoid.e2 * ellipsoid.a), ep2b = L::set(ellipsoid.ep2 * ellipsoid.b);
+
+        size_t count = input.size();
+        size_t i = 0;
+        for (; (i + W) <= count; i += W)
+        {
+            T lanes[3][W];
+            for (size_t l = 0; l < W; ++l)
+            {
+                auto& ecef = input[i + l];
+                lanes[0][l] = ecef.x;
+                lanes[1][l] = ecef.y;
+                lanes[2][l] = ecef.z;
+            }
+
+            L x = L::load(lanes[0]), y = L::load(lanes[1]), z = L::load(lanes[2]);
+            L p = sqrt(x * x + y * y);
+
+            L bp = b * p, az = a * z;
+            L r = sqrt(bp * bp + az * az);
+            L cosBeta = bp / r, sinBeta = az / r;
+
+            L numerator = z, denominator = p;
+            for (uint32_t iteration = 0;;)
+            {
+                numerator = z + ep2b * sinBeta * sinBeta * sinBeta;
+                denominator = p - e2a * cosBeta * cosBeta * cosBeta;
+                if (++iteration >= iterations) break;
+
+                // tan(beta) = (b/a) * tan(latitude)
+                L aDenominator = a * denominator, bNumerator = b * numerator;
+                r = sqrt(aDenominator * aDenominator + bNumerator * bNumerator);
+                cosBeta = aDenominator / r;
+                sinBeta = bNumerator / r;
+            }
+
+            L hypotenuse = sqrt(numerator * numerator + denominator * denominator);
+            L sinLatitude = numerator / hypotenuse, cosLatitude = denominator / hypotenuse;
+            L N = a / sqrt(L::set(1.0) - L::set(ellipsoid.e2) * sinLatitude * sinLatitude);
+
+            (atan2(numerator, denominator) * L::set(toDegrees)).store(lanes[0]);
+            (atan2(y, x) * L::set(toDegrees)).store(lanes[1]);
+            (p * cosLatitude + z * sinLatitude - a * a / N).store(lanes[2]);
+
+            for (size_t l = 0; l < W; ++l)
+            {
+                auto& ecef = input[i + l];
+                if (ecef.x == 0.0 && ecef.y == 0.0)
+                    output[i + l] = ellipsoid.model.convertECEFToLatLongAltitude(ecef); // on the polar axis
+                else
+                    output[i + l].set(lanes[0][l], lanes[1][l], lanes[2][l]);
+            }
+        }
+
+        for (; i < count; ++i) output[i] = ellipsoid.model.convertECEFToLatLongAltitude(input[i]);
+    }
+} // namespace
+
+vsg::ref_ptr<vsg::dvec3Array> simd::convertLatLongAltitudeToECEF(const vsg::EllipsoidModel& ellipsoidModel, const vsg::dvec3Array& latLongAltitudes, Kernel kernel)
+{
+    auto ecefs = vsg::dvec3Array::create(latLongAltitudes.size());
+    if (!supported(kernel)) kernel = SCALAR;
+
+    // the double lanes gain little from 256 bit registers once the gather/scatter is included, so AVX uses the SSE lanes
+    switch (kernel)
+    {
+#if defined(VSGMATHS_SSE)
+    case SSE:
+    case AVX: latLongAltitudeToECEF<SSEDouble>(Ellipsoid(ellipsoidModel), latLongAltitudes, *ecefs); break;
+#endif
+#if defined(VSGMATHS_NEON)
+    case NEON: latLongAltitudeToECEF<NEONDouble>(Ellipsoid(ellipsoidModel), latLongAltitudes, *ecefs); break;
+#endif
+    default:
+        for (size_t i = 0; i < latLongAltitudes.size(); ++i) (*ecefs)[i] = ellipsoidModel.convertLatLongAltitudeToECEF(latLongAltitudes[i]);
+        break;
+    }
+    return ecefs;
+}
+
+vsg::ref_ptr<vsg::dvec3Array> simd::convertECEFToLatLongAltitude(const vsg::EllipsoidModel& ellipsoidModel, const vsg::dvec3Array& ecefs, uint32_t iterations, Kernel kernel)
+{
+    auto latLongAltitudes = vsg::dvec3Array::create(ecefs.size());
+    if (!supported(kernel)) kernel = SCALAR;
+    iterations = std::max(iterations, 1u);
+
+    switch (kernel)
+    {
+#if defined(VSGMATHS_SSE)
+    case SSE:
+    case AVX: ecefToLatLongAltitude<SSEDouble>(Ellipsoid(ellipsoidModel), ecefs, *latLongAltitudes, iterations); break;
+#endif
+#if defined(VSGMATHS_NEON)
+    case NEON: ecefToLatLongAltitude<NEONDouble>(Ellipsoid(ellipsoidModel), ecefs, *latLongAltitudes, iterations); break;
+#endif
+    default:
+        for (size_t i = 0; i < ecefs.size(); ++i) (*latLongAltitudes)[i] = ellipsoidModel.convertECEFToLatLongAltitude(ecefs[i]);
+        break;
+    }
+    return latLongAltitudes;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vsg/app/EllipsoidModel.h>
+#include <vsg/core/Array.h>
+
+#include "SIMD.h"
+
+namespace simd
+{
+
+    // Array versions of EllipsoidModel::convertLatLongAltitudeToECEF() and convertECEFToLatLongAltitude() for GPS tracks and point clouds.
+    // The SIMD kernels use polynomial sin/cos/atan, one point per lane, the SCALAR kernel calls the EllipsoidModel methods.
+    // Latitude and longitude are in degrees, altitude in metres, as for the EllipsoidModel.
+
+    /// return a new array of the ECEF coordinates of each latitude, longitude, altitude
+    vsg::ref_ptr<vsg::dvec3Array> convertLatLongAltitudeToECEF(const vsg::EllipsoidModel& ellipsoidModel, const vsg::dvec3Array& latLongAltitudes, Kernel kernel = bestKernel());
+
+    /// return a new array of the latitude, longitude, altitude of each ECEF coordinate.
+    /// iterations bounds the refinements of Bowring's reduced latitude, 1 is Bowring's closed form as used by EllipsoidModel, 2 is accurate to well below a millimetre from the centre of the earth out to geostationary orbit.
+    vsg::ref_ptr<vsg::dvec3Array> convertECEFToLatLongAltitude(const vsg::EllipsoidModel& ellipsoidModel, const vsg::dvec3Array& ecefs, uint32_t iterations = 2, Kernel kernel = bestKernel());
+
+} // namespace simd
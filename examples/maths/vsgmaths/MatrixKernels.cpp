@@ -0,0 +1,521 @@
+#include "MatrixKernels.h"
+
+#include <algorithm>
+#include <type_traits>
+
+using namespace simd;
+
+namespace
+{
+    template<typename T>
+    void multiplyScalar(const T* lhs, const T* rhs, T* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) results[i] = lhs[i] * rhs[i];
+    }
+
+    template<typename M, typename V>
+    void transformScalar(const M& matrix, const V* points, V* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) results[i] = matrix * points[i];
+    }
+
+    template<typename M>
+    void inverseScalar(const M* matrices, M* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) results[i] = vsg::inverse(matrices[i]);
+    }
+
+    // the w component of the transformed point is divided out as the scalar template does, 1/w then multiplied
+    template<typename V, typename T>
+    V divideByW(const T* v)
+    {
+        T inv = static_cast<T>(1.0) / v[3];
+        return V(v[0] * inv, v[1] * inv, v[2] * inv);
+    }
+
+    // inverse via the 2x2 sub determinants of the upper and lower halves, as inverse(transpose(m)) == transpose(inverse(m))
+    // the elements can be named a[column][row] or a[row][column] as long as the results are stored the same way.
+    template<class L, typename M>
+    void inverseLanes(const M* matrices, M* results, size_t count)
+    {
+        using T = typename L::value_type;
+        constexpr size_t W = L::width;
+
+        size_t i = 0;
+        for (; (i + W) <= count; i += W)
+        {
+            T lanes[16][W];
+            for (size_t l = 0; l < W; ++l)
+            {
+                const T* ptr = matrices[i + l].data();
+                for (size_t e = 0; e < 16; ++e) lanes[e][l] = ptr[e];
+            }
+
+            L a00 = L::load(lanes[0]), a01 = L::load(lanes[1]), a02 = L::load(lanes[2]), a03 = L::load(lanes[3]);
+            L a10 = L::load(lanes[4]), a11 = L::load(lanes[5]), a12 = L::load(lanes[6]), a13 = L::load(lanes[7]);
+            L a20 = L::load(lanes[8]), a21 = L::load(lanes[9]), a22 = L::load(lanes[10]), a23 = L::load(lanes[11]);
+            L a30 = L::load(lanes[12]), a31 = L::load(lanes[13]), a32 = L::load(lanes[14]), a33 = L::load(lanes[15]);
+
+            L s0 = a00 * a11 - a10 * a01;
+            L s1 = a00 * a12 - a10 * a02;
+            L s2 = a00 * a13 - a10 * a03;
+            L s3 = a01 * a12 - a11 * a02;
+            L s4 = a01 * a13 - a11 * a03;
+            L s5 = a02 * a13 - a12 * a03;
+
+            L c5 = a22 * a33 - a32 * a23;
+            L c4 = a21 * a33 - a31 * a23;
+            L c3 = a21 * a32 - a31 * a22;
+            L c2 = a20 * a33 - a30 * a23;
+            L c1 = a20 * a32 - a30 * a22;
+            L c0 = a20 * a31 - a30 * a21;
+
+            L det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            L invDet = L::set(1) / det;
+
+            (((a11 * c5 - a12 * c4) + a13 * c3) * invDet).store(lanes[0]);
+            (((a02 * c4 - a01 * c5) - a03 * c3) * invDet).store(lanes[1]);
+            (((a31 * s5 - a32 * s4) + a33 * s3) * invDet).store(lanes[2]);
+            (((a22 * s4 - a21 * s5) - a23 * s3) * invDet).store(lanes[3]);
+
+            (((a12 * c2 - a10 * c5) - a13 * c1) * invDet).store(lanes[4]);
+            (((a00 * c5 - a02 * c2) + a03 * c1) * invDet).store(lanes[5]);
+            (((a32 * s2 - a30 * s5) - a33 * s1) * invDet).store(lanes[6]);
+            (((a20 * s5 - a22 * s2) + a23 * s1) * invDet).store(lanes[7]);
+
+            (((a10 * c4 - a11 * c2) + a13 * c0) * invDet).store(lanes[8]);
+            (((a01 * c2 - a00 * c4) - a03 * c0) * invDet).store(lanes[9]);
+            (((a30 * s4 - a31 * s2) + a33 * s0) * invDet).store(lanes[10]);
+            (((a21 * s2 - a20 * s4) - a23 * s0) * invDet).store(lanes[11]);
+
+            (((a11 * c1 - a10 * c3) - a12 * c0) * invDet).store(lanes[12]);
+            (((a00 * c3 - a01 * c1) + a02 * c0) * invDet).store(lanes[13]);
+            (((a31 * s1 - a30 * s3) - a32 * s0) * invDet).store(lanes[14]);
+            (((a20 * s3 - a21 * s1) + a22 * s0) * invDet).store(lanes[15]);
+
+            T determinants[W];
+            det.store(determinants);
+
+            for (size_t l = 0; l < W; ++l)
+            {
+                if (determinants[l] == static_cast<T>(0))
+                {
+                    results[i + l] = vsg::inverse(matrices[i + l]);
+                    continue;
+                }
+
+                T* ptr = results[i + l].data();
+                for (size_t e = 0; e < 16; ++e) ptr[e] = lanes[e][l];
+            }
+        }
+
+        inverseScalar(matrices + i, results + i, count - i);
+    }
+
+    template<class L, typename Q>
+    void multiplyQuatLanes(const Q* lhs, const Q* rhs, Q* results, size_t count)
+    {
+        using T = typename L::value_type;
+        constexpr size_t W = L::width;
+
+        size_t i = 0;
+        for (; (i + W) <= count; i += W)
+        {
+            T lanes[8][W];
+            for (size_t l = 0; l < W; ++l)
+            {
+                for (size_t e = 0; e < 4; ++e)
+                {
+                    lanes[e][l] = lhs[i + l][e];
+                    lanes[4 + e][l] = rhs[i + l][e];
+                }
+            }
+
+            L lx = L::load(lanes[0]), ly = L::load(lanes[1]), lz = L::load(lanes[2]), lw = L::load(lanes[3]);
+            L rx = L::load(lanes[4]), ry = L::load(lanes[5]), rz = L::load(lanes[6]), rw = L::load(lanes[7]);
+
+            // vector part cross(lv, rv) + lv * rw + rv * lw, scalar part lw * rw - dot(lv, rv)
+            ((ly * rz - lz * ry) + lx * rw + rx * lw).store(lanes[0]);
+            ((lz * rx - lx * rz) + ly * rw + ry * lw).store(lanes[1]);
+            ((lx * ry - ly * rx) + lz * rw + rz * lw).store(lanes[2]);
+            (lw * rw - (lx * rx + ly * ry + lz * rz)).store(lanes[3]);
+
+            for (size_t l = 0; l < W; ++l)
+            {
+                results[i + l].set(lanes[0][l], lanes[1][l], lanes[2][l], lanes[3][l]);
+            }
+        }
+
+        multiplyScalar(lhs + i, rhs + i, results + i, count - i);
+    }
+
+    //
+    // mat4 multiply, each column of the result is the lhs columns scaled by the rhs column's elements and summed in order.
+    //
+#if defined(VSGMATHS_SSE)
+    void multiplySSE(const vsg::mat4* lhs, const vsg::mat4* rhs, vsg::mat4* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* l = lhs[i].data();
+            const float* r = rhs[i].data();
+            float* out = results[i].data();
+
+            __m128 l0 = _mm_loadu_ps(l), l1 = _mm_loadu_ps(l + 4), l2 = _mm_loadu_ps(l + 8), l3 = _mm_loadu_ps(l + 12);
+            for (size_t c = 0; c < 4; ++c)
+            {
+                const float* rc = r + c * 4;
+                __m128 column = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, _mm_set1_ps(rc[0])), _mm_mul_ps(l1, _mm_set1_ps(rc[1]))), _mm_mul_ps(l2, _mm_set1_ps(rc[2]))), _mm_mul_ps(l3, _mm_set1_ps(rc[3])));
+                _mm_storeu_ps(out + c * 4, column);
+            }
+        }
+    }
+
+    void multiplySSE(const vsg::dmat4* lhs, const vsg::dmat4* rhs, vsg::dmat4* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double* l = lhs[i].data();
+            const double* r = rhs[i].data();
+            double* out = results[i].data();
+
+            // each column is split into xy and zw halves
+            for (size_t half = 0; half < 4; half += 2)
+            {
+                __m128d l0 = _mm_loadu_pd(l + half), l1 = _mm_loadu_pd(l + 4 + half), l2 = _mm_loadu_pd(l + 8 + half), l3 = _mm_loadu_pd(l + 12 + half);
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    const double* rc = r + c * 4;
+                    __m128d column = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(l0, _mm_set1_pd(rc[0])), _mm_mul_pd(l1, _mm_set1_pd(rc[1]))), _mm_mul_pd(l2, _mm_set1_pd(rc[2]))), _mm_mul_pd(l3, _mm_set1_pd(rc[3])));
+                    _mm_storeu_pd(out + c * 4 + half, column);
+                }
+            }
+        }
+    }
+
+    void transformSSE(const vsg::mat4& matrix, const vsg::vec3* points, vsg::vec3* results, size_t count)
+    {
+        const float* m = matrix.data();
+        __m128 m0 = _mm_loadu_ps(m), m1 = _mm_loadu_ps(m + 4), m2 = _mm_loadu_ps(m + 8), m3 = _mm_loadu_ps(m + 12);
+        float v[4];
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto& p = points[i];
+            _mm_storeu_ps(v, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, _mm_set1_ps(p.x)), _mm_mul_ps(m1, _mm_set1_ps(p.y))), _mm_mul_ps(m2, _mm_set1_ps(p.z))), m3));
+            results[i] = divideByW<vsg::vec3>(v);
+        }
+    }
+
+    void transformSSE(const vsg::dmat4& matrix, const vsg::dvec3* points, vsg::dvec3* results, size_t count)
+    {
+        const double* m = matrix.data();
+        __m128d m0xy = _mm_loadu_pd(m), m1xy = _mm_loadu_pd(m + 4), m2xy = _mm_loadu_pd(m + 8), m3xy = _mm_loadu_pd(m + 12);
+        __m128d m0zw = _mm_loadu_pd(m + 2), m1zw = _mm_loadu_pd(m + 6), m2zw = _mm_loadu_pd(m + 10), m3zw = _mm_loadu_pd(m + 14);
+        double v[4];
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto& p = points[i];
+            __m128d x = _mm_set1_pd(p.x), y = _mm_set1_pd(p.y), z = _mm_set1_pd(p.z);
+            _mm_storeu_pd(v, _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(m0xy, x), _mm_mul_pd(m1xy, y)), _mm_mul_pd(m2xy, z)), m3xy));
+            _mm_storeu_pd(v + 2, _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(m0zw, x), _mm_mul_pd(m1zw, y)), _mm_mul_pd(m2zw, z)), m3zw));
+            results[i] = divideByW<vsg::dvec3>(v);
+        }
+    }
+#endif
+
+#if defined(VSGMATHS_AVX)
+    // two result columns per 256 bit register
+    VSGMATHS_AVX_TARGET void multiplyAVX(const vsg::mat4* lhs, const vsg::mat4* rhs, vsg::mat4* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* l = lhs[i].data();
+            const float* r = rhs[i].data();
+            float* out = results[i].data();
+
+            __m256 l0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l));
+            __m256 l1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 4));
+            __m256 l2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 8));
+            __m256 l3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 12));
+            for (size_t c = 0; c < 4; c += 2)
+            {
+                const float* ra = r + c * 4;
+                const float* rb = ra + 4;
+                __m256 r0 = _mm256_setr_ps(ra[0], ra[0], ra[0], ra[0], rb[0], rb[0], rb[0], rb[0]);
+                __m256 r1 = _mm256_setr_ps(ra[1], ra[1], ra[1], ra[1], rb[1], rb[1], rb[1], rb[1]);
+                __m256 r2 = _mm256_setr_ps(ra[2], ra[2], ra[2], ra[2], rb[2], rb[2], rb[2], rb[2]);
+                __m256 r3 = _mm256_setr_ps(ra[3], ra[3], ra[3], ra[3], rb[3], rb[3], rb[3], rb[3]);
+                __m256 columns = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(l0, r0), _mm256_mul_ps(l1, r1)), _mm256_mul_ps(l2, r2)), _mm256_mul_ps(l3, r3));
+                _mm256_storeu_ps(out + c * 4, columns);
+            }
+        }
+    }
+
+    VSGMATHS_AVX_TARGET void multiplyAVX(const vsg::dmat4* lhs, const vsg::dmat4* rhs, vsg::dmat4* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double* l = lhs[i].data();
+            const double* r = rhs[i].data();
+            double* out = results[i].data();
+
+            __m256d l0 = _mm256_loadu_pd(l), l1 = _mm256_loadu_pd(l + 4), l2 = _mm256_loadu_pd(l + 8), l3 = _mm256_loadu_pd(l + 12);
+            for (size_t c = 0; c < 4; ++c)
+            {
+                const double* rc = r + c * 4;
+                __m256d column = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(l0, _mm256_broadcast_sd(rc)), _mm256_mul_pd(l1, _mm256_broadcast_sd(rc + 1))), _mm256_mul_pd(l2, _mm256_broadcast_sd(rc + 2))), _mm256_mul_pd(l3, _mm256_broadcast_sd(rc + 3)));
+                _mm256_storeu_pd(out + c * 4, column);
+            }
+        }
+    }
+
+    // two points per 256 bit register
+    VSGMATHS_AVX_TARGET void transformAVX(const vsg::mat4& matrix, const vsg::vec3* points, vsg::vec3* results, size_t count)
+    {
+        const float* m = matrix.data();
+        __m256 m0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+        __m256 m1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+        __m256 m2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+        __m256 m3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+        float v[8];
+        size_t i = 0;
+        for (; (i + 2) <= count; i += 2)
+        {
+            auto& a = points[i];
+            auto& b = points[i + 1];
+            __m256 x = _mm256_setr_ps(a.x, a.x, a.x, a.x, b.x, b.x, b.x, b.x);
+            __m256 y = _mm256_setr_ps(a.y, a.y, a.y, a.y, b.y, b.y, b.y, b.y);
+            __m256 z = _mm256_setr_ps(a.z, a.z, a.z, a.z, b.z, b.z, b.z, b.z);
+            _mm256_storeu_ps(v, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, x), _mm256_mul_ps(m1, y)), _mm256_mul_ps(m2, z)), m3));
+            results[i] = divideByW<vsg::vec3>(v);
+            results[i + 1] = divideByW<vsg::vec3>(v + 4);
+        }
+        transformScalar(matrix, points + i, results + i, count - i);
+    }
+
+    VSGMATHS_AVX_TARGET void transformAVX(const vsg::dmat4& matrix, const vsg::dvec3* points, vsg::dvec3* results, size_t count)
+    {
+        const double* m = matrix.data();
+        __m256d m0 = _mm256_loadu_pd(m), m1 = _mm256_loadu_pd(m + 4), m2 = _mm256_loadu_pd(m + 8), m3 = _mm256_loadu_pd(m + 12);
+        double v[4];
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto& p = points[i];
+            _mm256_storeu_pd(v, _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m0, _mm256_set1_pd(p.x)), _mm256_mul_pd(m1, _mm256_set1_pd(p.y))), _mm256_mul_pd(m2, _mm256_set1_pd(p.z))), m3));
+            results[i] = divideByW<vsg::dvec3>(v);
+        }
+    }
+#endif
+
+#if defined(VSGMATHS_NEON)
+    void multiplyNEON(const vsg::mat4* lhs, const vsg::mat4* rhs, vsg::mat4* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* l = lhs[i].data();
+            const float* r = rhs[i].data();
+            float* out = results[i].data();
+
+            float32x4_t l0 = vld1q_f32(l), l1 = vld1q_f32(l + 4), l2 = vld1q_f32(l + 8), l3 = vld1q_f32(l + 12);
+            for (size_t c = 0; c < 4; ++c)
+            {
+                const float* rc = r + c * 4;
+                vst1q_f32(out + c * 4, vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(l0, rc[0]), vmulq_n_f32(l1, rc[1])), vmulq_n_f32(l2, rc[2])), vmulq_n_f32(l3, rc[3])));
+            }
+        }
+    }
+
+    void multiplyNEON(const vsg::dmat4* lhs, const vsg::dmat4* rhs, vsg::dmat4* results, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double* l = lhs[i].data();
+            const double* r = rhs[i].data();
+            double* out = results[i].data();
+
+            for (size_t half = 0; half < 4; half += 2)
+            {
+                float64x2_t l0 = vld1q_f64(l + half), l1 = vld1q_f64(l + 4 + half), l2 = vld1q_f64(l + 8 + half), l3 = vld1q_f64(l + 12 + half);
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    const double* rc = r + c * 4;
+                    vst1q_f64(out + c * 4 + half, vaddq_f64(vaddq_f64(vaddq_f64(vmulq_n_f64(l0, rc[0]), vmulq_n_f64(l1, rc[1])), vmulq_n_f64(l2, rc[2])), vmulq_n_f64(l3, rc[3])));
+                }
+            }
+        }
+    }
+
+    void transformNEON(const vsg::mat4& matrix, const vsg::vec3* points, vsg::vec3* results, size_t count)
+    {
+        const float* m = matrix.data();
+        float32x4_t m0 = vld1q_f32(m), m1 = vld1q_f32(m + 4), m2 = vld1q_f32(m + 8), m3 = vld1q_f32(m + 12);
+        float v[4];
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto& p = points[i];
+            vst1q_f32(v, vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(m0, p.x), vmulq_n_f32(m1, p.y)), vmulq_n_f32(m2, p.z)), m3));
+            results[i] = divideByW<vsg::vec3>(v);
+        }
+    }
+
+    void transformNEON(const vsg::dmat4& matrix, const vsg::dvec3* points, vsg::dvec3* results, size_t count)
+    {
+        const double* m = matrix.data();
+        float64x2_t m0xy = vld1q_f64(m), m1xy = vld1q_f64(m + 4), m2xy = vld1q_f64(m + 8), m3xy = vld1q_f64(m + 12);
+        float64x2_t m0zw = vld1q_f64(m + 2), m1zw = vld1q_f64(m + 6), m2zw = vld1q_f64(m + 10), m3zw = vld1q_f64(m + 14);
+        double v[4];
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto& p = points[i];
+            vst1q_f64(v, vaddq_f64(vaddq_f64(vaddq_f64(vmulq_n_f64(m0xy, p.x), vmulq_n_f64(m1xy, p.y)), vmulq_n_f64(m2xy, p.z)), m3xy));
+            vst1q_f64(v + 2, vaddq_f64(vaddq_f64(vaddq_f64(vmulq_n_f64(m0zw, p.x), vmulq_n_f64(m1zw, p.y)), vmulq_n_f64(m2zw, p.z)), m3zw));
+            results[i] = divideByW<vsg::dvec3>(v);
+        }
+    }
+#endif
+
+    template<typename M>
+    void multiplyMatrices(const std::vector<M>& lhs, const std::vector<M>& rhs, std::vector<M>& results, Kernel kernel)
+    {
+        size_t count = std::min(lhs.size(), rhs.size());
+        results.resize(count);
+        if (!supported(kernel)) kernel = SCALAR;
+
+        switch (kernel)
+        {
+#if defined(VSGMATHS_SSE)
+        case SSE: multiplySSE(lhs.data(), rhs.data(), results.data(), count); break;
+#endif
+#if defined(VSGMATHS_AVX)
+        case AVX: multiplyAVX(lhs.data(), rhs.data(), results.data(), count); break;
+#endif
+#if defined(VSGMATHS_NEON)
+        case NEON: multiplyNEON(lhs.data(), rhs.data(), results.data(), count); break;
+#endif
+        default: multiplyScalar(lhs.data(), rhs.data(), results.data(), count); break;
+        }
+    }
+
+    template<typename M, typename V>
+    void transformPoints(const M& matrix, const std::vector<V>& points, std::vector<V>& results, Kernel kernel)
+    {
+        results.resize(points.size());
+        if (!supported(kernel)) kernel = SCALAR;
+
+        switch (kernel)
+        {
+#if defined(VSGMATHS_SSE)
+        case SSE: transformSSE(matrix, points.data(), results.data(), points.size()); break;
+#endif
+#if defined(VSGMATHS_AVX)
+        case AVX: transformAVX(matrix, points.data(), results.data(), points.size()); break;
+#endif
+#if defined(VSGMATHS_NEON)
+        case NEON: transformNEON(matrix, points.data(), results.data(), points.size()); break;
+#endif
+        default: transformScalar(matrix, points.data(), results.data(), points.size()); break;
+        }
+    }
+
+    // the lane kernels gain little from 256 bit registers once the gather/scatter is included, so AVX uses the SSE lanes
+    template<typename M>
+    void inverseMatrices(const std::vector<M>& matrices, std::vector<M>& results, Kernel kernel)
+    {
+        using T = typename M::value_type;
+        results.resize(matrices.size());
+        if (!supported(kernel)) kernel = SCALAR;
+
+        switch (kernel)
+        {
+#if defined(VSGMATHS_SSE)
+        case SSE:
+        case AVX:
+            if constexpr (std::is_same_v<T, float>)
+                inverseLanes<SSEFloat>(matrices.data(), results.data(), matrices.size());
+            else
+                inverseLanes<SSEDouble>(matrices.data(), results.data(), matrices.size());
+            break;
+#endif
+#if defined(VSGMATHS_NEON)
+        case NEON:
+            if constexpr (std::is_same_v<T, float>)
+                inverseLanes<NEONFloat>(matrices.data(), results.data(), matrices.size());
+            else
+                inverseLanes<NEONDouble>(matrices.data(), results.data(), matrices.size());
+            break;
+#endif
+        default: inverseScalar(matrices.data(), results.data(), matrices.size()); break;
+        }
+    }
+
+    template<typename Q>
+    void multiplyQuats(const std::vector<Q>& lhs, const std::vector<Q>& rhs, std::vector<Q>& results, Kernel kernel)
+    {
+        using T = typename Q::value_type;
+        size_t count = std::min(lhs.size(), rhs.size());
+        results.resize(count);
+        if (!supported(kernel)) kernel = SCALAR;
+
+        switch (kernel)
+        {
+#if defined(VSGMATHS_SSE)
+        case SSE:
+        case AVX:
+            if constexpr (std::is_same_v<T, float>)
+                multiplyQuatLanes<SSEFloat>(lhs.data(), rhs.data(), results.data(), count);
+            else
+                multiplyQuatLanes<SSEDouble>(lhs.data(), rhs.data(), results.data(), count);
+            break;
+#endif
+#if defined(VSGMATHS_NEON)
+        case NEON:
+            if constexpr (std::is_same_v<T, float>)
+                multiplyQuatLanes<NEONFloat>(lhs.data(), rhs.data(), results.data(), count);
+            else
+                multiplyQuatLanes<NEONDouble>(lhs.data(), rhs.data(), results.data(), count);
+            break;
+#endif
+        default: multiplyScalar(lhs.data(), rhs.data(), results.data(), count); break;
+        }
+    }
+} // namespace
+
+void simd::multiply(const std::vector<vsg::mat4>& lhs, const std::vector<vsg::mat4>& rhs, std::vector<vsg::mat4>& results, Kernel kernel)
+{
+    multiplyMatrices(lhs, rhs, results, kernel);
+}
+
+void simd::multiply(const std::vector<vsg::dmat4>& lhs, const std::vector<vsg::dmat4>& rhs, std::vector<vsg::dmat4>& results, Kernel kernel)
+{
+    multiplyMatrices(lhs, rhs, results, kernel);
+}
+
+void simd::transform(const vsg::mat4& matrix, const std::vector<vsg::vec3>& points, std::vector<vsg::vec3>& results, Kernel kernel)
+{
+    transformPoints(matrix, points, results, kernel);
+}
+
+void simd::transform(const vsg::dmat4& matrix, const std::vector<vsg::dvec3>& points, std::vector<vsg::dvec3>& results, Kernel kernel)
+{
+    transformPoints(matrix, points, results, kernel);
+}
+
+void simd::inverse(const std::vector<vsg::mat4>& matrices, std::vector<vsg::mat4>& results, Kernel kernel)
+{
+    inverseMatrices(matrices, results, kernel);
+}
+
+void simd::inverse(const std::vector<vsg::dmat4>& matrices, std::vector<vsg::dmat4>& results, Kernel kernel)
+{
+    inverseMatrices(matrices, results, kernel);
+}
+
+void simd::multiply(const std::vector<vsg::quat>& lhs, const std::vector<vsg::quat>& rhs, std::vector<vsg::quat>& results, Kernel kernel)
+{
+    multiplyQuats(lhs, rhs, results, kernel);
+}
+
+void simd::multiply(const std::vector<vsg::dquat>& lhs, const std::vector<vsg::dquat>& rhs, std::vector<vsg::dquat>& results, Kernel kernel)
+{
+    multiplyQuats(lhs, rhs, results, kernel);
+}
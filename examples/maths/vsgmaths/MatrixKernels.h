@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vsg/maths/mat4.h>
+#include <vsg/maths/quat.h>
+#include <vsg/maths/vec3.h>
+
+#include <vector>
+
+#include "SIMD.h"
+
+namespace simd
+{
+
+    // Batched versions of the vsg::t_mat4<> and vsg::t_quat<> operators used in transform accumulation and animation sampling.
+    // results are resized to match the inputs. The SCALAR kernel calls the vsg operators directly, the SIMD kernels of
+    // multiply() and transform() evaluate the products and sums in the same order as the vsg templates so give identical results.
+
+    /// results[i] = lhs[i] * rhs[i]
+    void multiply(const std::vector<vsg::mat4>& lhs, const std::vector<vsg::mat4>& rhs, std::vector<vsg::mat4>& results, Kernel kernel = bestKernel());
+    void multiply(const std::vector<vsg::dmat4>& lhs, const std::vector<vsg::dmat4>& rhs, std::vector<vsg::dmat4>& results, Kernel kernel = bestKernel());
+
+    /// results[i] = matrix * points[i], including the divide by w
+    void transform(const vsg::mat4& matrix, const std::vector<vsg::vec3>& points, std::vector<vsg::vec3>& results, Kernel kernel = bestKernel());
+    void transform(const vsg::dmat4& matrix, const std::vector<vsg::dvec3>& points, std::vector<vsg::dvec3>& results, Kernel kernel = bestKernel());
+
+    /// results[i] = vsg::inverse(matrices[i]), computed with cofactors for several matrices at once, one matrix per SIMD lane.
+    /// Rounding differs from vsg::inverse so results match to within precision rather than exactly; singular matrices are passed to vsg::inverse.
+    void inverse(const std::vector<vsg::mat4>& matrices, std::vector<vsg::mat4>& results, Kernel kernel = bestKernel());
+    void inverse(const std::vector<vsg::dmat4>& matrices, std::vector<vsg::dmat4>& results, Kernel kernel = bestKernel());
+
+    /// results[i] = lhs[i] * rhs[i], one quaternion per SIMD lane
+    void multiply(const std::vector<vsg::quat>& lhs, const std::vector<vsg::quat>& rhs, std::vector<vsg::quat>& results, Kernel kernel = bestKernel());
+    void multiply(const std::vector<vsg::dquat>& lhs, const std::vector<vsg::dquat>& rhs, std::vector<vsg::dquat>& results, Kernel kernel = bestKernel());
+
+} // namespace simd
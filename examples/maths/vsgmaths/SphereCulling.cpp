@@ -0,0 +1,169 @@
+#include "SphereCulling.h"
+
+#include <bitset>
+
+using namespace simd;
+
+namespace
+{
+    using Polytope = std::vector<vsg::plane>;
+
+    // the distance expression is evaluated in the same order as vsg::distance(plane, center) so every kernel gives identical results
+    uint8_t intersectScalar(const Polytope& polytope, const SphereArray& spheres, size_t first, size_t count)
+    {
+        uint8_t bits = 0;
+        for (size_t lane = 0; lane < count; ++lane)
+        {
+            size_t i = first + lane;
+            float negativeRadius = -spheres.radius[i];
+            bool visible = true;
+            for (auto& plane : polytope)
+            {
+                if (plane.n.x * spheres.x[i] + plane.n.y * spheres.y[i] + plane.n.z * spheres.z[i] + plane.p < negativeRadius)
+                {
+                    visible = false;
+                    break;
+                }
+            }
+            if (visible) bits |= static_cast<uint8_t>(1 << lane);
+        }
+        return bits;
+    }
+
+#if defined(VSGMATHS_SSE)
+    void intersectSSE(const Polytope& polytope, const SphereArray& spheres, uint8_t* mask, size_t numBlocks)
+    {
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            int bits = 0;
+            for (size_t half = 0; half < 2; ++half)
+            {
+                size_t i = block * 8 + half * 4;
+                __m128 x = _mm_loadu_ps(&spheres.x[i]);
+                __m128 y = _mm_loadu_ps(&spheres.y[i]);
+                __m128 z = _mm_loadu_ps(&spheres.z[i]);
+                __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+
+                __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (auto& plane : polytope)
+                {
+                    __m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.n.x), x), _mm_mul_ps(_mm_set1_ps(plane.n.y), y)), _mm_mul_ps(_mm_set1_ps(plane.n.z), z)), _mm_set1_ps(plane.p));
+                    visible = _mm_and_ps(visible, _mm_cmpge_ps(d, negativeRadius));
+                    if (_mm_movemask_ps(visible) == 0) break;
+                }
+                bits |= _mm_movemask_ps(visible) << (half * 4);
+            }
+            mask[block] = static_cast<uint8_t>(bits);
+        }
+    }
+#endif
+
+#if defined(VSGMATHS_AVX)
+    VSGMATHS_AVX_TARGET void intersectAVX(const Polytope& polytope, const SphereArray& spheres, uint8_t* mask, size_t numBlocks)
+    {
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            size_t i = block * 8;
+            __m256 x = _mm256_loadu_ps(&spheres.x[i]);
+            __m256 y = _mm256_loadu_ps(&spheres.y[i]);
+            __m256 z = _mm256_loadu_ps(&spheres.z[i]);
+            __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&spheres.radius[i]));
+
+            __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (auto& plane : polytope)
+            {
+                __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_broadcast_ss(&plane.n.x), x), _mm256_mul_ps(_mm256_broadcast_ss(&plane.n.y), y)), _mm256_mul_ps(_mm256_broadcast_ss(&plane.n.z), z)), _mm256_broadcast_ss(&plane.p));
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(d, negativeRadius, _CMP_GE_OQ));
+                if (_mm256_movemask_ps(visible) == 0) break;
+            }
+            mask[block] = static_cast<uint8_t>(_mm256_movemask_ps(visible));
+        }
+    }
+#endif
+
+#if defined(VSGMATHS_NEON)
+    void intersectNEON(const Polytope& polytope, const SphereArray& spheres, uint8_t* mask, size_t numBlocks)
+    {
+        const uint32_t laneBitValues[4] = {1, 2, 4, 8};
+        uint32x4_t laneBits = vld1q_u32(laneBitValues);
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            uint32_t bits = 0;
+            for (size_t half = 0; half < 2; ++half)
+            {
+                size_t i = block * 8 + half * 4;
+                float32x4_t x = vld1q_f32(&spheres.x[i]);
+                float32x4_t y = vld1q_f32(&spheres.y[i]);
+                float32x4_t z = vld1q_f32(&spheres.z[i]);
+                float32x4_t negativeRadius = vnegq_f32(vld1q_f32(&spheres.radius[i]));
+
+                uint32x4_t visible = vdupq_n_u32(~0u);
+                for (auto& plane : polytope)
+                {
+                    float32x4_t d = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(x, plane.n.x), vmulq_n_f32(y, plane.n.y)), vmulq_n_f32(z, plane.n.z)), vdupq_n_f32(plane.p));
+                    visible = vandq_u32(visible, vcgeq_f32(d, negativeRadius));
+                    if (vmaxvq_u32(visible) == 0) break;
+                }
+                bits |= vaddvq_u32(vandq_u32(visible, laneBits)) << (half * 4);
+            }
+            mask[block] = static_cast<uint8_t>(bits);
+        }
+    }
+#endif
+} // namespace
+
+void SphereArray::reserve(size_t n)
+{
+    x.reserve(n);
+    y.reserve(n);
+    z.reserve(n);
+    radius.reserve(n);
+}
+
+void SphereArray::clear()
+{
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
+void SphereArray::add(const vsg::sphere& sphere)
+{
+    x.push_back(sphere.center.x);
+    y.push_back(sphere.center.y);
+    z.push_back(sphere.center.z);
+    radius.push_back(sphere.radius);
+}
+
+size_t simd::intersect(const std::vector<vsg::plane>& polytope, const SphereArray& spheres, std::vector<uint8_t>& mask, Kernel kernel)
+{
+    size_t numSpheres = spheres.size();
+    size_t numBlocks = numSpheres / 8;
+    mask.assign((numSpheres + 7) / 8, 0);
+
+    if (!supported(kernel)) kernel = SCALAR;
+
+    switch (kernel)
+    {
+#if defined(VSGMATHS_SSE)
+    case SSE: intersectSSE(polytope, spheres, mask.data(), numBlocks); break;
+#endif
+#if defined(VSGMATHS_AVX)
+    case AVX: intersectAVX(polytope, spheres, mask.data(), numBlocks); break;
+#endif
+#if defined(VSGMATHS_NEON)
+    case NEON: intersectNEON(polytope, spheres, mask.data(), numBlocks); break;
+#endif
+    default:
+        for (size_t block = 0; block < numBlocks; ++block) mask[block] = intersectScalar(polytope, spheres, block * 8, 8);
+        break;
+    }
+
+    // spheres that don't fill a whole block
+    if (numSpheres > numBlocks * 8) mask[numBlocks] = intersectScalar(polytope, spheres, numBlocks * 8, numSpheres - numBlocks * 8);
+
+    size_t numVisible = 0;
+    for (auto bits : mask) numVisible += std::bitset<8>(bits).count();
+    return numVisible;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vsg/maths/plane.h>
+#include <vsg/maths/sphere.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "SIMD.h"
+
+namespace simd
+{
+
+    /// bounding spheres held as structure of arrays so that a SIMD register of centres or radii can be loaded at once.
+    struct SphereArray
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+
+        size_t size() const { return radius.size(); }
+
+        void reserve(size_t n);
+        void clear();
+        void add(const vsg::sphere& sphere);
+    };
+
+    /// test every sphere against the polytope with the same result as vsg::intersect(polytope, sphere), setting bit i % 8 of mask[i / 8]
+    /// when sphere i is inside or intersects the polytope. The planes are expected to point inwards and be normalized. Return the number of spheres visible.
+    size_t intersect(const std::vector<vsg::plane>& polytope, const SphereArray& spheres, std::vector<uint8_t>& mask, Kernel kernel = bestKernel());
+
+    /// return true if bit i of the mask returned by intersect() is set.
+    inline bool visible(const std::vector<uint8_t>& mask, size_t i) { return (mask[i / 8] >> (i % 8)) & 1; }
+
+} // namespace simd
@@ -6,18 +6,27 @@
 
 #include <vsg/maths/mat4.h>
 #include <vsg/maths/plane.h>
+#include <vsg/maths/quat.h>
 #include <vsg/maths/transform.h>
 #include <vsg/maths/vec2.h>
 #include <vsg/maths/vec3.h>
 #include <vsg/maths/vec4.h>
 
 #include <vsg/io/stream.h>
+#include <vsg/utils/CommandLine.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <random>
 #include <vector>
 
+#include "EllipsoidConversions.h"
+#include "MatrixKernels.h"
+#include "SphereCulling.h"
+
 template<class M>
 bool test_inverse(const M& m)
 {
@@ -40,8 +49,293 @@ bool test_inverse(const M& m)
     return true;
 }
 
-int main(int /*argc*/, char** /*argv*/)
+// time vsg::intersect(polytope, sphere) one sphere at a time against the scalar and SIMD bulk culling kernels, for 1K to 1M spheres,
+// returning false if any kernel's visibility differs from vsg::intersect
+bool benchmarkSphereCulling(double targetSphereTests)
+{
+    // view frustum planes, transformed from clip space into world space and normalized
+    auto proj = vsg::perspective(vsg::radians(60.0), 1.5, 0.5, 25.0);
+    auto view = vsg::lookAt(vsg::dvec3(0.0, -15.0, 5.0), vsg::dvec3(0.0, 0.0, 0.0), vsg::dvec3(0.0, 0.0, 1.0));
+    auto pv = proj * view;
+
+    std::vector<vsg::plane> polytope;
+    for (auto& clipPlane : {vsg::dplane(1.0, 0.0, 0.0, 1.0), vsg::dplane(-1.0, 0.0, 0.0, 1.0), vsg::dplane(0.0, 1.0, 0.0, 1.0), vsg::dplane(0.0, -1.0, 0.0, 1.0), vsg::dplane(0.0, 0.0, 1.0, 0.0), vsg::dplane(0.0, 0.0, -1.0, 1.0)})
+    {
+        vsg::dplane plane;
+        plane.vec = clipPlane.vec * pv;
+        plane.vec /= vsg::length(plane.n);
+        polytope.emplace_back(plane);
+    }
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> radius(0.01f, 1.0f);
+
+    std::cout << "\nSphere culling benchmark, " << polytope.size() << " planes" << std::endl;
+
+    bool exact = true;
+
+    for (size_t numSpheres : {1000, 10000, 100000, 1000000})
+    {
+        std::vector<vsg::sphere> spheres;
+        simd::SphereArray sphereArray;
+        spheres.reserve(numSpheres);
+        sphereArray.reserve(numSpheres);
+        for (size_t i = 0; i < numSpheres; ++i)
+        {
+            spheres.emplace_back(vsg::vec3(position(generator), position(generator), position(generator)), radius(generator));
+            sphereArray.add(spheres.back());
+        }
+
+        size_t iterations = std::max(size_t(1), static_cast<size_t>(targetSphereTests / static_cast<double>(numSpheres)));
+
+        auto startTime = std::chrono::steady_clock::now();
+        std::vector<uint8_t> referenceMask;
+        size_t numVisible = 0;
+        for (size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            referenceMask.assign((numSpheres + 7) / 8, 0);
+            numVisible = 0;
+            for (size_t i = 0; i < numSpheres; ++i)
+            {
+                if (vsg::intersect(polytope, spheres[i]))
+                {
+                    referenceMask[i / 8] |= static_cast<uint8_t>(1 << (i % 8));
+                    ++numVisible;
+                }
+            }
+        }
+        double referenceTime = std::chrono::duration<double, std::chrono::seconds::period>(std::chrono::steady_clock::now() - startTime).count() / static_cast<double>(iterations);
+
+        std::cout << "  " << numSpheres << " spheres, " << numVisible << " visible, " << iterations << " iterations" << std::endl;
+        std::cout << "    vsg::intersect : " << static_cast<double>(numSpheres) / referenceTime * 1e-6 << " million spheres/s" << std::endl;
+
+        for (auto kernel : {simd::SCALAR, simd::SSE, simd::AVX, simd::NEON})
+        {
+            if (!simd::supported(kernel)) continue;
+
+            std::vector<uint8_t> mask;
+            startTime = std::chrono::steady_clock::now();
+            size_t kernelVisible = 0;
+            for (size_t iteration = 0; iteration < iterations; ++iteration)
+            {
+                kernelVisible = simd::intersect(polytope, sphereArray, mask, kernel);
+            }
+            double kernelTime = std::chrono::duration<double, std::chrono::seconds::period>(std::chrono::steady_clock::now() - startTime).count() / static_cast<double>(iterations);
+
+            size_t numMismatches = 0;
+            for (size_t i = 0; i < numSpheres; ++i)
+            {
+                if (simd::visible(mask, i) != simd::visible(referenceMask, i)) ++numMismatches;
+            }
+            if (numMismatches > 0 || kernelVisible != numVisible) exact = false;
+
+            std::cout << "    " << simd::name(kernel) << " : " << static_cast<double>(numSpheres) / kernelTime * 1e-6 << " million spheres/s, speed up " << referenceTime / kernelTime
+                      << ", visible " << kernelVisible << ", mismatches " << numMismatches << std::endl;
+        }
+    }
+
+    return exact;
+}
+
+template<typename F>
+double timeOperation(size_t iterations, F function)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    for (size_t iteration = 0; iteration < iterations; ++iteration) function();
+    return std::chrono::duration<double, std::chrono::seconds::period>(std::chrono::steady_clock::now() - startTime).count() / static_cast<double>(iterations);
+}
+
+template<typename T>
+T maxDifference(const T* lhs, const T* rhs, size_t count)
 {
+    T difference = 0;
+    for (size_t i = 0; i < count; ++i) difference = std::max(difference, std::abs(lhs[i] - rhs[i]) / std::max(T(1), std::abs(lhs[i])));
+    return difference;
+}
+
+// time the vsg mat4/quat operators against the batched simd kernels, returning false if multiply or transform don't match the vsg templates exactly
+template<typename T>
+bool benchmarkMatrixKernels(const char* typeName, size_t count, size_t iterations)
+{
+    using Matrix = vsg::t_mat4<T>;
+    using Vec = vsg::t_vec3<T>;
+    using Quat = vsg::t_quat<T>;
+
+    // transform chains of the sort found in scene graphs and animations
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<T> unit(-1, 1);
+    std::vector<Matrix> lhs, rhs;
+    std::vector<Vec> points;
+    std::vector<Quat> lhsQuats, rhsQuats;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vec axis = vsg::normalize(Vec(unit(generator), unit(generator), unit(generator) + T(2)));
+        lhs.push_back(vsg::translate(Vec(unit(generator), unit(generator), unit(generator)) * T(100)) * vsg::rotate(unit(generator) * T(3), axis) * vsg::scale(Vec(T(1), T(1), T(1)) * (T(1.5) + unit(generator))));
+        rhs.push_back(vsg::perspective(T(0.5) + unit(generator) * T(0.25), T(1.5), T(0.1), T(1000)) * vsg::rotate(unit(generator) * T(3), axis));
+        points.emplace_back(unit(generator) * T(100), unit(generator) * T(100), unit(generator) * T(100));
+        lhsQuats.emplace_back(unit(generator) * T(3), axis);
+        rhsQuats.emplace_back(unit(generator) * T(3), vsg::normalize(Vec(unit(generator), unit(generator) + T(2), unit(generator))));
+    }
+    Matrix mvp = rhs.front() * lhs.front();
+
+    std::vector<Matrix> referenceMatrices(count), inverseMatrices(count), matrices;
+    std::vector<Vec> referencePoints(count), transformedPoints;
+    std::vector<Quat> referenceQuats(count), quats;
+
+    std::cout << "\n" << typeName << " matrix kernels, " << count << " operations, " << iterations << " iterations" << std::endl;
+
+    auto report = [&](const char* operation, const char* kernelName, double time, double referenceTime, const std::string& comparison) {
+        std::cout << "    " << operation << " " << kernelName << " : " << static_cast<double>(count) / time * 1e-6 << " million ops/s";
+        if (referenceTime > 0.0) std::cout << ", speed up " << referenceTime / time;
+        std::cout << comparison << std::endl;
+    };
+
+    double multiplyTime = timeOperation(iterations, [&]() { for (size_t i = 0; i < count; ++i) referenceMatrices[i] = lhs[i] * rhs[i]; });
+    double transformTime = timeOperation(iterations, [&]() { for (size_t i = 0; i < count; ++i) referencePoints[i] = mvp * points[i]; });
+    double inverseTime = timeOperation(iterations, [&]() { for (size_t i = 0; i < count; ++i) inverseMatrices[i] = vsg::inverse(lhs[i]); });
+    double quatTime = timeOperation(iterations, [&]() { for (size_t i = 0; i < count; ++i) referenceQuats[i] = lhsQuats[i] * rhsQuats[i]; });
+
+    report("mat4 * mat4", "vsg", multiplyTime, 0.0, "");
+    report("mat4 * vec3", "vsg", transformTime, 0.0, "");
+    report("inverse(mat4)", "vsg", inverseTime, 0.0, "");
+    report("quat * quat", "vsg", quatTime, 0.0, "");
+
+    bool exact = true;
+    for (auto kernel : {simd::SCALAR, simd::SSE, simd::AVX, simd::NEON})
+    {
+        if (!simd::supported(kernel)) continue;
+
+        double time = timeOperation(iterations, [&]() { simd::multiply(lhs, rhs, matrices, kernel); });
+        size_t numMismatches = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (std::memcmp(matrices[i].data(), referenceMatrices[i].data(), sizeof(Matrix)) != 0) ++numMismatches;
+        }
+        report("mat4 * mat4", simd::name(kernel), time, multiplyTime, ", mismatches " + std::to_string(numMismatches));
+        exact = exact && numMismatches == 0;
+
+        time = timeOperation(iterations, [&]() { simd::transform(mvp, points, transformedPoints, kernel); });
+        numMismatches = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (std::memcmp(transformedPoints[i].data(), referencePoints[i].data(), sizeof(Vec)) != 0) ++numMismatches;
+        }
+        report("mat4 * vec3", simd::name(kernel), time, transformTime, ", mismatches " + std::to_string(numMismatches));
+        exact = exact && numMismatches == 0;
+
+        time = timeOperation(iterations, [&]() { simd::inverse(lhs, matrices, kernel); });
+        T difference = 0;
+        for (size_t i = 0; i < count; ++i) difference = std::max(difference, maxDifference(inverseMatrices[i].data(), matrices[i].data(), 16));
+        report("inverse(mat4)", simd::name(kernel), time, inverseTime, ", max relative difference " + std::to_string(difference));
+
+        time = timeOperation(iterations, [&]() { simd::multiply(lhsQuats, rhsQuats, quats, kernel); });
+        difference = 0;
+        for (size_t i = 0; i < count; ++i) difference = std::max(difference, maxDifference(referenceQuats[i].data(), quats[i].data(), 4));
+        report("quat * quat", simd::name(kernel), time, quatTime, ", max relative difference " + std::to_string(difference));
+    }
+
+    return exact;
+}
+
+// compare the array ECEF <-> lat/long conversions with the EllipsoidModel methods, returning false if they fall outside the expected precision
+bool benchmarkEllipsoidConversions(size_t count, uint32_t iterations)
+{
+    auto ellipsoidModel = vsg::EllipsoidModel::create();
+
+    // points from below sea level out to geostationary orbit, with a third close to the ground
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> latitude(-90.0, 90.0), longitude(-180.0, 180.0), altitude(-1.0e4, 4.0e7);
+    auto latLongAltitudes = vsg::dvec3Array::create(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        double height = altitude(generator);
+        (*latLongAltitudes)[i] = vsg::dvec3(latitude(generator), longitude(generator), (i % 3 == 0) ? height * 1.0e-4 : height);
+    }
+
+    auto distance = [](const vsg::dvec3& lhs, const vsg::dvec3& rhs) { return vsg::length(lhs - rhs); };
+
+    std::cout << "\nEllipsoid conversions, " << count << " points, " << iterations << " iterations of the inverse" << std::endl;
+
+    bool withinPrecision = true;
+    double forwardTime = 0.0, inverseTime = 0.0;
+    vsg::ref_ptr<vsg::dvec3Array> referenceECEFs, referenceLatLongAltitudes;
+    for (auto kernel : {simd::SCALAR, simd::SSE, simd::AVX, simd::NEON})
+    {
+        if (!simd::supported(kernel)) continue;
+
+        auto startTime = std::chrono::steady_clock::now();
+        auto ecefs = simd::convertLatLongAltitudeToECEF(*ellipsoidModel, *latLongAltitudes, kernel);
+        auto midTime = std::chrono::steady_clock::now();
+        auto roundTrip = simd::convertECEFToLatLongAltitude(*ellipsoidModel, *ecefs, iterations, kernel);
+        auto endTime = std::chrono::steady_clock::now();
+
+        double kernelForwardTime = std::chrono::duration<double, std::chrono::seconds::period>(midTime - startTime).count();
+        double kernelInverseTime = std::chrono::duration<double, std::chrono::seconds::period>(endTime - midTime).count();
+        if (kernel == simd::SCALAR)
+        {
+            forwardTime = kernelForwardTime;
+            inverseTime = kernelInverseTime;
+            referenceECEFs = ecefs;
+            referenceLatLongAltitudes = roundTrip;
+        }
+
+        // differences from the EllipsoidModel, and the round trip error measured in ECEF space
+        double forwardDifference = 0.0, latLongDifference = 0.0, heightDifference = 0.0, roundTripError = 0.0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            forwardDifference = std::max(forwardDifference, distance((*ecefs)[i], (*referenceECEFs)[i]));
+            auto& lla = (*roundTrip)[i];
+            auto& reference = (*referenceLatLongAltitudes)[i];
+            latLongDifference = std::max(latLongDifference, std::max(std::abs(lla.x - reference.x), std::abs(lla.y - reference.y)));
+            heightDifference = std::max(heightDifference, std::abs(lla.z - reference.z));
+            roundTripError = std::max(roundTripError, distance(ellipsoidModel->convertLatLongAltitudeToECEF(lla), (*ecefs)[i]));
+        }
+
+        std::cout << "    " << simd::name(kernel) << std::endl;
+        std::cout << "        lat/long to ECEF : " << static_cast<double>(count) / kernelForwardTime * 1e-6 << " million points/s, speed up " << forwardTime / kernelForwardTime << ", max difference " << forwardDifference << "m" << std::endl;
+        std::cout << "        ECEF to lat/long : " << static_cast<double>(count) / kernelInverseTime * 1e-6 << " million points/s, speed up " << inverseTime / kernelInverseTime
+                  << ", max difference " << latLongDifference << " degrees, " << heightDifference << "m, round trip error " << roundTripError << "m" << std::endl;
+
+        if (kernel != simd::SCALAR)
+        {
+            withinPrecision = withinPrecision && forwardDifference < 1.0e-6;
+            if (iterations >= 2) withinPrecision = withinPrecision && roundTripError < 1.0e-3;
+        }
+    }
+
+    return withinPrecision;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    if (arguments.read("--ellipsoid-benchmark"))
+    {
+        auto count = arguments.value<size_t>(1000000, "--points");
+        auto iterations = arguments.value<uint32_t>(2, "--ellipsoid-iterations");
+        bool withinPrecision = benchmarkEllipsoidConversions(count, iterations);
+        if (!withinPrecision) std::cout << "\nSIMD ellipsoid conversions outside expected precision." << std::endl;
+        return withinPrecision ? 0 : 1;
+    }
+
+    if (arguments.read("--matrix-benchmark"))
+    {
+        auto count = arguments.value<size_t>(100000, "--matrix-ops");
+        auto iterations = arguments.value<size_t>(10, "--iterations");
+        bool exact = benchmarkMatrixKernels<float>("float", count, iterations);
+        exact = benchmarkMatrixKernels<double>("double", count, iterations) && exact;
+        if (!exact) std::cout << "\nSIMD matrix kernels do not match the vsg templates." << std::endl;
+        return exact ? 0 : 1;
+    }
+
+    if (arguments.read("--culling-benchmark"))
+    {
+        bool exact = benchmarkSphereCulling(arguments.value(1e8, "--sphere-tests"));
+        if (!exact) std::cout << "\nSIMD sphere culling does not match vsg::intersect." << std::endl;
+        return exact ? 0 : 1;
+    }
 
     vsg::vec2 v;
 
@@ -454,6 +454,69 @@ public:
     }
 };
 
+// Camera relative rendering: just before recording each frame move the ViewMatrix::origin to the eye point, so that the RecordTraversal
+// positions every CoordinateFrame relative to the eye, with the difference taken in long double and only the small remaining offsets
+// accumulated in double and pushed to the GPU as floats. The camera is restored once the frame is recorded so event handlers and camera
+// animations continue to work with the values they set.
+class OriginRebaser : public vsg::Inherit<vsg::Object, OriginRebaser>
+{
+public:
+    explicit OriginRebaser(vsg::ref_ptr<vsg::Camera> in_camera) :
+        camera(in_camera) {}
+
+    vsg::ref_ptr<vsg::Camera> camera;
+
+    // move origin as close to origin + eye as long double can represent, returning the part of eye left over, so that the camera doesn't
+    // move even when the origin is so far out that metres are lost in the sum.
+    static vsg::dvec3 rebase(vsg::ldvec3& origin, const vsg::dvec3& eye)
+    {
+        vsg::ldvec3 newOrigin = origin + vsg::ldvec3(eye);
+        vsg::dvec3 moved(newOrigin - origin);
+        origin = newOrigin;
+        return eye - moved;
+    }
+
+    void rebase()
+    {
+        if (auto lookDirection = camera->viewMatrix.cast<vsg::LookDirection>())
+        {
+            _origin = lookDirection->origin;
+            _eye = lookDirection->position;
+
+            lookDirection->position = rebase(lookDirection->origin, _eye);
+        }
+        else if (auto lookAt = camera->viewMatrix.cast<vsg::LookAt>())
+        {
+            _origin = lookAt->origin;
+            _eye = lookAt->eye;
+            _center = lookAt->center;
+
+            lookAt->eye = rebase(lookAt->origin, _eye);
+            lookAt->center = _center - (_eye - lookAt->eye);
+        }
+    }
+
+    void restore()
+    {
+        if (auto lookDirection = camera->viewMatrix.cast<vsg::LookDirection>())
+        {
+            lookDirection->origin = _origin;
+            lookDirection->position = _eye;
+        }
+        else if (auto lookAt = camera->viewMatrix.cast<vsg::LookAt>())
+        {
+            lookAt->origin = _origin;
+            lookAt->eye = _eye;
+            lookAt->center = _center;
+        }
+    }
+
+protected:
+    vsg::ldvec3 _origin;
+    vsg::dvec3 _eye;
+    vsg::dvec3 _center;
+};
+
 template<typename T>
 T precision(T v)
 {
@@ -565,6 +628,81 @@ void numerical_test()
     std::cout << "sizeof(long double) = " << sizeof(long double) << ", " << typeid(long double).name() << std::endl;
 }
 
+// CPU only test of the screen space error of a vertex on a CoordinateFrame far from the world origin, viewed from 10m as the camera drifts 1mm a frame.
+// The camera is held as a ViewMatrix holds it, a long double origin plus a double eye relative to it. The vertex is projected with float matrices
+// and a float vertex as the GPU would, with the modelview computed from float world coordinates, in double from the camera's fixed origin as the
+// RecordTraversal does, and in double after OriginRebaser has moved the origin to the eye. The errors are relative to the same camera and
+// vertex projected in long double, so show up as jitter from frame to frame.
+void rebasing_precision_test()
+{
+    using ldmat4 = vsg::t_mat4<long double>;
+    using ldvec4 = vsg::t_vec4<long double>;
+
+    const double width = 1920.0, height = 1080.0;
+    const ldmat4 projection(vsg::perspective(vsg::radians(30.0), width / height, 0.1, 1.0e4));
+    const vsg::mat4 projection_f(projection);
+    const vsg::vec3 vertex(0.5f, 0.25f, 0.125f);
+    const vsg::dvec3 up(0.0, 0.0, 1.0);
+    const int numFrames = 100;
+
+    auto toPixels = [&](const auto& clip) -> vsg::dvec2 {
+        return vsg::dvec2((static_cast<double>(clip.x / clip.w) * 0.5 + 0.5) * width, (static_cast<double>(clip.y / clip.w) * 0.5 + 0.5) * height);
+    };
+
+    std::cout << "\nrebasing_precision_test(), native_long_double_bits() = " << vsg::native_long_double_bits() << std::endl;
+    std::cout << "max screen space error in pixels over " << numFrames << " frames" << std::endl;
+    std::cout << "    distance\tcamera origin\tfloat world\tdouble fixed origin\tdouble rebased origin" << std::endl;
+
+    // a camera in world coordinates can only be placed 10m from the object while double can resolve it, beyond that the
+    // camera has to be held relative to the CoordinateFrame as the viewpoints in this example are, as with --worst-cast
+    struct Case
+    {
+        long double distance;
+        bool originAtCoordinateFrame;
+    };
+    for (auto& [distance, originAtCoordinateFrame] : {Case{1.0e3L, false}, Case{1.0e6L, false}, Case{1.5e11L, false}, Case{1.0e13L, false}, Case{1.0e15L, false}, Case{1.5e11L, true}, Case{8.514e25L, true}})
+    {
+        vsg::ldvec3 objectOrigin(distance, distance * 0.5L, distance * 0.25L);
+        vsg::ldvec3 cameraOrigin = originAtCoordinateFrame ? objectOrigin : vsg::ldvec3();
+        double maxError[3] = {0.0, 0.0, 0.0};
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            vsg::dvec3 eye((objectOrigin - cameraOrigin) + vsg::ldvec3(0.001L * frame, -10.0L, 1.0L));
+
+            // reference, relative to the object so unaffected by its distance from the world origin
+            vsg::ldvec3 relativeEye = (cameraOrigin - objectOrigin) + vsg::ldvec3(eye);
+            ldmat4 referenceModelView = vsg::lookAt(relativeEye, vsg::ldvec3(), vsg::ldvec3(up));
+            auto reference = toPixels(projection * (referenceModelView * ldvec4(vertex.x, vertex.y, vertex.z, 1.0L)));
+
+            // float world coordinates
+            vsg::vec3 eye_f(cameraOrigin + vsg::ldvec3(eye)), origin_f(objectOrigin);
+            vsg::mat4 floatModelView = vsg::lookAt(eye_f, origin_f, vsg::vec3(up)) * vsg::translate(origin_f);
+
+            // double from the camera's origin
+            vsg::dvec3 objectOffset(objectOrigin - cameraOrigin);
+            vsg::dmat4 fixedModelView = vsg::lookAt(eye, objectOffset, up) * vsg::translate(objectOffset);
+
+            // double from the origin moved to the eye
+            vsg::ldvec3 rebasedOrigin = cameraOrigin;
+            vsg::dvec3 rebasedEye = OriginRebaser::rebase(rebasedOrigin, eye);
+            vsg::dvec3 rebasedObjectOffset(objectOrigin - rebasedOrigin);
+            vsg::dmat4 rebasedModelView = vsg::lookAt(rebasedEye, rebasedObjectOffset, up) * vsg::translate(rebasedObjectOffset);
+
+            vsg::mat4 modelViews[3] = {floatModelView, vsg::mat4(fixedModelView), vsg::mat4(rebasedModelView)};
+            for (int i = 0; i < 3; ++i)
+            {
+                auto pixel = toPixels(projection_f * (modelViews[i] * vsg::vec4(vertex, 1.0f)));
+                double error = std::max(std::abs(pixel.x - reference.x), std::abs(pixel.y - reference.y));
+                if (!std::isfinite(error)) error = std::numeric_limits<double>::infinity(); // vertex not resolvable at all
+                maxError[i] = std::max(maxError[i], error);
+            }
+        }
+
+        std::cout << "    " << static_cast<double>(distance) << "\t" << (originAtCoordinateFrame ? "CoordinateFrame" : "world") << "\t" << maxError[0] << "\t" << maxError[1] << "\t" << maxError[2] << std::endl;
+    }
+}
+
 int main(int argc, char** argv)
 {
     try
@@ -577,6 +715,13 @@ int main(int argc, char** argv)
             numerical_test();
             return 0;
         }
+
+        if (arguments.read({"--precision-test", "--pt"}))
+        {
+            rebasing_precision_test();
+            return 0;
+        }
+
         auto windowTraits = vsg::WindowTraits::create(arguments);
         windowTraits->depthFormat = VK_FORMAT_D32_SFLOAT;
         if (int log_level = 0; arguments.read("--log-level", log_level)) vsg::Logger::instance()->level = vsg::Logger::Level(log_level);
@@ -608,6 +753,7 @@ int main(int argc, char** argv)
         auto clearColor = arguments.value(vsg::vec4(0.0f, 0.0f, 0.0f, 1.0f), "--clear");
 
         bool playAnimations = arguments.read("--play");
+        bool rebaseOrigin = arguments.read("--rebase");
 
         double distance_between_systems = arguments.value<double>(1.0e9, "--distance");
         if (arguments.read({"--worst-cast", "--wc"})) distance_between_systems = 8.514e25;
@@ -909,6 +1055,9 @@ int main(int argc, char** argv)
 
         viewer->compile();
 
+        vsg::ref_ptr<OriginRebaser> originRebaser;
+        if (rebaseOrigin) originRebaser = OriginRebaser::create(camera);
+
         // rendering main loop
         while (viewer->advanceToNextFrame() && (numFrames < 0 || (numFrames--) > 0))
         {
@@ -918,8 +1067,12 @@ int main(int argc, char** argv)
             // pass any events into EventHandlers assigned to the Viewer
             viewer->handleEvents();
 
+            if (originRebaser) originRebaser->rebase();
+
             viewer->recordAndSubmit();
 
+            if (originRebaser) originRebaser->restore();
+
             viewer->present();
         }
 
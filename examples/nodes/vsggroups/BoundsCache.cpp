@@ -0,0 +1,215 @@
+#include "BoundsCache.h"
+
+#include <vsg/nodes/LOD.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/Switch.h>
+
+namespace
+{
+    /// link every node the parent traverses to it, whatever the type of the parent
+    class LinkChildren : public vsg::ConstVisitor
+    {
+    public:
+        LinkChildren(BoundsCache& in_cache, const vsg::Node* in_parent) :
+            cache(in_cache),
+            parent(in_parent) {}
+
+        BoundsCache& cache;
+        const vsg::Node* parent;
+
+        void apply(const vsg::Object& object) override
+        {
+            if (auto child = object.cast<vsg::Node>()) cache.link(child, parent);
+        }
+    };
+} // namespace
+
+void BoundsCache::dirty(const vsg::Node* node)
+{
+    auto itr = _entries.find(node);
+    if (itr == _entries.end()) return;
+
+    itr->second.valid = false;
+
+    // an invalid cached entry's ancestors have already been invalidated so the walk stops at the first one it meets,
+    // while nodes without cached bounds, such as a CullNode, are walked through
+    std::vector<const vsg::Node*> nodes(itr->second.parents.begin(), itr->second.parents.end());
+    while (!nodes.empty())
+    {
+        auto parent = _entries.find(nodes.back());
+        nodes.pop_back();
+
+        if (parent == _entries.end() || (parent->second.cached && !parent->second.valid)) continue;
+
+        parent->second.valid = false;
+        nodes.insert(nodes.end(), parent->second.parents.begin(), parent->second.parents.end());
+    }
+}
+
+size_t BoundsCache::prune()
+{
+    size_t previousSize = _entries.size();
+
+    // releasing a node can leave its children only referenced by the cache, so repeat until nothing more is released
+    for (bool released = true; released;)
+    {
+        released = false;
+        for (auto itr = _entries.begin(); itr != _entries.end();)
+        {
+            if (itr->second.node->referenceCount() == 1)
+            {
+                itr = _entries.erase(itr);
+                released = true;
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+    }
+
+    for (auto& [node, entry] : _entries)
+    {
+        for (auto itr = entry.parents.begin(); itr != entry.parents.end();)
+        {
+            if (_entries.count(*itr) == 0)
+                itr = entry.parents.erase(itr);
+            else
+                ++itr;
+        }
+    }
+
+    return previousSize - _entries.size();
+}
+
+bool BoundsCache::link(const vsg::Node* child, const vsg::Node* parent)
+{
+    if (!child) return false;
+
+    return entry(child).parents.insert(parent).second;
+}
+
+BoundsCache::Entry& BoundsCache::entry(const vsg::Node* node)
+{
+    auto& entry = _entries[node];
+    if (!entry.node) entry.node = node;
+    return entry;
+}
+
+CachedComputeBounds::CachedComputeBounds(vsg::ref_ptr<BoundsCache> in_cache) :
+    cache(in_cache)
+{
+}
+
+template<class N, class F>
+void CachedComputeBounds::cached(const N& node, F traverse)
+{
+    // ComputeBounds::apply(MatrixTransform&) may forward to apply(Transform&) for the same node
+    if (!cache || (!_nodePath.empty() && _nodePath.back() == &node))
+    {
+        traverse();
+        return;
+    }
+
+    // the root, and nodes below ones that don't traverse through apply(const vsg::Node&), aren't linked by their parent
+    if (!_nodePath.empty()) cache->link(&node, _nodePath.back());
+
+    auto& entry = cache->entry(&node);
+    entry.cached = true;
+    if (entry.valid)
+    {
+        ++cache->numReused;
+    }
+    else
+    {
+        // compute the subgraph's bounds in its local coordinate frame
+        auto outerBounds = bounds;
+        auto outerMatrixStack = std::move(matrixStack);
+        bounds = {};
+        matrixStack = {vsg::dmat4()};
+
+        LinkChildren linkChildren(*cache, &node);
+        node.traverse(linkChildren);
+
+        _nodePath.push_back(&node);
+        traverse();
+        _nodePath.pop_back();
+
+        entry.bounds = bounds;
+        entry.valid = true;
+        ++cache->numComputed;
+
+        bounds = outerBounds;
+        matrixStack = std::move(outerMatrixStack);
+    }
+
+    add(entry.bounds);
+}
+
+void CachedComputeBounds::add(const vsg::dbox& localBounds)
+{
+    if (!localBounds.valid()) return;
+
+    if (matrixStack.empty())
+    {
+        bounds.add(localBounds);
+        return;
+    }
+
+    auto& matrix = matrixStack.back();
+    for (int i = 0; i < 8; ++i)
+    {
+        bounds.add(matrix * vsg::dvec3((i & 1) ? localBounds.max.x : localBounds.min.x,
+                                       (i & 2) ? localBounds.max.y : localBounds.min.y,
+                                       (i & 4) ? localBounds.max.z : localBounds.min.z));
+    }
+}
+
+void CachedComputeBounds::apply(const vsg::Node& node)
+{
+    // the base class apply() of cached nodes may forward to apply(const vsg::Node&) for the same node
+    if (!cache || (!_nodePath.empty() && _nodePath.back() == &node))
+    {
+        vsg::ComputeBounds::apply(node);
+        return;
+    }
+
+    // nodes without cached bounds, such as a CullNode, still link their children so dirtying a node below them reaches the cached ancestors
+    LinkChildren linkChildren(*cache, &node);
+    node.traverse(linkChildren);
+
+    _nodePath.push_back(&node);
+    vsg::ComputeBounds::apply(node);
+    _nodePath.pop_back();
+}
+
+void CachedComputeBounds::apply(const vsg::Group& group)
+{
+    cached(group, [&]() { vsg::ComputeBounds::apply(group); });
+}
+
+void CachedComputeBounds::apply(const vsg::StateGroup& stategroup)
+{
+    cached(stategroup, [&]() { vsg::ComputeBounds::apply(stategroup); });
+}
+
+void CachedComputeBounds::apply(const vsg::Transform& transform)
+{
+    cached(transform, [&]() { vsg::ComputeBounds::apply(transform); });
+}
+
+void CachedComputeBounds::apply(const vsg::MatrixTransform& transform)
+{
+    cached(transform, [&]() { vsg::ComputeBounds::apply(transform); });
+}
+
+void CachedComputeBounds::apply(const vsg::Switch& sw)
+{
+    cached(sw, [&]() { vsg::ComputeBounds::apply(sw); });
+}
+
+void CachedComputeBounds::apply(const vsg::LOD& lod)
+{
+    cached(lod, [&]() { vsg::ComputeBounds::apply(lod); });
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vsg/utils/ComputeBounds.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// BoundsCache holds the bounds of groups in their local coordinate frame, along with the parents of each node visited, so that
+/// edits can invalidate just the bounds of the edited node's ancestors. vsg::Node has no parent pointers so the links are
+/// recorded by CachedComputeBounds as it traverses, including those below nodes without cached bounds such as geometry under a CullNode,
+/// and the application calls dirty() on any node it edits:
+/// a group whose children it adds or removes, a transform whose matrix it changes, or a geometry whose vertices it modifies.
+/// The cache holds a reference to each node it has entries for, call prune() after removing subgraphs to release them.
+class BoundsCache : public vsg::Inherit<vsg::Object, BoundsCache>
+{
+public:
+    struct Entry
+    {
+        vsg::ref_ptr<const vsg::Node> node;
+        std::unordered_set<const vsg::Node*> parents;
+        vsg::dbox bounds;
+        bool cached = false; // false for nodes only recorded for their parents
+        bool valid = false;
+    };
+
+    /// invalidate the cached bounds of node and all of its ancestors, node must have been visited by CachedComputeBounds
+    void dirty(const vsg::Node* node);
+
+    /// release the entries of nodes only referenced by the cache, returning the number removed
+    size_t prune();
+
+    /// record child's parent, return true if the link is new
+    bool link(const vsg::Node* child, const vsg::Node* parent);
+
+    Entry& entry(const vsg::Node* node);
+
+    size_t size() const { return _entries.size(); }
+
+    /// number of cached bounds recomputed since the last call to resetStats()
+    size_t numComputed = 0;
+
+    /// number of cached bounds reused since the last call to resetStats()
+    size_t numReused = 0;
+
+    void resetStats() { numComputed = numReused = 0; }
+
+protected:
+    std::unordered_map<const vsg::Node*, Entry> _entries;
+};
+
+/// ComputeBounds that reuses the bounds held in a BoundsCache for Group, StateGroup, Transform, MatrixTransform, Switch and LOD nodes,
+/// only traversing the subgraphs that have been dirtied since they were last computed.
+/// Cached bounds are in the node's local coordinates so are transformed into the current frame as boxes, which gives the same
+/// bounds as vsg::ComputeBounds below translations and looser bounds below rotations.
+/// Transforms whose matrix depends on the traversal rather than their own state, such as vsg::AbsoluteTransform, should not be placed below cached nodes.
+class CachedComputeBounds : public vsg::Inherit<vsg::ComputeBounds, CachedComputeBounds>
+{
+public:
+    explicit CachedComputeBounds(vsg::ref_ptr<BoundsCache> in_cache = {});
+
+    vsg::ref_ptr<BoundsCache> cache;
+
+    using vsg::ComputeBounds::apply;
+
+    void apply(const vsg::Node& node) override;
+    void apply(const vsg::Group& group) override;
+    void apply(const vsg::StateGroup& stategroup) override;
+    void apply(const vsg::Transform& transform) override;
+    void apply(const vsg::MatrixTransform& transform) override;
+    void apply(const vsg::Switch& sw) override;
+    void apply(const vsg::LOD& lod) override;
+
+protected:
+    template<class N, class F>
+    void cached(const N& node, F traverse);
+
+    void add(const vsg::dbox& localBounds);
+
+    std::vector<const vsg::Node*> _nodePath;
+};
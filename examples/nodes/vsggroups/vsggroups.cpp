@@ -3,8 +3,10 @@
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <random>
 #include <vector>
 
+#include "BoundsCache.h"
 #include "SharedPtrNode.h"
 
 //#define INLINE_TRAVERSE
@@ -212,6 +214,104 @@ std::shared_ptr<experimental::SharedPtrNode> createSharedPtrFixedQuadTree(uint64
     return t;
 }
 
+vsg::ref_ptr<vsg::Node> createBoundsQuadTree(uint64_t numLevels, const vsg::dvec3& origin, double size, vsg::ref_ptr<vsg::Node> leaf, std::vector<vsg::ref_ptr<vsg::MatrixTransform>>& transforms)
+{
+    if (numLevels == 0)
+    {
+        auto transform = vsg::MatrixTransform::create(vsg::translate(origin));
+        transform->addChild(leaf);
+        transforms.push_back(transform);
+        return transform;
+    }
+
+    auto t = vsg::Group::create(4);
+
+    --numLevels;
+    size *= 0.5;
+
+    t->children[0] = createBoundsQuadTree(numLevels, origin, size, leaf, transforms);
+    t->children[1] = createBoundsQuadTree(numLevels, origin + vsg::dvec3(size, 0.0, 0.0), size, leaf, transforms);
+    t->children[2] = createBoundsQuadTree(numLevels, origin + vsg::dvec3(0.0, size, 0.0), size, leaf, transforms);
+    t->children[3] = createBoundsQuadTree(numLevels, origin + vsg::dvec3(size, size, 0.0), size, leaf, transforms);
+
+    return t;
+}
+
+// compare full ComputeBounds traversals with CachedComputeBounds on a quad tree of MatrixTransforms sharing one Geometry,
+// moving a number of randomly chosen transforms before each query.
+int boundsBenchmark(uint64_t numLevels, uint32_t numQueries, uint32_t numEdits)
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    auto vertices = vsg::vec3Array::create({{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f},
+                                            {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}});
+    auto geometry = vsg::Geometry::create();
+    geometry->assignArrays(vsg::DataList{vertices});
+
+    std::vector<vsg::ref_ptr<vsg::MatrixTransform>> transforms;
+    double size = static_cast<double>(1u << numLevels) * 2.0;
+    auto root = createBoundsQuadTree(numLevels, vsg::dvec3(), size, geometry, transforms);
+
+    auto cache = BoundsCache::create();
+
+    auto start = clock::now();
+    auto fullBounds = vsg::visit<vsg::ComputeBounds>(root).bounds;
+    auto fullTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    start = clock::now();
+    CachedComputeBounds fillCache(cache);
+    root->accept(fillCache);
+    auto fillTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    std::cout << "bounds benchmark, numLevels = " << numLevels << ", transforms = " << transforms.size() << ", cache entries = " << cache->size() << std::endl;
+    std::cout << "    first ComputeBounds " << fullTime << "ms, first CachedComputeBounds " << fillTime << "ms, bounds match = " << (fillCache.bounds.min == fullBounds.min && fillCache.bounds.max == fullBounds.max) << std::endl;
+
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<size_t> pickTransform(0, transforms.size() - 1);
+    std::uniform_real_distribution<double> offset(-size * 0.1, size * 0.1);
+
+    double totalFullTime = 0.0, totalCachedTime = 0.0;
+    size_t totalComputed = 0, totalReused = 0, mismatches = 0;
+
+    for (uint32_t query = 0; query < numQueries; ++query)
+    {
+        for (uint32_t edit = 0; edit < numEdits; ++edit)
+        {
+            auto& transform = transforms[pickTransform(generator)];
+            transform->matrix = vsg::translate(offset(generator), offset(generator), offset(generator)) * transform->matrix;
+            cache->dirty(transform);
+        }
+
+        start = clock::now();
+        fullBounds = vsg::visit<vsg::ComputeBounds>(root).bounds;
+        auto afterFull = clock::now();
+
+        cache->resetStats();
+        CachedComputeBounds cachedComputeBounds(cache);
+        root->accept(cachedComputeBounds);
+        auto afterCached = clock::now();
+
+        totalFullTime += std::chrono::duration<double, std::milli>(afterFull - start).count();
+        totalCachedTime += std::chrono::duration<double, std::milli>(afterCached - afterFull).count();
+        totalComputed += cache->numComputed;
+        totalReused += cache->numReused;
+
+        // only translations are applied so the cached bounds should be exactly those of a full traversal
+        if (cachedComputeBounds.bounds.min != fullBounds.min || cachedComputeBounds.bounds.max != fullBounds.max) ++mismatches;
+    }
+
+    if (numQueries > 0)
+    {
+        std::cout << "    " << numQueries << " queries with " << numEdits << " edits each" << std::endl;
+        std::cout << "    ComputeBounds average " << totalFullTime / numQueries << "ms" << std::endl;
+        std::cout << "    CachedComputeBounds average " << totalCachedTime / numQueries << "ms, speedup " << totalFullTime / totalCachedTime << std::endl;
+        std::cout << "    groups recomputed per query " << double(totalComputed) / numQueries << ", reused per query " << double(totalReused) / numQueries << std::endl;
+        std::cout << "    mismatches " << mismatches << std::endl;
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
+
 // consider tcmalloc? https://goog-perftools.sourceforge.net/doc/tcmalloc.html
 // consider Alloc https://www.codeproject.com/Articles/1084801/Replace-malloc-free-with-a-Fast-Fixed-Block-Memory
 class StdAllocator : public vsg::Allocator
@@ -293,6 +393,17 @@ int main(int argc, char** argv)
     if (size_t nodesBlockSize; arguments.read("--nodes", nodesBlockSize)) vsg::Allocator::instance()->setBlockSize(vsg::ALLOCATOR_AFFINITY_NODES, nodesBlockSize * unit);
     if (size_t dataBlockSize; arguments.read("--data", dataBlockSize)) vsg::Allocator::instance()->setBlockSize(vsg::ALLOCATOR_AFFINITY_DATA, dataBlockSize * unit);
 
+    // each leaf is a MatrixTransform with a cache entry so default to fewer levels than the traversal tests
+    if (arguments.read("--bounds-benchmark"))
+    {
+        auto numBoundsLevels = arguments.value(8u, "--bounds-levels");
+        auto numQueries = arguments.value(100u, "--queries");
+        auto numEdits = arguments.value(16u, "--edits");
+        if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+        return boundsBenchmark(numBoundsLevels, numQueries, numEdits);
+    }
+
     vsg::ref_ptr<vsg::RecordTraversal> vsg_recordTraversal(arguments.read("-d") ? new vsg::RecordTraversal : nullptr);
     vsg::ref_ptr<VsgConstVisitor> vsg_ConstVisitor(arguments.read("-c") ? new VsgConstVisitor : nullptr);
     if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
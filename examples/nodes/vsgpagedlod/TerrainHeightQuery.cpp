@@ -0,0 +1,259 @@
+#include "TerrainHeightQuery.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <sstream>
+
+namespace
+{
+    class CollectTiles : public vsg::Inherit<vsg::ConstVisitor, CollectTiles>
+    {
+    public:
+        std::function<void(uint32_t x, uint32_t y, uint32_t level, vsg::ref_ptr<const vsg::Node> tile)> insert;
+
+        void apply(const vsg::Node& node) override
+        {
+            node.traverse(*this);
+        }
+
+        void apply(const vsg::PagedLOD& plod) override
+        {
+            // TileReader names each PagedLOD after its own tile, "x y level.tile", with the tile's geometry as the low resolution child,
+            // which isn't traversed as it holds no tiles
+            if (vsg::lowerCaseFileExtension(plod.filename) == ".tile")
+            {
+                auto tile_info = plod.filename.substr(0, plod.filename.length() - 5);
+                std::basic_stringstream<vsg::Path::value_type> sstr(tile_info.native());
+
+                uint32_t x, y, level;
+                if ((sstr >> x >> y >> level) && plod.children[1].node) insert(x, y, level, plod.children[1].node);
+            }
+
+            // only the high resolution child contains the PagedLOD of the next level
+            if (plod.children[0].node) plod.children[0].node->accept(*this);
+        }
+
+        void apply(const vsg::CullGroup& cullGroup) override
+        {
+            // TileReader tags the tiles at the maximum level, which have no PagedLOD, with their x, y and level
+            vsg::uivec3 tile;
+            if (cullGroup.getValue("tile", tile))
+            {
+                insert(tile.x, tile.y, tile.z, vsg::ref_ptr<const vsg::Node>(&cullGroup));
+                return;
+            }
+
+            cullGroup.traverse(*this);
+        }
+    };
+
+    struct QueryOperation : public vsg::Inherit<vsg::Operation, QueryOperation>
+    {
+        QueryOperation(std::function<void()> in_function, vsg::ref_ptr<vsg::Latch> in_latch) :
+            function(in_function),
+            latch(in_latch) {}
+
+        std::function<void()> function;
+        vsg::ref_ptr<vsg::Latch> latch;
+
+        void run() override
+        {
+            function();
+            latch->count_down();
+        }
+    };
+
+    bool contains(const vsg::dbox& extents, const vsg::dvec2& coord)
+    {
+        return coord.x >= extents.min.x && coord.x <= extents.max.x && coord.y >= extents.min.y && coord.y <= extents.max.y;
+    }
+} // namespace
+
+TerrainHeightQuery::TerrainHeightQuery(vsg::ref_ptr<const TileReader> in_tileReader) :
+    tileReader(in_tileReader)
+{
+}
+
+void TerrainHeightQuery::update(const vsg::Node& scene)
+{
+    _nodes.clear();
+    _roots.assign(tileReader->noX * tileReader->noY, -1);
+    _numTiles = 0;
+    _maxLevel = 0;
+
+    auto collectTiles = CollectTiles::create();
+    collectTiles->insert = [&](uint32_t x, uint32_t y, uint32_t level, vsg::ref_ptr<const vsg::Node> tile) { insert(x, y, level, tile); };
+    scene.accept(*collectTiles);
+}
+
+void TerrainHeightQuery::insert(uint32_t x, uint32_t y, uint32_t level, vsg::ref_ptr<const vsg::Node> tile)
+{
+    uint32_t rootX = x >> level;
+    uint32_t rootY = y >> level;
+    if (rootX >= tileReader->noX || rootY >= tileReader->noY) return;
+
+    auto createNode = [&](uint32_t nodeX, uint32_t nodeY, uint32_t nodeLevel, int32_t parent) {
+        QuadNode node;
+        node.extents = tileReader->computeTileExtents(nodeX, nodeY, nodeLevel);
+        node.level = nodeLevel;
+        node.parent = parent;
+        _nodes.push_back(node);
+        return static_cast<int32_t>(_nodes.size() - 1);
+    };
+
+    auto& root = _roots[rootY * tileReader->noX + rootX];
+    if (root < 0) root = createNode(rootX, rootY, 0, -1);
+
+    // descend from the level 0 tile creating any ancestors not visited yet, indices are used as _nodes may reallocate
+    int32_t nodeIndex = root;
+    for (uint32_t l = 1; l <= level; ++l)
+    {
+        uint32_t childX = x >> (level - l);
+        uint32_t childY = y >> (level - l);
+        uint32_t quadrant = (childX & 1) | ((childY & 1) << 1);
+        if (_nodes[nodeIndex].children[quadrant] < 0)
+        {
+            auto childIndex = createNode(childX, childY, l, nodeIndex);
+            _nodes[nodeIndex].children[quadrant] = childIndex;
+        }
+        nodeIndex = _nodes[nodeIndex].children[quadrant];
+    }
+
+    auto& node = _nodes[nodeIndex];
+    if (!node.tile) ++_numTiles;
+    node.tile = tile;
+    _maxLevel = std::max(_maxLevel, level);
+}
+
+int32_t TerrainHeightQuery::findTile(const vsg::dvec2& coord) const
+{
+    int32_t nodeIndex = -1;
+    for (auto root : _roots)
+    {
+        if (root >= 0 && contains(_nodes[root].extents, coord))
+        {
+            nodeIndex = root;
+            break;
+        }
+    }
+
+    // descend to the deepest resident tile, choosing the quadrant the way insert() numbers them so a coord on the edge
+    // between two children follows the same child at every level rather than whichever was created first
+    int32_t tileIndex = -1;
+    while (nodeIndex >= 0)
+    {
+        auto& node = _nodes[nodeIndex];
+        if (node.tile) tileIndex = nodeIndex;
+
+        auto center = (node.extents.min + node.extents.max) * 0.5;
+        uint32_t dx = coord.x >= center.x ? 1 : 0;
+        uint32_t dy = (tileReader->originTopLeft ? coord.y < center.y : coord.y >= center.y) ? 1 : 0;
+        nodeIndex = node.children[dx | (dy << 1)];
+    }
+    return tileIndex;
+}
+
+TerrainHeightQuery::Result TerrainHeightQuery::intersect(int32_t nodeIndex, double latitude, double longitude) const
+{
+    Result result;
+    if (nodeIndex < 0) return result;
+
+    auto& ellipsoidModel = tileReader->ellipsoidModel;
+    auto start = ellipsoidModel->convertLatLongAltitudeToECEF(vsg::dvec3(latitude, longitude, maximumHeight));
+    auto end = ellipsoidModel->convertLatLongAltitudeToECEF(vsg::dvec3(latitude, longitude, minimumHeight));
+
+    // a tile's geometry can be missed along its edges, or the tile may be partially built, so step up to coarser ancestors until one is hit
+    for (; nodeIndex >= 0; nodeIndex = _nodes[nodeIndex].parent)
+    {
+        auto& node = _nodes[nodeIndex];
+        if (!node.tile) continue;
+
+        auto intersector = vsg::LineSegmentIntersector::create(start, end);
+        node.tile->accept(*intersector);
+        if (intersector->intersections.empty()) continue;
+
+        auto nearest = std::min_element(intersector->intersections.begin(), intersector->intersections.end(), [](auto& lhs, auto& rhs) { return lhs->ratio < rhs->ratio; });
+
+        // both ends share the same ellipsoid normal so altitude is linear along the segment
+        result.valid = true;
+        result.height = maximumHeight + (minimumHeight - maximumHeight) * (*nearest)->ratio;
+        result.ecef = (*nearest)->worldIntersection;
+        result.level = node.level;
+        break;
+    }
+    return result;
+}
+
+TerrainHeightQuery::Result TerrainHeightQuery::query(double latitude, double longitude) const
+{
+    return query(std::vector<vsg::dvec2>{vsg::dvec2(latitude, longitude)}).front();
+}
+
+std::vector<TerrainHeightQuery::Result> TerrainHeightQuery::query(const std::vector<vsg::dvec2>& latitudeLongitudes, vsg::ref_ptr<vsg::OperationThreads> operationThreads) const
+{
+    auto start = vsg::clock::now();
+
+    // sort the queries by tile so each tile's geometry is visited by consecutive queries
+    std::vector<std::pair<int32_t, uint32_t>> order(latitudeLongitudes.size());
+    for (uint32_t i = 0; i < latitudeLongitudes.size(); ++i)
+    {
+        auto& latitudeLongitude = latitudeLongitudes[i];
+        order[i] = {findTile(tileReader->computeTileCoordinate(latitudeLongitude.x, latitudeLongitude.y)), i};
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<Result> results(latitudeLongitudes.size());
+    auto process = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+        {
+            auto& [nodeIndex, queryIndex] = order[i];
+            auto& latitudeLongitude = latitudeLongitudes[queryIndex];
+            results[queryIndex] = intersect(nodeIndex, latitudeLongitude.x, latitudeLongitude.y);
+        }
+    };
+
+    size_t batchSize = 256;
+    if (operationThreads && order.size() > batchSize)
+    {
+        size_t numBatches = (order.size() + batchSize - 1) / batchSize;
+        auto latch = vsg::Latch::create(static_cast<int>(numBatches));
+        for (size_t first = 0; first < order.size(); first += batchSize)
+        {
+            size_t last = std::min(first + batchSize, order.size());
+            operationThreads->add(QueryOperation::create([&process, first, last]() { process(first, last); }, latch));
+        }
+        latch->wait();
+    }
+    else
+    {
+        process(0, order.size());
+    }
+
+    auto time = std::chrono::duration<double>(vsg::clock::now() - start).count();
+    size_t numResolved = std::count_if(results.begin(), results.end(), [](auto& result) { return result.valid; });
+
+    std::scoped_lock<std::mutex> lock(statsMutex);
+    numQueries += results.size();
+    numQueriesResolved += numResolved;
+    totalQueryTime += time;
+
+    return results;
+}
+
+void TerrainHeightQuery::clearStats()
+{
+    std::scoped_lock<std::mutex> lock(statsMutex);
+    numQueries = 0;
+    numQueriesResolved = 0;
+    totalQueryTime = 0.0;
+}
+
+void TerrainHeightQuery::report(std::ostream& out) const
+{
+    std::scoped_lock<std::mutex> lock(statsMutex);
+    out << "TerrainHeightQuery::report() " << this << " tiles = " << _numTiles << ", max level = " << _maxLevel << std::endl;
+    out << "    queries = " << numQueries << ", resolved = " << numQueriesResolved << ", time = " << totalQueryTime * 1000.0 << "ms";
+    if (totalQueryTime > 0.0) out << ", queries/s = " << static_cast<double>(numQueries) / totalQueryTime;
+    out << std::endl;
+}
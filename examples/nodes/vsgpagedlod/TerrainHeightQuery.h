@@ -0,0 +1,70 @@
+#pragma once
+
+#include "TileReader.h"
+
+// Height at latitude, longitude queries against the resident tiles of a TileReader paged database.
+// update() indexes the tiles currently in the scene graph, the PagedLOD and the CullGroup of the maximum level, in a quadtree of tile extents,
+// so a query only intersects the geometry of the highest resolution resident tile beneath it rather than traversing the whole database
+// from space down to the ellipsoid. Where the maximum level tile isn't resident, or its geometry is missed, the query falls back to the
+// deepest resident ancestor that it intersects, so Result::level reports the resolution of the height returned.
+class TerrainHeightQuery : public vsg::Inherit<vsg::Object, TerrainHeightQuery>
+{
+public:
+    explicit TerrainHeightQuery(vsg::ref_ptr<const TileReader> in_tileReader);
+
+    vsg::ref_ptr<const TileReader> tileReader;
+
+    // altitude range, in metres, of the vertical line segment intersected with the tile
+    double minimumHeight = -12000.0;
+    double maximumHeight = 10000.0;
+
+    struct Result
+    {
+        bool valid = false;
+        double height = 0.0;
+        vsg::dvec3 ecef;
+        uint32_t level = 0; // level of the tile used
+    };
+
+    // rebuild the quadtree from the tiles resident in the scene graph, call after Viewer::update() as the DatabasePager merges and expires tiles then.
+    void update(const vsg::Node& scene);
+
+    // height at latitude, longitude in degrees
+    Result query(double latitude, double longitude) const;
+
+    // heights at each latitude, longitude in degrees, grouped by tile and spread across operationThreads when provided
+    std::vector<Result> query(const std::vector<vsg::dvec2>& latitudeLongitudes, vsg::ref_ptr<vsg::OperationThreads> operationThreads = {}) const;
+
+    size_t numTiles() const { return _numTiles; }
+    uint32_t maxLevel() const { return _maxLevel; }
+
+    // timing stats
+    mutable std::mutex statsMutex;
+    mutable uint64_t numQueries{0};
+    mutable uint64_t numQueriesResolved{0};
+    mutable double totalQueryTime{0.0};
+
+    void clearStats();
+    void report(std::ostream& out) const;
+
+protected:
+    struct QuadNode
+    {
+        vsg::dbox extents;
+        vsg::ref_ptr<const vsg::Node> tile;
+        uint32_t level = 0;
+        int32_t parent = -1;
+        int32_t children[4] = {-1, -1, -1, -1};
+    };
+
+    void insert(uint32_t x, uint32_t y, uint32_t level, vsg::ref_ptr<const vsg::Node> tile);
+    int32_t findTile(const vsg::dvec2& coord) const;
+
+    // intersect the tile at nodeIndex, or failing that the nearest of its ancestors with a tile that is intersected
+    Result intersect(int32_t nodeIndex, double latitude, double longitude) const;
+
+    std::vector<QuadNode> _nodes;
+    std::vector<int32_t> _roots; // noY * noX level 0 tiles
+    size_t _numTiles = 0;
+    uint32_t _maxLevel = 0;
+};
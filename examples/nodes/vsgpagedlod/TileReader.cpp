@@ -14,6 +14,19 @@ vsg::dvec3 TileReader::computeLatitudeLongitudeAltitude(const vsg::dvec3& src) c
     }
 }
 
+vsg::dvec2 TileReader::computeTileCoordinate(double latitude, double longitude) const
+{
+    if (projection == "EPSG:3857" || projection == "spherical-mercator")
+    {
+        double adjustedLatitude = 0.5 * vsg::degrees(asinh(tan(vsg::radians(latitude))));
+        return vsg::dvec2(longitude, adjustedLatitude);
+    }
+    else
+    {
+        return vsg::dvec2(longitude, latitude);
+    }
+}
+
 vsg::dbox TileReader::computeTileExtents(uint32_t x, uint32_t y, uint32_t level) const
 {
     double multiplier = pow(0.5, double(level));
@@ -209,6 +222,9 @@ vsg::ref_ptr<vsg::Object> TileReader::read_subtile(uint32_t x, uint32_t y, uint3
                         cullGroup->bound = bound;
                         cullGroup->addChild(tile);
 
+                        // tiles at the maximum level have no PagedLOD filename to identify them by, so record their x, y and level
+                        cullGroup->setValue("tile", vsg::uivec3(tileID.local_x, tileID.local_y, local_lod));
+
                         group->addChild(cullGroup);
                     }
                 }
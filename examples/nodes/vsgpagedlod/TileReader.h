@@ -24,6 +24,12 @@ public:
 
     vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const override;
 
+    // extents of tile x, y at level in the projection's coordinates, as used by the PagedLOD filenames "x y level.tile"
+    vsg::dbox computeTileExtents(uint32_t x, uint32_t y, uint32_t level) const;
+
+    // position in the projection's coordinates of latitude, longitude in degrees, the inverse of computeLatitudeLongitudeAltitude()
+    vsg::dvec2 computeTileCoordinate(double latitude, double longitude) const;
+
     // timing stats
     mutable std::mutex statsMutex;
     mutable uint64_t numTilesRead{0};
@@ -31,7 +37,6 @@ public:
 
 protected:
     vsg::dvec3 computeLatitudeLongitudeAltitude(const vsg::dvec3& src) const;
-    vsg::dbox computeTileExtents(uint32_t x, uint32_t y, uint32_t level) const;
     vsg::Path getTilePath(const vsg::Path& src, uint32_t x, uint32_t y, uint32_t level) const;
 
     vsg::ref_ptr<vsg::Object> read_root(vsg::ref_ptr<const vsg::Options> options = {}) const;
@@ -5,10 +5,57 @@
 #include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <random>
 #include <thread>
 
+#include "TerrainHeightQuery.h"
 #include "TileReader.h"
 
+// time batched TerrainHeightQuery against a LineSegmentIntersector traversal of the whole database for each query
+void heightQueryBenchmark(vsg::ref_ptr<vsg::Node> scene, vsg::ref_ptr<TerrainHeightQuery> heightQuery, const std::vector<vsg::dvec2>& latitudeLongitudes, vsg::ref_ptr<vsg::OperationThreads> operationThreads)
+{
+    auto startTime = vsg::clock::now();
+    heightQuery->update(*scene);
+    auto updateTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+    std::cout << "TerrainHeightQuery indexed " << heightQuery->numTiles() << " tiles, max level " << heightQuery->maxLevel() << ", in " << updateTime << "ms" << std::endl;
+
+    auto run = [&](const std::string& name, vsg::ref_ptr<vsg::OperationThreads> threads) {
+        startTime = vsg::clock::now();
+        auto results = heightQuery->query(latitudeLongitudes, threads);
+        auto time = std::chrono::duration<double>(vsg::clock::now() - startTime).count();
+        std::cout << name << " : " << latitudeLongitudes.size() << " queries in " << time * 1000.0 << "ms, " << static_cast<double>(latitudeLongitudes.size()) / time << " queries/s" << std::endl;
+        return results;
+    };
+
+    auto results = run("TerrainHeightQuery single threaded", {});
+    if (operationThreads) run("TerrainHeightQuery multi-threaded ", operationThreads);
+
+    // the whole database traversal is much slower so only time a subset of the queries
+    size_t numReferenceQueries = std::min(latitudeLongitudes.size(), size_t(1000));
+    size_t numMismatches = 0;
+    auto& ellipsoidModel = heightQuery->tileReader->ellipsoidModel;
+    startTime = vsg::clock::now();
+    for (size_t i = 0; i < numReferenceQueries; ++i)
+    {
+        auto& latitudeLongitude = latitudeLongitudes[i];
+        auto start = ellipsoidModel->convertLatLongAltitudeToECEF(vsg::dvec3(latitudeLongitude.x, latitudeLongitude.y, heightQuery->maximumHeight));
+        auto end = ellipsoidModel->convertLatLongAltitudeToECEF(vsg::dvec3(latitudeLongitude.x, latitudeLongitude.y, heightQuery->minimumHeight));
+
+        auto intersector = vsg::LineSegmentIntersector::create(start, end);
+        scene->accept(*intersector);
+
+        double ratio = 2.0;
+        for (auto& intersection : intersector->intersections) ratio = std::min(ratio, intersection->ratio);
+
+        bool valid = ratio <= 1.0;
+        double height = heightQuery->maximumHeight + (heightQuery->minimumHeight - heightQuery->maximumHeight) * ratio;
+        if (valid != results[i].valid || (valid && std::abs(height - results[i].height) > 1e-3)) ++numMismatches;
+    }
+    auto time = std::chrono::duration<double>(vsg::clock::now() - startTime).count();
+    std::cout << "LineSegmentIntersector whole database : " << numReferenceQueries << " queries in " << time * 1000.0 << "ms, " << static_cast<double>(numReferenceQueries) / time << " queries/s, "
+              << numMismatches << " mismatches" << std::endl;
+}
+
 int main(int argc, char** argv)
 {
     //return 0;
@@ -41,6 +88,7 @@ int main(int argc, char** argv)
         auto maxPagedLOD = arguments.value(0, "--maxPagedLOD");
         auto loadLevels = arguments.value(0, "--load-levels");
         auto horizonMountainHeight = arguments.value(0.0, "--hmh");
+        auto numHeightQueries = arguments.value(0u, "--height-queries");
         bool useEllipsoidPerspective = !arguments.read({"--disble-EllipsoidPerspective", "--dep"});
         if (arguments.read("--rgb")) options->mapRGBtoRGBAHint = false;
 
@@ -206,6 +254,24 @@ int main(int argc, char** argv)
             std::cout << "No. of tiles loaed " << loadPagedLOD.numTiles << " in " << time << "ms." << std::endl;
         }
 
+        // height queries at random locations around the point of interest, or across the whole globe
+        vsg::ref_ptr<TerrainHeightQuery> heightQuery;
+        std::vector<vsg::dvec2> heightQueryLocations;
+        if (numHeightQueries > 0 && ellipsoidModel)
+        {
+            heightQuery = TerrainHeightQuery::create(tileReader);
+
+            bool poi = poi_latitude != invalid_value && poi_longitude != invalid_value;
+            std::mt19937 generator(1);
+            std::uniform_real_distribution<double> latitude(poi ? poi_latitude - 0.5 : -80.0, poi ? poi_latitude + 0.5 : 80.0);
+            std::uniform_real_distribution<double> longitude(poi ? poi_longitude - 0.5 : -180.0, poi ? poi_longitude + 0.5 : 180.0);
+            for (uint32_t i = 0; i < numHeightQueries; ++i) heightQueryLocations.emplace_back(latitude(generator), longitude(generator));
+
+            auto operationThreads = options->operationThreads ? options->operationThreads : vsg::OperationThreads::create(std::max(1u, std::thread::hardware_concurrency()));
+            heightQueryBenchmark(vsg_scene, heightQuery, heightQueryLocations, operationThreads);
+            heightQuery->clearStats();
+        }
+
         auto commandGraph = vsg::createCommandGraphForView(window, camera, vsg_scene);
         viewer->assignRecordAndSubmitTaskAndPresentation({commandGraph});
 #if 0
@@ -233,6 +299,13 @@ int main(int argc, char** argv)
 
             viewer->update();
 
+            if (heightQuery)
+            {
+                // reindex after the DatabasePager has merged and expired tiles in Viewer::update()
+                heightQuery->update(*vsg_scene);
+                heightQuery->query(heightQueryLocations, options->operationThreads);
+            }
+
             viewer->recordAndSubmit();
 
             viewer->present();
@@ -244,6 +317,8 @@ int main(int argc, char** argv)
             std::cout << "numTilesRead = " << tileReader->numTilesRead << std::endl;
             std::cout << "average TimeReadingTiles = " << (tileReader->totalTimeReadingTiles / static_cast<double>(tileReader->numTilesRead)) << std::endl;
         }
+
+        if (heightQuery) heightQuery->report(std::cout);
     }
     catch (const vsg::Exception& ve)
     {
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vsg/core/ConstVisitor.h>
+#include <vsg/core/Inherit.h>
+#include <vsg/nodes/Group.h>
+
+#include <vector>
+
+// collect the children of the groups at splitLevel depth of Group nesting, the subgraphs that readers/writers such as
+// the .vsgc and .vsgl formats store separately
+struct FindSubgraphs : public vsg::Inherit<vsg::ConstVisitor, FindSubgraphs>
+{
+    explicit FindSubgraphs(uint32_t in_splitLevel) :
+        splitLevel(in_splitLevel) {}
+
+    uint32_t splitLevel = 0;
+    uint32_t level = 0;
+    std::vector<const vsg::Node*> subgraphs;
+
+    void apply(const vsg::Node& node) override
+    {
+        node.traverse(*this);
+    }
+
+    void apply(const vsg::Group& group) override
+    {
+        if (level >= splitLevel)
+        {
+            for (auto& child : group.children) subgraphs.push_back(child.get());
+            return;
+        }
+
+        ++level;
+        group.traverse(*this);
+        --level;
+    }
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+
+#ifndef _WIN32
+#    include <unistd.h>
+#endif
+
+// resident set size of the process in bytes, 0 where not supported.
+inline int64_t residentSetSize()
+{
+#ifdef __linux__
+    std::ifstream fin("/proc/self/statm");
+    int64_t totalPages = 0, residentPages = 0;
+    if (fin >> totalPages >> residentPages) return residentPages * static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+
+// Instruction sets available to the SIMD kernels.
+// SSE2 is part of x86-64 so is always compiled in, AVX is compiled with a function target attribute on GCC/Clang and selected at runtime
+// when the CPU supports it, as is usual for binaries built for the baseline architecture. NEON is part of AArch64.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    include <immintrin.h>
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define VSGMATHS_SSE 1
+#    endif
+#    if defined(__GNUC__) || defined(__clang__)
+#        define VSGMATHS_AVX 1
+#        define VSGMATHS_AVX_TARGET __attribute__((target("avx")))
+#    elif defined(__AVX__)
+#        define VSGMATHS_AVX 1
+#        define VSGMATHS_AVX_TARGET
+#    endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define VSGMATHS_NEON 1
+#endif
+
+namespace simd
+{
+
+    enum Kernel
+    {
+        SCALAR,
+        SSE,
+        AVX,
+        NEON
+    };
+
+    /// return true if the kernel has been compiled in and the CPU supports it.
+    inline bool supported(Kernel kernel)
+    {
+        switch (kernel)
+        {
+        case SCALAR: return true;
+#if defined(VSGMATHS_SSE)
+        case SSE: return true;
+#endif
+#if defined(VSGMATHS_AVX)
+#    if defined(__GNUC__) || defined(__clang__)
+        case AVX: return __builtin_cpu_supports("avx");
+#    else
+        case AVX: return true;
+#    endif
+#endif
+#if defined(VSGMATHS_NEON)
+        case NEON: return true;
+#endif
+        default: return false;
+        }
+    }
+
+    inline const char* name(Kernel kernel)
+    {
+        switch (kernel)
+        {
+        case SSE: return "SSE";
+        case AVX: return "AVX";
+        case NEON: return "NEON";
+        default: return "scalar";
+        }
+    }
+
+    /// widest supported kernel
+    inline Kernel bestKernel()
+    {
+        for (auto kernel : {AVX, SSE, NEON})
+        {
+            if (supported(kernel)) return kernel;
+        }
+        return SCALAR;
+    }
+
+    //
+    // Lane types wrapping a SIMD register, so that a template written once runs several inputs at once, one per lane.
+    // Comparisons return a mask with all the bits of a lane set where true, for use with select().
+    //
+#if defined(VSGMATHS_SSE)
+    struct SSEFloat
+    {
+        using value_type = float;
+        static constexpr size_t width = 4;
+        __m128 v;
+
+        static SSEFloat load(const float* ptr) { return {_mm_loadu_ps(ptr)}; }
+        static SSEFloat set(float value) { return {_mm_set1_ps(value)}; }
+        void store(float* ptr) const { _mm_storeu_ps(ptr, v); }
+    };
+    inline SSEFloat operator+(SSEFloat lhs, SSEFloat rhs) { return {_mm_add_ps(lhs.v, rhs.v)}; }
+    inline SSEFloat operator-(SSEFloat lhs, SSEFloat rhs) { return {_mm_sub_ps(lhs.v, rhs.v)}; }
+    inline SSEFloat operator*(SSEFloat lhs, SSEFloat rhs) { return {_mm_mul_ps(lhs.v, rhs.v)}; }
+    inline SSEFloat operator/(SSEFloat lhs, SSEFloat rhs) { return {_mm_div_ps(lhs.v, rhs.v)}; }
+
+    struct SSEDouble
+    {
+        using value_type = double;
+        static constexpr size_t width = 2;
+        __m128d v;
+
+        static SSEDouble load(const double* ptr) { return {_mm_loadu_pd(ptr)}; }
+        static SSEDouble set(double value) { return {_mm_set1_pd(value)}; }
+        void store(double* ptr) const { _mm_storeu_pd(ptr, v); }
+    };
+    inline SSEDouble operator+(SSEDouble lhs, SSEDouble rhs) { return {_mm_add_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator-(SSEDouble lhs, SSEDouble rhs) { return {_mm_sub_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator*(SSEDouble lhs, SSEDouble rhs) { return {_mm_mul_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator/(SSEDouble lhs, SSEDouble rhs) { return {_mm_div_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator-(SSEDouble value) { return {_mm_xor_pd(value.v, _mm_set1_pd(-0.0))}; }
+    inline SSEDouble operator<(SSEDouble lhs, SSEDouble rhs) { return {_mm_cmplt_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator>(SSEDouble lhs, SSEDouble rhs) { return {_mm_cmpgt_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator==(SSEDouble lhs, SSEDouble rhs) { return {_mm_cmpeq_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator<=(SSEDouble lhs, SSEDouble rhs) { return {_mm_cmple_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator>=(SSEDouble lhs, SSEDouble rhs) { return {_mm_cmpge_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator!=(SSEDouble lhs, SSEDouble rhs) { return {_mm_cmpneq_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator|(SSEDouble lhs, SSEDouble rhs) { return {_mm_or_pd(lhs.v, rhs.v)}; }
+    inline SSEDouble operator&(SSEDouble lhs, SSEDouble rhs) { return {_mm_and_pd(lhs.v, rhs.v)}; }
+    // operands ordered to match std::min and std::max, returning lhs when either is NaN
+    inline SSEDouble min(SSEDouble lhs, SSEDouble rhs) { return {_mm_min_pd(rhs.v, lhs.v)}; }
+    inline SSEDouble max(SSEDouble lhs, SSEDouble rhs) { return {_mm_max_pd(rhs.v, lhs.v)}; }
+    /// bit i set where lane i of the mask is set
+    inline int bits(SSEDouble mask) { return _mm_movemask_pd(mask.v); }
+    inline SSEDouble select(SSEDouble mask, SSEDouble lhs, SSEDouble rhs) { return {_mm_or_pd(_mm_and_pd(mask.v, lhs.v), _mm_andnot_pd(mask.v, rhs.v))}; }
+    inline SSEDouble sqrt(SSEDouble value) { return {_mm_sqrt_pd(value.v)}; }
+    inline SSEDouble abs(SSEDouble value) { return {_mm_andnot_pd(_mm_set1_pd(-0.0), value.v)}; }
+    // round to nearest by adding and subtracting 1.5 * 2^52, valid for |value| < 2^51, as SSE2 has no round instruction
+    inline SSEDouble round(SSEDouble value)
+    {
+        const __m128d magic = _mm_set1_pd(6755399441055744.0);
+        return {_mm_sub_pd(_mm_add_pd(value.v, magic), magic)};
+    }
+#endif
+
+#if defined(VSGMATHS_NEON)
+    struct NEONFloat
+    {
+        using value_type = float;
+        static constexpr size_t width = 4;
+        float32x4_t v;
+
+        static NEONFloat load(const float* ptr) { return {vld1q_f32(ptr)}; }
+        static NEONFloat set(float value) { return {vdupq_n_f32(value)}; }
+        void store(float* ptr) const { vst1q_f32(ptr, v); }
+    };
+    inline NEONFloat operator+(NEONFloat lhs, NEONFloat rhs) { return {vaddq_f32(lhs.v, rhs.v)}; }
+    inline NEONFloat operator-(NEONFloat lhs, NEONFloat rhs) { return {vsubq_f32(lhs.v, rhs.v)}; }
+    inline NEONFloat operator*(NEONFloat lhs, NEONFloat rhs) { return {vmulq_f32(lhs.v, rhs.v)}; }
+    inline NEONFloat operator/(NEONFloat lhs, NEONFloat rhs) { return {vdivq_f32(lhs.v, rhs.v)}; }
+
+    struct NEONDouble
+    {
+        using value_type = double;
+        static constexpr size_t width = 2;
+        float64x2_t v;
+
+        static NEONDouble load(const double* ptr) { return {vld1q_f64(ptr)}; }
+        static NEONDouble set(double value) { return {vdupq_n_f64(value)}; }
+        void store(double* ptr) const { vst1q_f64(ptr, v); }
+    };
+    inline NEONDouble operator+(NEONDouble lhs, NEONDouble rhs) { return {vaddq_f64(lhs.v, rhs.v)}; }
+    inline NEONDouble operator-(NEONDouble lhs, NEONDouble rhs) { return {vsubq_f64(lhs.v, rhs.v)}; }
+    inline NEONDouble operator*(NEONDouble lhs, NEONDouble rhs) { return {vmulq_f64(lhs.v, rhs.v)}; }
+    inline NEONDouble operator/(NEONDouble lhs, NEONDouble rhs) { return {vdivq_f64(lhs.v, rhs.v)}; }
+    inline NEONDouble operator-(NEONDouble value) { return {vnegq_f64(value.v)}; }
+    inline NEONDouble operator<(NEONDouble lhs, NEONDouble rhs) { return {vreinterpretq_f64_u64(vcltq_f64(lhs.v, rhs.v))}; }
+    inline NEONDouble operator>(NEONDouble lhs, NEONDouble rhs) { return {vreinterpretq_f64_u64(vcgtq_f64(lhs.v, rhs.v))}; }
+    inline NEONDouble operator==(NEONDouble lhs, NEONDouble rhs) { return {vreinterpretq_f64_u64(vceqq_f64(lhs.v, rhs.v))}; }
+    inline NEONDouble operator<=(NEONDouble lhs, NEONDouble rhs) { return {vreinterpretq_f64_u64(vcleq_f64(lhs.v, rhs.v))}; }
+    inline NEONDouble operator>=(NEONDouble lhs, NEONDouble rhs) { return {vreinterpretq_f64_u64(vcgeq_f64(lhs.v, rhs.v))}; }
+    inline NEONDouble operator!=(NEONDouble lhs, NEONDouble rhs) { return {vreinterpretq_f64_u32(vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(lhs.v, rhs.v))))}; }
+    inline NEONDouble operator|(NEONDouble lhs, NEONDouble rhs) { return {vreinterpretq_f64_u64(vorrq_u64(vreinterpretq_u64_f64(lhs.v), vreinterpretq_u64_f64(rhs.v)))}; }
+    inline NEONDouble operator&(NEONDouble lhs, NEONDouble rhs) { return {vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(lhs.v), vreinterpretq_u64_f64(rhs.v)))}; }
+    // selected by comparison to match std::min and std::max, returning lhs when either is NaN, as vminq/vmaxq return NaN
+    inline NEONDouble min(NEONDouble lhs, NEONDouble rhs) { return {vbslq_f64(vcltq_f64(rhs.v, lhs.v), rhs.v, lhs.v)}; }
+    inline NEONDouble max(NEONDouble lhs, NEONDouble rhs) { return {vbslq_f64(vcltq_f64(lhs.v, rhs.v), rhs.v, lhs.v)}; }
+    /// bit i set where lane i of the mask is set
+    inline int bits(NEONDouble mask)
+    {
+        uint64x2_t m = vreinterpretq_u64_f64(mask.v);
+        return static_cast<int>((vgetq_lane_u64(m, 0) & 1) | ((vgetq_lane_u64(m, 1) & 1) << 1));
+    }
+    inline NEONDouble select(NEONDouble mask, NEONDouble lhs, NEONDouble rhs) { return {vbslq_f64(vreinterpretq_u64_f64(mask.v), lhs.v, rhs.v)}; }
+    inline NEONDouble sqrt(NEONDouble value) { return {vsqrtq_f64(value.v)}; }
+    inline NEONDouble abs(NEONDouble value) { return {vabsq_f64(value.v)}; }
+    inline NEONDouble round(NEONDouble value) { return {vrndnq_f64(value.v)}; }
+#endif
+
+} // namespace simd
@@ -0,0 +1,119 @@
+#include "BVHLineSegmentIntersector.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <typeinfo>
+
+using namespace bvh;
+
+namespace
+{
+    using IndexRatios = decltype(vsg::LineSegmentIntersector::Intersection::indexRatios);
+
+    /// BVHs shared by all the intersectors, keyed by the arrays and index range they were built from.
+    /// Each BVH holds references to its arrays so their addresses can't be reused while the entry exists.
+    using BVHKey = std::tuple<const vsg::Data*, const vsg::Data*, uint32_t, uint32_t>;
+
+    std::mutex s_cacheMutex;
+    std::map<BVHKey, vsg::ref_ptr<TriangleBVH>> s_cache;
+
+    /// number of cache hits between prunes, so BVHs of expired paged geometry are released even when nothing new is being built
+    constexpr uint32_t s_pruneInterval = 256;
+    uint32_t s_hitsSincePrune = 0;
+
+    /// release the BVHs of arrays only referenced by the cached BVHs themselves
+    void pruneCache()
+    {
+        std::map<const vsg::Data*, unsigned int> cacheReferences;
+        for (auto& [key, bvh] : s_cache)
+        {
+            ++cacheReferences[bvh->vertexData()];
+            ++cacheReferences[bvh->indexData()];
+        }
+
+        for (auto itr = s_cache.begin(); itr != s_cache.end();)
+        {
+            auto& bvh = itr->second;
+            if (bvh->vertexData()->referenceCount() == cacheReferences[bvh->vertexData()] || bvh->indexData()->referenceCount() == cacheReferences[bvh->indexData()])
+                itr = s_cache.erase(itr);
+            else
+                ++itr;
+        }
+
+        s_hitsSincePrune = 0;
+    }
+} // namespace
+
+BVHLineSegmentIntersector::BVHLineSegmentIntersector(const vsg::dvec3& s, const vsg::dvec3& e, vsg::ref_ptr<vsg::ArrayState> initialArrayData) :
+    Inherit(s, e, initialArrayData)
+{
+}
+
+BVHLineSegmentIntersector::BVHLineSegmentIntersector(const vsg::Camera& camera, int32_t x, int32_t y, vsg::ref_ptr<vsg::ArrayState> initialArrayData) :
+    Inherit(camera, x, y, initialArrayData)
+{
+}
+
+vsg::ref_ptr<TriangleBVH> BVHLineSegmentIntersector::getOrCreateBVH(const vsg::VertexIndexDraw& vid, const vsg::vec3Array& vertices, const vsg::Data& indices)
+{
+    BVHKey key(&vertices, &indices, vid.firstIndex, vid.indexCount);
+    {
+        std::scoped_lock<std::mutex> lock(s_cacheMutex);
+        auto itr = s_cache.find(key);
+        if (itr != s_cache.end() && itr->second->valid(vertices, indices, vid.firstIndex, vid.indexCount))
+        {
+            auto bvh = itr->second;
+            if (++s_hitsSincePrune >= s_pruneInterval) pruneCache();
+            return bvh;
+        }
+
+        // release the BVHs of geometry that has since been deleted on every miss, as misses are rare and followed by a build
+        pruneCache();
+    }
+
+    // build outside the lock so large meshes don't block queries on other geometry, concurrent builds of the same mesh are harmless
+    auto bvh = TriangleBVH::create();
+    if (!bvh->build(vertices, indices, vid.firstIndex, vid.indexCount)) return {};
+
+    std::scoped_lock<std::mutex> lock(s_cacheMutex);
+    s_cache[key] = bvh;
+    return bvh;
+}
+
+vsg::ref_ptr<TriangleBVH> BVHLineSegmentIntersector::getOrCreateBVH(const vsg::VertexIndexDraw& vid, const vsg::ArrayState& arrayState, uint32_t minimumTriangles)
+{
+    // the BVH holds the vertices as stored, so can only be used when the ArrayState doesn't reposition them
+    auto indices = vid.indices ? vid.indices->data : vsg::ref_ptr<vsg::Data>();
+    bool useBVH = arrayState.vertices && indices && vid.instanceCount <= 1 && typeid(arrayState) == typeid(vsg::ArrayState) &&
+                  arrayState.topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST && vid.indexCount / 3 >= minimumTriangles;
+
+    return useBVH ? getOrCreateBVH(vid, *arrayState.vertices, *indices) : vsg::ref_ptr<TriangleBVH>();
+}
+
+void BVHLineSegmentIntersector::apply(const vsg::VertexIndexDraw& vid)
+{
+    auto& arrayState = *arrayStateStack.back();
+    arrayState.apply(vid);
+
+    auto bvh = getOrCreateBVH(vid, arrayState, minimumTriangles);
+    if (!bvh)
+    {
+        vsg::LineSegmentIntersector::apply(vid);
+        return;
+    }
+
+    auto& lineSegment = _lineSegmentStack.back();
+    auto direction = lineSegment.end - lineSegment.start;
+
+    // match the node path the base Intersector reports for the drawable
+    _nodePath.push_back(&vid);
+
+    bvh->intersect(lineSegment.start, lineSegment.end, [&](uint32_t triangle, double ratio, double u, double v) {
+        auto index = &(bvh->indices[triangle * 3]);
+        IndexRatios indexRatios{{index[0], 1.0 - u - v}, {index[1], u}, {index[2], v}};
+        add(lineSegment.start + direction * ratio, ratio, indexRatios, vid.firstInstance);
+    });
+
+    _nodePath.pop_back();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "TriangleBVH.h"
+
+namespace bvh
+{
+
+    /// LineSegmentIntersector that tests VertexIndexDraw triangle lists against a TriangleBVH rather than every triangle.
+    /// The BVH is built on first use and held in a cache shared by all the intersectors, keyed by the vertex and index arrays so the
+    /// scene graph isn't modified, then rebuilt when the arrays are dirtied. Geometry the BVH can't represent, such as instanced or
+    /// billboarded vertices, small meshes and non triangle list topologies, falls back to the standard LineSegmentIntersector.
+    class BVHLineSegmentIntersector : public vsg::Inherit<vsg::LineSegmentIntersector, BVHLineSegmentIntersector>
+    {
+    public:
+        BVHLineSegmentIntersector(const vsg::dvec3& s, const vsg::dvec3& e, vsg::ref_ptr<vsg::ArrayState> initialArrayData = {});
+        BVHLineSegmentIntersector(const vsg::Camera& camera, int32_t x, int32_t y, vsg::ref_ptr<vsg::ArrayState> initialArrayData = {});
+
+        /// meshes with fewer triangles are tested directly.
+        uint32_t minimumTriangles = 64;
+
+        /// return the cached BVH of the VertexIndexDraw's arrays, building it if it's missing or out of date.
+        static vsg::ref_ptr<TriangleBVH> getOrCreateBVH(const vsg::VertexIndexDraw& vid, const vsg::vec3Array& vertices, const vsg::Data& indices);
+
+        /// return the cached BVH of the VertexIndexDraw with the arrays arrayState has been applied to, or null if the BVH can't represent it
+        /// or it has fewer than minimumTriangles triangles. Used by all the intersectors so they share the same BVHs.
+        static vsg::ref_ptr<TriangleBVH> getOrCreateBVH(const vsg::VertexIndexDraw& vid, const vsg::ArrayState& arrayState, uint32_t minimumTriangles);
+
+        using vsg::LineSegmentIntersector::apply;
+        void apply(const vsg::VertexIndexDraw& vid) override;
+    };
+
+} // namespace bvh
+
+EVSG_type_name(bvh::BVHLineSegmentIntersector);
@@ -0,0 +1,230 @@
+#include "BVHPolytopeIntersector.h"
+#include "BVHLineSegmentIntersector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace bvh;
+
+namespace
+{
+    enum Containment
+    {
+        OUTSIDE,
+        INTERSECTING,
+        INSIDE
+    };
+
+    Containment classify(const std::vector<vsg::dplane>& polytope, const TriangleBVH::Node& node)
+    {
+        auto containment = INSIDE;
+        for (auto& plane : polytope)
+        {
+            // corners of the box furthest along and against the plane's normal
+            vsg::dvec3 positive(plane.n.x >= 0.0 ? node.max.x : node.min.x, plane.n.y >= 0.0 ? node.max.y : node.min.y, plane.n.z >= 0.0 ? node.max.z : node.min.z);
+            vsg::dvec3 negative(plane.n.x >= 0.0 ? node.min.x : node.max.x, plane.n.y >= 0.0 ? node.min.y : node.max.y, plane.n.z >= 0.0 ? node.min.z : node.max.z);
+            if (vsg::distance(plane, positive) < 0.0) return OUTSIDE;
+            if (vsg::distance(plane, negative) < 0.0) containment = INTERSECTING;
+        }
+        return containment;
+    }
+
+    double distanceToBox(const vsg::dvec3& point, const TriangleBVH::Node& node)
+    {
+        vsg::dvec3 delta;
+        for (int c = 0; c < 3; ++c)
+        {
+            delta[c] = std::max(std::max(static_cast<double>(node.min[c]) - point[c], point[c] - static_cast<double>(node.max[c])), 0.0);
+        }
+        return vsg::length(delta);
+    }
+} // namespace
+
+BVHPolytopeIntersector::BVHPolytopeIntersector(const std::vector<vsg::dplane>& in_polytope, vsg::ref_ptr<vsg::ArrayState> initialArrayData) :
+    Inherit(in_polytope, initialArrayData),
+    _frameStack(1),
+    _maxDistance(std::numeric_limits<double>::max())
+{
+}
+
+BVHPolytopeIntersector::BVHPolytopeIntersector(const vsg::Camera& camera, double xMin, double yMin, double xMax, double yMax, vsg::ref_ptr<vsg::ArrayState> initialArrayData) :
+    Inherit(camera, xMin, yMin, xMax, yMax, initialArrayData),
+    _frameStack(1),
+    _maxDistance(std::numeric_limits<double>::max())
+{
+    if (camera.viewMatrix) referencePoint = camera.viewMatrix->inverse() * vsg::dvec3(0.0, 0.0, 0.0);
+}
+
+void BVHPolytopeIntersector::pushTransform(const vsg::Transform& transform)
+{
+    vsg::PolytopeIntersector::pushTransform(transform);
+
+    Frame frame;
+    frame.localToWorld = transform.transform(_frameStack.back().localToWorld);
+    frame.worldToLocal = vsg::inverse(frame.localToWorld);
+
+    // |worldToLocal * v| <= frobenius(worldToLocal) * |v|, so its reciprocal bounds how much the transform can shrink a distance
+    double sum = 0.0;
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int r = 0; r < 3; ++r) sum += frame.worldToLocal[c][r] * frame.worldToLocal[c][r];
+    }
+    frame.minimumScale = sum > 0.0 ? 1.0 / std::sqrt(sum) : 0.0;
+
+    _frameStack.push_back(frame);
+}
+
+void BVHPolytopeIntersector::popTransform()
+{
+    vsg::PolytopeIntersector::popTransform();
+    _frameStack.pop_back();
+}
+
+bool BVHPolytopeIntersector::beyondNearest(double localDistance) const
+{
+    return mode == NEAREST_INTERSECTIONS && localDistance * _frameStack.back().minimumScale > _maxDistance;
+}
+
+bool BVHPolytopeIntersector::intersects(const vsg::dsphere& bs)
+{
+    if (finished()) return false;
+
+    if (mode == NEAREST_INTERSECTIONS && bs.valid())
+    {
+        auto localReference = _frameStack.back().worldToLocal * referencePoint;
+        if (beyondNearest(vsg::length(bs.center - localReference) - bs.radius)) return false;
+    }
+
+    return vsg::PolytopeIntersector::intersects(bs);
+}
+
+void BVHPolytopeIntersector::prune()
+{
+    if (mode == ANY_INTERSECTION)
+    {
+        if (intersections.size() > 1) intersections.resize(1);
+    }
+    else if (mode == NEAREST_INTERSECTIONS)
+    {
+        auto distance = [&](const vsg::ref_ptr<Intersection>& intersection) { return vsg::length(intersection->worldIntersection - referencePoint); };
+        std::sort(intersections.begin(), intersections.end(), [&](auto& lhs, auto& rhs) { return distance(lhs) < distance(rhs); });
+
+        if (intersections.size() >= maxIntersections)
+        {
+            intersections.resize(maxIntersections);
+            if (!intersections.empty()) _maxDistance = distance(intersections.back());
+        }
+    }
+}
+
+void BVHPolytopeIntersector::intersectBVH(const TriangleBVH& bvh, uint32_t instanceIndex)
+{
+    if (bvh.nodes.empty()) return;
+
+    auto& polytope = _polytopeStack.back();
+    auto localReference = _frameStack.back().worldToLocal * referencePoint;
+
+    // nodes to visit with whether their parent was wholly inside the polytope
+    std::vector<std::pair<uint32_t, bool>> stack{{0, false}};
+    while (!stack.empty() && !finished())
+    {
+        auto [nodeIndex, inside] = stack.back();
+        stack.pop_back();
+
+        auto& node = bvh.nodes[nodeIndex];
+        ++numNodesVisited;
+
+        if (!inside)
+        {
+            auto containment = classify(polytope, node);
+            if (containment == OUTSIDE) continue;
+            inside = (containment == INSIDE);
+        }
+
+        if (mode == NEAREST_INTERSECTIONS && beyondNearest(distanceToBox(localReference, node))) continue;
+
+        if (node.count == 0)
+        {
+            stack.emplace_back(node.first, inside);
+            stack.emplace_back(node.first + 1, inside);
+            continue;
+        }
+
+        for (uint32_t triangle = node.first; triangle < node.first + node.count && !finished(); ++triangle)
+        {
+            ++numTrianglesTested;
+
+            _clipped.assign({vsg::dvec3(bvh.positions[triangle * 3]), vsg::dvec3(bvh.positions[triangle * 3 + 1]), vsg::dvec3(bvh.positions[triangle * 3 + 2])});
+            if (!inside)
+            {
+                // Sutherland–Hodgman clip of the triangle against each plane
+                for (auto& plane : polytope)
+                {
+                    _clipBuffer.clear();
+                    for (size_t i = 0; i < _clipped.size(); ++i)
+                    {
+                        auto& a = _clipped[i];
+                        auto& b = _clipped[(i + 1) % _clipped.size()];
+                        double da = vsg::distance(plane, a);
+                        double db = vsg::distance(plane, b);
+                        if (da >= 0.0) _clipBuffer.push_back(a);
+                        if ((da >= 0.0) != (db >= 0.0)) _clipBuffer.push_back(a + (b - a) * (da / (da - db)));
+                    }
+                    _clipped.swap(_clipBuffer);
+                    if (_clipped.empty()) break;
+                }
+                if (_clipped.empty()) continue;
+            }
+
+            vsg::dvec3 center;
+            for (auto& v : _clipped) center += v;
+            center = center / static_cast<double>(_clipped.size());
+
+            auto index = &(bvh.indices[triangle * 3]);
+            add(center, std::vector<uint32_t>{index[0], index[1], index[2]}, instanceIndex);
+        }
+
+        // tighten the nearest distance as intersections accumulate so the rest of the mesh can be culled
+        if (mode == NEAREST_INTERSECTIONS && intersections.size() >= maxIntersections * 2) prune();
+    }
+}
+
+void BVHPolytopeIntersector::apply(const vsg::VertexIndexDraw& vid)
+{
+    if (finished()) return;
+
+    auto& arrayState = *arrayStateStack.back();
+    arrayState.apply(vid);
+
+    auto bvh = BVHLineSegmentIntersector::getOrCreateBVH(vid, arrayState, minimumTriangles);
+    if (!bvh)
+    {
+        vsg::PolytopeIntersector::apply(vid);
+        return;
+    }
+
+    _nodePath.push_back(&vid);
+    intersectBVH(*bvh, vid.firstInstance);
+    _nodePath.pop_back();
+
+    prune();
+}
+
+bool BVHPolytopeIntersector::intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t firstInstance, uint32_t instanceCount)
+{
+    if (finished()) return false;
+
+    bool result = vsg::PolytopeIntersector::intersectDraw(firstVertex, vertexCount, firstInstance, instanceCount);
+    prune();
+    return result;
+}
+
+bool BVHPolytopeIntersector::intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount)
+{
+    if (finished()) return false;
+
+    bool result = vsg::PolytopeIntersector::intersectDrawIndexed(firstIndex, indexCount, firstInstance, instanceCount);
+    prune();
+    return result;
+}
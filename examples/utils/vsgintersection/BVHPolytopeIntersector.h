@@ -0,0 +1,78 @@
+#pragma once
+
+#include "TriangleBVH.h"
+
+namespace bvh
+{
+
+    /// PolytopeIntersector that culls the TriangleBVH cached on triangle list VertexIndexDraw against the polytope, so small pick regions
+    /// only clip the handful of triangles beneath them. Triangles in BVH nodes wholly inside the polytope are reported without clipping.
+    /// The query can stop at the first intersection or keep the nearest maxIntersections to referencePoint, culling subgraphs and BVH nodes
+    /// that can't contain anything nearer. Geometry the BVH can't represent falls back to the standard PolytopeIntersector.
+    class BVHPolytopeIntersector : public vsg::Inherit<vsg::PolytopeIntersector, BVHPolytopeIntersector>
+    {
+    public:
+        BVHPolytopeIntersector(const std::vector<vsg::dplane>& in_polytope, vsg::ref_ptr<vsg::ArrayState> initialArrayData = {});
+        BVHPolytopeIntersector(const vsg::Camera& camera, double xMin, double yMin, double xMax, double yMax, vsg::ref_ptr<vsg::ArrayState> initialArrayData = {});
+
+        enum Mode
+        {
+            ALL_INTERSECTIONS,
+            ANY_INTERSECTION,
+            NEAREST_INTERSECTIONS
+        };
+
+        Mode mode = ALL_INTERSECTIONS;
+
+        /// number of intersections kept by NEAREST_INTERSECTIONS, sorted nearest first.
+        size_t maxIntersections = 1;
+
+        /// world coordinate point that NEAREST_INTERSECTIONS measures distance from, the eye point when constructed from a Camera.
+        vsg::dvec3 referencePoint;
+
+        /// meshes with fewer triangles are tested directly.
+        uint32_t minimumTriangles = 64;
+
+        /// statistics for the BVH accelerated meshes
+        uint32_t numNodesVisited = 0;
+        uint32_t numTrianglesTested = 0;
+
+        using vsg::PolytopeIntersector::apply;
+        void apply(const vsg::VertexIndexDraw& vid) override;
+
+        void pushTransform(const vsg::Transform& transform) override;
+        void popTransform() override;
+
+        bool intersects(const vsg::dsphere& bs) override;
+
+        bool intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t firstInstance, uint32_t instanceCount) override;
+        bool intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount) override;
+
+    protected:
+        struct Frame
+        {
+            vsg::dmat4 localToWorld;
+            vsg::dmat4 worldToLocal;
+            double minimumScale = 1.0; // lower bound of world distance / local distance
+        };
+
+        /// return true if no more intersections are wanted.
+        bool finished() const { return mode == ANY_INTERSECTION && !intersections.empty(); }
+
+        /// return true if everything within the local bounds is further than the current furthest of the nearest intersections.
+        bool beyondNearest(double localDistance) const;
+
+        /// apply the mode's limits to the intersections found so far.
+        void prune();
+
+        void intersectBVH(const TriangleBVH& bvh, uint32_t instanceIndex);
+
+        std::vector<Frame> _frameStack;
+        double _maxDistance;
+        std::vector<vsg::dvec3> _clipped;
+        std::vector<vsg::dvec3> _clipBuffer;
+    };
+
+} // namespace bvh
+
+EVSG_type_name(bvh::BVHPolytopeIntersector);
@@ -0,0 +1,582 @@
+#include "BatchLineSegmentIntersector.h"
+#include "BVHLineSegmentIntersector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+using namespace bvh;
+
+namespace
+{
+    constexpr uint32_t s_noTriangle = ~0u;
+
+    /// line segments in structure of arrays layout so each group of lanes loads into a simd:: lane type,
+    /// unused lanes have a negative ratio so never intersect anything.
+    struct Packet
+    {
+        alignas(64) double startX[PacketSize];
+        alignas(64) double startY[PacketSize];
+        alignas(64) double startZ[PacketSize];
+        alignas(64) double directionX[PacketSize];
+        alignas(64) double directionY[PacketSize];
+        alignas(64) double directionZ[PacketSize];
+        alignas(64) double inverseX[PacketSize];
+        alignas(64) double inverseY[PacketSize];
+        alignas(64) double inverseZ[PacketSize];
+        alignas(64) double ratio[PacketSize];
+        alignas(64) double u[PacketSize];
+        alignas(64) double v[PacketSize];
+        alignas(64) uint32_t triangle[PacketSize];
+        uint32_t segment[PacketSize];
+        uint32_t count = 0;
+
+        void assign(uint32_t lane, uint32_t in_segment, const LineSegment& lineSegment, double maxRatio)
+        {
+            auto direction = lineSegment.end - lineSegment.start;
+            startX[lane] = lineSegment.start.x;
+            startY[lane] = lineSegment.start.y;
+            startZ[lane] = lineSegment.start.z;
+            directionX[lane] = direction.x;
+            directionY[lane] = direction.y;
+            directionZ[lane] = direction.z;
+            inverseX[lane] = 1.0 / direction.x;
+            inverseY[lane] = 1.0 / direction.y;
+            inverseZ[lane] = 1.0 / direction.z;
+            ratio[lane] = maxRatio;
+            u[lane] = 0.0;
+            v[lane] = 0.0;
+            triangle[lane] = s_noTriangle;
+            segment[lane] = in_segment;
+        }
+
+        void clear(uint32_t lane)
+        {
+            assign(lane, 0, LineSegment{}, -1.0);
+        }
+    };
+
+    //
+    // SCALAR kernel, testing a segment at a time
+    //
+
+    // slab test of every lane against the node's bounds
+    bool intersectBounds(const Packet& packet, const TriangleBVH::Node& node)
+    {
+        const double minX = node.min.x, minY = node.min.y, minZ = node.min.z;
+        const double maxX = node.max.x, maxY = node.max.y, maxZ = node.max.z;
+
+        int mask = 0;
+        for (uint32_t lane = 0; lane < PacketSize; ++lane)
+        {
+            double tx0 = (minX - packet.startX[lane]) * packet.inverseX[lane];
+            double tx1 = (maxX - packet.startX[lane]) * packet.inverseX[lane];
+            double ty0 = (minY - packet.startY[lane]) * packet.inverseY[lane];
+            double ty1 = (maxY - packet.startY[lane]) * packet.inverseY[lane];
+            double tz0 = (minZ - packet.startZ[lane]) * packet.inverseZ[lane];
+            double tz1 = (maxZ - packet.startZ[lane]) * packet.inverseZ[lane];
+
+            double tmin = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), 0.0));
+            double tmax = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), packet.ratio[lane]));
+            mask |= (tmin <= tmax) ? 1 : 0;
+        }
+        return mask != 0;
+    }
+
+    // Möller–Trumbore of every lane against one triangle, keeping the nearest intersection of each lane
+    void intersectTriangle(Packet& packet, uint32_t triangle, const vsg::vec3* corners)
+    {
+        const double v0x = corners[0].x, v0y = corners[0].y, v0z = corners[0].z;
+        const double e1x = corners[1].x - v0x, e1y = corners[1].y - v0y, e1z = corners[1].z - v0z;
+        const double e2x = corners[2].x - v0x, e2y = corners[2].y - v0y, e2z = corners[2].z - v0z;
+
+        for (uint32_t lane = 0; lane < PacketSize; ++lane)
+        {
+            double px = packet.directionY[lane] * e2z - packet.directionZ[lane] * e2y;
+            double py = packet.directionZ[lane] * e2x - packet.directionX[lane] * e2z;
+            double pz = packet.directionX[lane] * e2y - packet.directionY[lane] * e2x;
+            double det = e1x * px + e1y * py + e1z * pz;
+            double inverseDet = 1.0 / det;
+
+            double sx = packet.startX[lane] - v0x;
+            double sy = packet.startY[lane] - v0y;
+            double sz = packet.startZ[lane] - v0z;
+            double u = (sx * px + sy * py + sz * pz) * inverseDet;
+
+            double qx = sy * e1z - sz * e1y;
+            double qy = sz * e1x - sx * e1z;
+            double qz = sx * e1y - sy * e1x;
+            double v = (packet.directionX[lane] * qx + packet.directionY[lane] * qy + packet.directionZ[lane] * qz) * inverseDet;
+            double t = (e2x * qx + e2y * qy + e2z * qz) * inverseDet;
+
+            bool hit = det != 0.0 && u >= 0.0 && v >= 0.0 && (u + v) <= 1.0 && t >= 0.0 && t <= packet.ratio[lane];
+            packet.ratio[lane] = hit ? t : packet.ratio[lane];
+            packet.u[lane] = hit ? u : packet.u[lane];
+            packet.v[lane] = hit ? v : packet.v[lane];
+            packet.triangle[lane] = hit ? triangle : packet.triangle[lane];
+        }
+    }
+
+    //
+    // SIMD kernels, testing L::width segments at a time with the same arithmetic as the SCALAR kernel so they find the same intersections
+    //
+
+    template<class L>
+    bool intersectBounds(const Packet& packet, const TriangleBVH::Node& node)
+    {
+        const L minX = L::set(node.min.x), minY = L::set(node.min.y), minZ = L::set(node.min.z);
+        const L maxX = L::set(node.max.x), maxY = L::set(node.max.y), maxZ = L::set(node.max.z);
+        const L zero = L::set(0.0);
+
+        for (uint32_t lane = 0; lane < PacketSize; lane += L::width)
+        {
+            L startX = L::load(packet.startX + lane), startY = L::load(packet.startY + lane), startZ = L::load(packet.startZ + lane);
+            L inverseX = L::load(packet.inverseX + lane), inverseY = L::load(packet.inverseY + lane), inverseZ = L::load(packet.inverseZ + lane);
+
+            L tx0 = (minX - startX) * inverseX;
+            L tx1 = (maxX - startX) * inverseX;
+            L ty0 = (minY - startY) * inverseY;
+            L ty1 = (maxY - startY) * inverseY;
+            L tz0 = (minZ - startZ) * inverseZ;
+            L tz1 = (maxZ - startZ) * inverseZ;
+
+            L tmin = max(max(min(tx0, tx1), min(ty0, ty1)), max(min(tz0, tz1), zero));
+            L tmax = min(min(max(tx0, tx1), max(ty0, ty1)), min(max(tz0, tz1), L::load(packet.ratio + lane)));
+            if (bits(tmin <= tmax) != 0) return true;
+        }
+        return false;
+    }
+
+    template<class L>
+    void intersectTriangle(Packet& packet, uint32_t triangle, const vsg::vec3* corners)
+    {
+        const double v0x = corners[0].x, v0y = corners[0].y, v0z = corners[0].z;
+        const L e1x = L::set(corners[1].x - v0x), e1y = L::set(corners[1].y - v0y), e1z = L::set(corners[1].z - v0z);
+        const L e2x = L::set(corners[2].x - v0x), e2y = L::set(corners[2].y - v0y), e2z = L::set(corners[2].z - v0z);
+        const L zero = L::set(0.0), one = L::set(1.0);
+
+        for (uint32_t lane = 0; lane < PacketSize; lane += L::width)
+        {
+            L directionX = L::load(packet.directionX + lane), directionY = L::load(packet.directionY + lane), directionZ = L::load(packet.directionZ + lane);
+
+            L px = directionY * e2z - directionZ * e2y;
+            L py = directionZ * e2x - directionX * e2z;
+            L pz = directionX * e2y - directionY * e2x;
+            L det = e1x * px + e1y * py + e1z * pz;
+            L inverseDet = one / det;
+
+            L sx = L::load(packet.startX + lane) - L::set(v0x);
+            L sy = L::load(packet.startY + lane) - L::set(v0y);
+            L sz = L::load(packet.startZ + lane) - L::set(v0z);
+            L u = (sx * px + sy * py + sz * pz) * inverseDet;
+
+            L qx = sy * e1z - sz * e1y;
+            L qy = sz * e1x - sx * e1z;
+            L qz = sx * e1y - sy * e1x;
+            L v = (directionX * qx + directionY * qy + directionZ * qz) * inverseDet;
+            L t = (e2x * qx + e2y * qy + e2z * qz) * inverseDet;
+
+            L ratio = L::load(packet.ratio + lane);
+            L hit = (det != zero) & (u >= zero) & (v >= zero) & ((u + v) <= one) & (t >= zero) & (t <= ratio);
+            int hitBits = bits(hit);
+            if (hitBits == 0) continue;
+
+            select(hit, t, ratio).store(packet.ratio + lane);
+            select(hit, u, L::load(packet.u + lane)).store(packet.u + lane);
+            select(hit, v, L::load(packet.v + lane)).store(packet.v + lane);
+            for (uint32_t i = 0; i < L::width; ++i)
+            {
+                if (hitBits & (1 << i)) packet.triangle[lane + i] = triangle;
+            }
+        }
+    }
+
+    /// lane type for the SCALAR kernel
+    struct ScalarLanes
+    {
+    };
+
+    template<class L>
+    struct PacketTests
+    {
+        static bool intersectBounds(const Packet& packet, const TriangleBVH::Node& node) { return ::intersectBounds<L>(packet, node); }
+        static void intersectTriangle(Packet& packet, uint32_t triangle, const vsg::vec3* corners) { ::intersectTriangle<L>(packet, triangle, corners); }
+    };
+
+    template<>
+    struct PacketTests<ScalarLanes>
+    {
+        static bool intersectBounds(const Packet& packet, const TriangleBVH::Node& node) { return ::intersectBounds(packet, node); }
+        static void intersectTriangle(Packet& packet, uint32_t triangle, const vsg::vec3* corners) { ::intersectTriangle(packet, triangle, corners); }
+    };
+
+    template<class L>
+    void intersectBVH(Packet& packet, const TriangleBVH& bvh)
+    {
+        if (bvh.nodes.empty()) return;
+
+        uint32_t stack[128];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            auto& node = bvh.nodes[stack[--stackSize]];
+            if (!PacketTests<L>::intersectBounds(packet, node)) continue;
+
+            if (node.count > 0)
+            {
+                for (uint32_t triangle = node.first; triangle < node.first + node.count; ++triangle)
+                {
+                    PacketTests<L>::intersectTriangle(packet, triangle, &bvh.positions[triangle * 3]);
+                }
+            }
+            else
+            {
+                // visit the child nearest the first segment's start first so later nodes are culled by the shortened ratios
+                auto& left = bvh.nodes[node.first];
+                auto& right = bvh.nodes[node.first + 1];
+                auto separation = (right.min + right.max) - (left.min + left.max);
+                int axis = (std::abs(separation.x) > std::abs(separation.y)) ? 0 : 1;
+                if (std::abs(separation.z) > std::abs(separation[axis])) axis = 2;
+
+                double direction = (axis == 0) ? packet.directionX[0] : ((axis == 1) ? packet.directionY[0] : packet.directionZ[0]);
+                bool leftFirst = (direction * separation[axis]) >= 0.0;
+                stack[stackSize++] = leftFirst ? node.first + 1 : node.first;
+                stack[stackSize++] = leftFirst ? node.first : node.first + 1;
+            }
+        }
+    }
+
+    template<class L>
+    void intersectPacket(Packet& packet, const TriangleBVH* bvh, const std::vector<vsg::vec3>& positions, uint32_t numTriangles)
+    {
+        static_assert(std::is_same_v<L, ScalarLanes> || PacketSize % L::width == 0, "PacketSize must be a multiple of the lane width");
+
+        if (bvh)
+        {
+            intersectBVH<L>(packet, *bvh);
+        }
+        else
+        {
+            for (uint32_t triangle = 0; triangle < numTriangles; ++triangle)
+            {
+                PacketTests<L>::intersectTriangle(packet, triangle, &positions[triangle * 3]);
+            }
+        }
+    }
+
+    /// Intersector that visits every VertexIndexDraw to look up its BVH, without testing any geometry.
+    class CollectBVHs : public vsg::Inherit<vsg::Intersector, CollectBVHs>
+    {
+    public:
+        explicit CollectBVHs(uint32_t in_minimumTriangles) :
+            minimumTriangles(in_minimumTriangles) {}
+
+        uint32_t minimumTriangles;
+        BVHMap bvhs;
+
+        using vsg::Intersector::apply;
+        void apply(const vsg::VertexIndexDraw& vid) override
+        {
+            auto& arrayState = *arrayStateStack.back();
+            arrayState.apply(vid);
+
+            // a VertexIndexDraw shared between subgraphs with different array states only uses a BVH if it suits all of them
+            auto bvh = BVHLineSegmentIntersector::getOrCreateBVH(vid, arrayState, minimumTriangles);
+            auto [itr, inserted] = bvhs.emplace(&vid, bvh);
+            if (!inserted && itr->second != bvh) itr->second = {};
+        }
+
+        void pushTransform(const vsg::Transform&) override {}
+        void popTransform() override {}
+        bool intersects(const vsg::dsphere&) override { return true; }
+        bool intersectDraw(uint32_t, uint32_t, uint32_t, uint32_t) override { return false; }
+        bool intersectDrawIndexed(uint32_t, uint32_t, uint32_t, uint32_t) override { return false; }
+    };
+
+    struct IntersectBatch : public vsg::Inherit<vsg::Operation, IntersectBatch>
+    {
+        IntersectBatch(const vsg::Node* in_scene, const BVHMap* in_bvhs, const LineSegment* in_first, const LineSegment* in_last, BatchLineSegmentIntersector::Hit* in_hits, simd::Kernel in_kernel, vsg::ref_ptr<vsg::Latch> in_latch) :
+            scene(in_scene),
+            bvhs(in_bvhs),
+            first(in_first),
+            last(in_last),
+            hits(in_hits),
+            kernel(in_kernel),
+            latch(in_latch) {}
+
+        const vsg::Node* scene;
+        const BVHMap* bvhs;
+        const LineSegment* first;
+        const LineSegment* last;
+        BatchLineSegmentIntersector::Hit* hits;
+        simd::Kernel kernel;
+        vsg::ref_ptr<vsg::Latch> latch;
+
+        void run() override
+        {
+            auto intersector = BatchLineSegmentIntersector::create(first, last);
+            intersector->bvhs = bvhs;
+            intersector->kernel = kernel;
+            scene->accept(*intersector);
+            std::move(intersector->hits.begin(), intersector->hits.end(), hits);
+
+            if (latch) latch->count_down();
+        }
+    };
+} // namespace
+
+BatchLineSegmentIntersector::BatchLineSegmentIntersector(const std::vector<LineSegment>& in_lineSegments, vsg::ref_ptr<vsg::ArrayState> initialArrayData) :
+    BatchLineSegmentIntersector(in_lineSegments.data(), in_lineSegments.data() + in_lineSegments.size(), initialArrayData)
+{
+}
+
+BatchLineSegmentIntersector::BatchLineSegmentIntersector(const LineSegment* first, const LineSegment* last, vsg::ref_ptr<vsg::ArrayState> initialArrayData) :
+    Inherit(initialArrayData),
+    lineSegments(first, last),
+    hits(lineSegments.size())
+{
+    _localToWorldStack.emplace_back();
+    _localLineSegmentsStack.push_back(lineSegments);
+}
+
+void BatchLineSegmentIntersector::pushTransform(const vsg::Transform& transform)
+{
+    auto localToWorld = transform.transform(_localToWorldStack.back());
+    auto worldToLocal = vsg::inverse(localToWorld);
+    _localToWorldStack.push_back(localToWorld);
+
+    // transform the whole batch once rather than once per segment traversal
+    std::vector<LineSegment> localLineSegments(lineSegments.size());
+    for (size_t i = 0; i < lineSegments.size(); ++i)
+    {
+        localLineSegments[i].start = worldToLocal * lineSegments[i].start;
+        localLineSegments[i].end = worldToLocal * lineSegments[i].end;
+    }
+    _localLineSegmentsStack.push_back(std::move(localLineSegments));
+}
+
+void BatchLineSegmentIntersector::popTransform()
+{
+    _localToWorldStack.pop_back();
+    _localLineSegmentsStack.pop_back();
+}
+
+bool BatchLineSegmentIntersector::intersects(const vsg::dsphere& bs)
+{
+    if (!bs.valid()) return false;
+
+    // ratios are preserved by the transforms so local segments can be compared against the nearest intersection found so far
+    auto& localLineSegments = _localLineSegmentsStack.back();
+    double radius2 = bs.radius * bs.radius;
+    for (size_t i = 0; i < localLineSegments.size(); ++i)
+    {
+        auto& lineSegment = localLineSegments[i];
+        auto direction = lineSegment.end - lineSegment.start;
+        auto offset = lineSegment.start - bs.center;
+
+        double c = vsg::dot(offset, offset) - radius2;
+        if (c <= 0.0) return true;
+
+        double a = vsg::dot(direction, direction);
+        double b = vsg::dot(offset, direction);
+        double discriminant = b * b - a * c;
+        if (a == 0.0 || discriminant < 0.0) continue;
+
+        double root = std::sqrt(discriminant);
+        double entry = (-b - root) / a;
+        double exit = (-b + root) / a;
+        double maxRatio = hits[i].valid ? hits[i].ratio : 1.0;
+        if (exit >= 0.0 && entry <= maxRatio) return true;
+    }
+    return false;
+}
+
+bool BatchLineSegmentIntersector::intersectTriangles(const TriangleBVH* bvh, const std::vector<vsg::vec3>& positions, const std::vector<uint32_t>& indices, uint32_t instanceIndex)
+{
+    auto& localLineSegments = _localLineSegmentsStack.back();
+    auto& localToWorld = _localToWorldStack.back();
+    uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+    bool intersected = false;
+
+    auto packetKernel = simd::supported(kernel) ? kernel : simd::SCALAR;
+
+    Packet packet;
+    for (uint32_t first = 0; first < localLineSegments.size(); first += PacketSize)
+    {
+        packet.count = std::min(PacketSize, static_cast<uint32_t>(localLineSegments.size()) - first);
+        for (uint32_t lane = 0; lane < PacketSize; ++lane)
+        {
+            uint32_t segment = first + lane;
+            if (lane < packet.count)
+                packet.assign(lane, segment, localLineSegments[segment], hits[segment].valid ? hits[segment].ratio : 1.0);
+            else
+                packet.clear(lane);
+        }
+
+        // the double lanes gain little from 256 bit registers once the packet is loaded, so AVX uses the SSE lanes
+        switch (packetKernel)
+        {
+#if defined(VSGMATHS_SSE)
+        case simd::SSE:
+        case simd::AVX: intersectPacket<simd::SSEDouble>(packet, bvh, positions, numTriangles); break;
+#endif
+#if defined(VSGMATHS_NEON)
+        case simd::NEON: intersectPacket<simd::NEONDouble>(packet, bvh, positions, numTriangles); break;
+#endif
+        default: intersectPacket<ScalarLanes>(packet, bvh, positions, numTriangles); break;
+        }
+
+        for (uint32_t lane = 0; lane < packet.count; ++lane)
+        {
+            if (packet.triangle[lane] == s_noTriangle) continue;
+
+            auto& lineSegment = localLineSegments[packet.segment[lane]];
+            auto& hit = hits[packet.segment[lane]];
+            auto index = &indices[packet.triangle[lane] * 3];
+            double ratio = packet.ratio[lane], u = packet.u[lane], v = packet.v[lane];
+
+            hit.valid = true;
+            hit.ratio = ratio;
+            hit.localIntersection = lineSegment.start + (lineSegment.end - lineSegment.start) * ratio;
+            hit.worldIntersection = localToWorld * hit.localIntersection;
+            hit.localToWorld = localToWorld;
+            hit.nodePath = _nodePath;
+            hit.arrays = arrayStateStack.back()->arrays;
+            hit.indexRatios = IndexRatios{{index[0], 1.0 - u - v}, {index[1], u}, {index[2], v}};
+            hit.instanceIndex = instanceIndex;
+            intersected = true;
+        }
+    }
+
+    return intersected;
+}
+
+void BatchLineSegmentIntersector::apply(const vsg::VertexIndexDraw& vid)
+{
+    auto& arrayState = *arrayStateStack.back();
+    arrayState.apply(vid);
+
+    vsg::ref_ptr<TriangleBVH> bvh;
+    if (bvhs)
+    {
+        if (auto itr = bvhs->find(&vid); itr != bvhs->end()) bvh = itr->second;
+    }
+    else
+    {
+        bvh = BVHLineSegmentIntersector::getOrCreateBVH(vid, arrayState, minimumTriangles);
+    }
+    if (!bvh)
+    {
+        vsg::Intersector::apply(vid);
+        return;
+    }
+
+    _nodePath.push_back(&vid);
+    intersectTriangles(bvh, bvh->positions, bvh->indices, vid.firstInstance);
+    _nodePath.pop_back();
+}
+
+bool BatchLineSegmentIntersector::intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t firstInstance, uint32_t instanceCount)
+{
+    auto& arrayState = *arrayStateStack.back();
+    if (arrayState.topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST || vertexCount < 3) return false;
+
+    bool intersected = false;
+    uint32_t lastInstance = firstInstance + std::max(1u, instanceCount);
+    for (uint32_t instanceIndex = firstInstance; instanceIndex < lastInstance; ++instanceIndex)
+    {
+        auto vertices = arrayState.vertexArray(instanceIndex);
+        if (!vertices) continue;
+
+        uint32_t lastVertex = std::min(firstVertex + (vertexCount / 3) * 3, static_cast<uint32_t>(vertices->size()));
+        std::vector<vsg::vec3> positions;
+        std::vector<uint32_t> indices;
+        for (uint32_t i = firstVertex; i + 2 < lastVertex; i += 3)
+        {
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                positions.push_back(vertices->at(i + corner));
+                indices.push_back(i + corner);
+            }
+        }
+
+        if (intersectTriangles(nullptr, positions, indices, instanceIndex)) intersected = true;
+    }
+    return intersected;
+}
+
+bool BatchLineSegmentIntersector::intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount)
+{
+    auto& arrayState = *arrayStateStack.back();
+    if (arrayState.topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST || indexCount < 3) return false;
+    if (!ushort_indices && !uint_indices) return false;
+
+    uint32_t numIndices = ushort_indices ? static_cast<uint32_t>(ushort_indices->size()) : static_cast<uint32_t>(uint_indices->size());
+    uint32_t lastIndex = std::min(firstIndex + (indexCount / 3) * 3, numIndices);
+
+    bool intersected = false;
+    uint32_t lastInstance = firstInstance + std::max(1u, instanceCount);
+    for (uint32_t instanceIndex = firstInstance; instanceIndex < lastInstance; ++instanceIndex)
+    {
+        auto vertices = arrayState.vertexArray(instanceIndex);
+        if (!vertices) continue;
+
+        std::vector<vsg::vec3> positions;
+        std::vector<uint32_t> indices;
+        for (uint32_t i = firstIndex; i + 2 < lastIndex; i += 3)
+        {
+            uint32_t triangle[3];
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                triangle[corner] = ushort_indices ? ushort_indices->at(i + corner) : uint_indices->at(i + corner);
+            }
+            if (triangle[0] >= vertices->size() || triangle[1] >= vertices->size() || triangle[2] >= vertices->size()) continue;
+
+            for (auto index : triangle)
+            {
+                positions.push_back(vertices->at(index));
+                indices.push_back(index);
+            }
+        }
+
+        if (intersectTriangles(nullptr, positions, indices, instanceIndex)) intersected = true;
+    }
+    return intersected;
+}
+
+BVHMap bvh::collectBVHs(const vsg::Node& scene, uint32_t minimumTriangles)
+{
+    auto collect = CollectBVHs::create(minimumTriangles);
+    scene.accept(*collect);
+    return std::move(collect->bvhs);
+}
+
+std::vector<BatchLineSegmentIntersector::Hit> bvh::intersect(const vsg::Node& scene, const std::vector<LineSegment>& lineSegments, uint32_t batchSize, vsg::ref_ptr<vsg::OperationThreads> operationThreads, simd::Kernel kernel)
+{
+    std::vector<BatchLineSegmentIntersector::Hit> hits(lineSegments.size());
+    if (lineSegments.empty()) return hits;
+
+    // look up each BVH once, rather than once per batch, so the batches only read them
+    auto bvhs = collectBVHs(scene);
+
+    batchSize = std::max(1u, batchSize);
+    size_t numBatches = (lineSegments.size() + batchSize - 1) / batchSize;
+
+    auto latch = operationThreads ? vsg::Latch::create(static_cast<int>(numBatches)) : vsg::ref_ptr<vsg::Latch>();
+    for (size_t batch = 0; batch < numBatches; ++batch)
+    {
+        size_t first = batch * batchSize;
+        size_t last = std::min(first + batchSize, lineSegments.size());
+        auto operation = IntersectBatch::create(&scene, &bvhs, lineSegments.data() + first, lineSegments.data() + last, hits.data() + first, kernel, latch);
+        if (operationThreads)
+            operationThreads->add(operation);
+        else
+            operation->run();
+    }
+
+    if (latch) latch->wait();
+
+    return hits;
+}
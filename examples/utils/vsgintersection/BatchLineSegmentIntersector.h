@@ -0,0 +1,93 @@
+#pragma once
+
+#include "SIMD.h"
+#include "TriangleBVH.h"
+
+#include <unordered_map>
+
+namespace bvh
+{
+
+    /// number of line segments tested together against each BVH node and triangle, held as structure of arrays so they load straight into the simd:: lanes.
+    constexpr uint32_t PacketSize = 8;
+
+    /// BVHs of the VertexIndexDraw in a scene, null for those tested without one.
+    using BVHMap = std::unordered_map<const vsg::VertexIndexDraw*, vsg::ref_ptr<TriangleBVH>>;
+
+    struct LineSegment
+    {
+        vsg::dvec3 start;
+        vsg::dvec3 end;
+    };
+
+    /// Intersector that finds the nearest intersection of each of a batch of line segments in a single traversal of the scene graph.
+    /// The segments are transformed into the local coordinates of each Transform once for the whole batch, bounding spheres are culled
+    /// unless one of the segments reaches them before its nearest intersection so far, and triangles are tested PacketSize segments at a time
+    /// using the SIMD lanes of the selected kernel, with the SCALAR kernel testing a segment at a time.
+    /// Triangle list VertexIndexDraw use the TriangleBVH cached by BVHLineSegmentIntersector, other triangle lists are tested directly.
+    class BatchLineSegmentIntersector : public vsg::Inherit<vsg::Intersector, BatchLineSegmentIntersector>
+    {
+    public:
+        using NodePath = decltype(vsg::LineSegmentIntersector::Intersection::nodePath);
+        using IndexRatios = decltype(vsg::LineSegmentIntersector::Intersection::indexRatios);
+
+        struct Hit
+        {
+            bool valid = false;
+            double ratio = 1.0;
+            vsg::dvec3 localIntersection;
+            vsg::dvec3 worldIntersection;
+            vsg::dmat4 localToWorld;
+            NodePath nodePath;
+            decltype(vsg::LineSegmentIntersector::Intersection::arrays) arrays;
+            IndexRatios indexRatios;
+            uint32_t instanceIndex = 0;
+        };
+
+        explicit BatchLineSegmentIntersector(const std::vector<LineSegment>& in_lineSegments, vsg::ref_ptr<vsg::ArrayState> initialArrayData = {});
+        BatchLineSegmentIntersector(const LineSegment* first, const LineSegment* last, vsg::ref_ptr<vsg::ArrayState> initialArrayData = {});
+
+        /// world coordinate line segments
+        std::vector<LineSegment> lineSegments;
+
+        /// nearest intersection of each line segment
+        std::vector<Hit> hits;
+
+        /// VertexIndexDraw with fewer triangles are tested without a BVH.
+        uint32_t minimumTriangles = 64;
+
+        /// instruction set used for the packet tests, unsupported kernels fall back to SCALAR.
+        simd::Kernel kernel = simd::bestKernel();
+
+        /// BVHs looked up before the traversal, used rather than BVHLineSegmentIntersector's cache so batches don't contend for its lock.
+        const BVHMap* bvhs = nullptr;
+
+        using vsg::Intersector::apply;
+        void apply(const vsg::VertexIndexDraw& vid) override;
+
+        void pushTransform(const vsg::Transform& transform) override;
+        void popTransform() override;
+
+        bool intersects(const vsg::dsphere& bs) override;
+
+        bool intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t firstInstance, uint32_t instanceCount) override;
+        bool intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount) override;
+
+    protected:
+        /// test the triangles against every line segment, using the BVH when provided, and record any nearer intersections.
+        bool intersectTriangles(const TriangleBVH* bvh, const std::vector<vsg::vec3>& positions, const std::vector<uint32_t>& indices, uint32_t instanceIndex);
+
+        std::vector<vsg::dmat4> _localToWorldStack;
+        std::vector<std::vector<LineSegment>> _localLineSegmentsStack;
+    };
+
+    /// return the BVH of every VertexIndexDraw in the scene, whatever its bounds, building those that are missing or out of date.
+    BVHMap collectBVHs(const vsg::Node& scene, uint32_t minimumTriangles = 64);
+
+    /// find the nearest intersection of each line segment, splitting them into batches of batchSize that are run on operationThreads when provided.
+    /// The BVHs are collected once before the batches are traversed.
+    std::vector<BatchLineSegmentIntersector::Hit> intersect(const vsg::Node& scene, const std::vector<LineSegment>& lineSegments, uint32_t batchSize, vsg::ref_ptr<vsg::OperationThreads> operationThreads = {}, simd::Kernel kernel = simd::bestKernel());
+
+} // namespace bvh
+
+EVSG_type_name(bvh::BatchLineSegmentIntersector);
@@ -0,0 +1,251 @@
+#include "SpatialGroup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace bvh;
+
+namespace
+{
+    bool contains(const vsg::dsphere& outer, const vsg::dsphere& inner)
+    {
+        return outer.radius >= 0.0 && vsg::length(inner.center - outer.center) + inner.radius <= outer.radius;
+    }
+
+    void add(vsg::dbox& box, const vsg::dsphere& bound)
+    {
+        box.add(bound.center - vsg::dvec3(bound.radius, bound.radius, bound.radius));
+        box.add(bound.center + vsg::dvec3(bound.radius, bound.radius, bound.radius));
+    }
+
+    double enclosingRadius(const vsg::dvec3& centre, const vsg::dsphere& bound)
+    {
+        return vsg::length(bound.center - centre) + bound.radius;
+    }
+} // namespace
+
+SpatialGroup::SpatialGroup(const vsg::dbox& extents)
+{
+    if (!extents.valid()) return;
+
+    auto halfExtents = (extents.max - extents.min) * 0.5;
+
+    _root = std::make_unique<Cell>();
+    _root->group = vsg::CullGroup::create();
+    _root->centre = (extents.min + extents.max) * 0.5;
+    _root->halfSize = std::max({halfExtents.x, halfExtents.y, halfExtents.z, std::numeric_limits<double>::min()});
+    _root->group->bound = vsg::dsphere(_root->centre, 0.0);
+    _numCells = 1;
+
+    addChild(_root->group);
+}
+
+void SpatialGroup::insert(vsg::ref_ptr<vsg::Node> node)
+{
+    if (!node) return;
+
+    if (auto cullNode = node.cast<vsg::CullNode>())
+    {
+        insert(node, cullNode->bound);
+    }
+    else
+    {
+        auto bounds = vsg::visit<vsg::ComputeBounds>(node).bounds;
+        if (bounds.valid())
+            insert(node, vsg::dsphere((bounds.min + bounds.max) * 0.5, vsg::length(bounds.max - bounds.min) * 0.5));
+        else
+            insert(node, vsg::dsphere());
+    }
+}
+
+void SpatialGroup::insert(vsg::ref_ptr<vsg::Node> node, const vsg::dsphere& bound)
+{
+    if (!node) return;
+
+    if (_locations.count(node.get()) != 0)
+    {
+        update(node.get(), bound);
+        return;
+    }
+
+    auto& location = _locations[node.get()];
+    location.cullNode = node.cast<vsg::CullNode>();
+    if (location.cullNode)
+        location.cullNode->bound = bound;
+    else
+        location.cullNode = vsg::CullNode::create(bound, node);
+
+    place(location);
+}
+
+bool SpatialGroup::update(const vsg::Node* node, const vsg::dsphere& bound)
+{
+    auto itr = _locations.find(node);
+    if (itr == _locations.end()) return false;
+
+    auto& location = itr->second;
+    location.cullNode->bound = bound;
+
+    if (fits(location.cell, bound))
+    {
+        refit(location.cell);
+    }
+    else
+    {
+        unplace(location);
+        place(location);
+    }
+    return true;
+}
+
+bool SpatialGroup::remove(const vsg::Node* node)
+{
+    auto itr = _locations.find(node);
+    if (itr == _locations.end()) return false;
+
+    unplace(itr->second);
+    _locations.erase(itr);
+    return true;
+}
+
+bool SpatialGroup::fits(const Cell* cell, const vsg::dsphere& bound) const
+{
+    // objects kept as direct children only stay there while they don't fit the root cell
+    if (!cell) return !_root || !fits(_root.get(), bound);
+
+    if (!bound.valid() || bound.radius > cell->halfSize) return false;
+
+    auto offset = bound.center - cell->centre;
+    return std::abs(offset.x) <= cell->halfSize && std::abs(offset.y) <= cell->halfSize && std::abs(offset.z) <= cell->halfSize;
+}
+
+void SpatialGroup::place(Location& location)
+{
+    if (!_root || !fits(_root.get(), location.cullNode->bound))
+    {
+        location.cell = nullptr;
+        addChild(location.cullNode);
+        return;
+    }
+
+    place(location, _root.get());
+}
+
+void SpatialGroup::place(Location& location, Cell* cell)
+{
+    auto& bound = location.cullNode->bound;
+
+    // descend through split cells while the bound fits the octant holding its centre, which it does once its radius is within the octant's half size
+    while (cell->split && bound.radius <= cell->halfSize * 0.5)
+    {
+        auto offset = bound.center - cell->centre;
+        size_t octantIndex = (offset.x > 0.0 ? 1 : 0) | (offset.y > 0.0 ? 2 : 0) | (offset.z > 0.0 ? 4 : 0);
+
+        auto& octant = cell->octants[octantIndex];
+        if (!octant)
+        {
+            double quarterSize = cell->halfSize * 0.5;
+            octant = std::make_unique<Cell>();
+            octant->group = vsg::CullGroup::create();
+            octant->centre = cell->centre + vsg::dvec3((octantIndex & 1) ? quarterSize : -quarterSize, (octantIndex & 2) ? quarterSize : -quarterSize, (octantIndex & 4) ? quarterSize : -quarterSize);
+            octant->halfSize = quarterSize;
+            octant->depth = cell->depth + 1;
+            octant->parent = cell;
+            octant->group->bound = vsg::dsphere(octant->centre, -1.0); // invalid until refit
+            cell->group->addChild(octant->group);
+            ++_numCells;
+        }
+        cell = octant.get();
+    }
+
+    location.cell = cell;
+    cell->group->addChild(location.cullNode);
+    cell->objects.push_back(&location);
+
+    // inserting can only grow the bounds, and refit() stops at the first ancestor it doesn't change
+    if (!contains(cell->group->bound, bound)) refit(cell);
+
+    if (!cell->split && cell->objects.size() > maxObjectsPerCell && cell->depth < maxDepth) split(cell);
+}
+
+void SpatialGroup::split(Cell* cell)
+{
+    cell->split = true;
+
+    // move down the objects small enough to fit an octant
+    auto objects = std::move(cell->objects);
+    cell->objects.clear();
+    for (auto& location : objects)
+    {
+        if (location->cullNode->bound.radius <= cell->halfSize * 0.5)
+        {
+            auto& siblings = cell->group->children;
+            siblings.erase(std::find(siblings.begin(), siblings.end(), location->cullNode));
+            place(*location, cell);
+        }
+        else
+        {
+            cell->objects.push_back(location);
+        }
+    }
+
+    // the cell's bound was last fit to the objects it held before the split, which needn't contain the octants they moved to
+    refit(cell);
+}
+
+void SpatialGroup::unplace(Location& location)
+{
+    auto cell = location.cell;
+    auto& siblings = cell ? cell->group->children : children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), location.cullNode));
+    location.cell = nullptr;
+
+    if (!cell) return;
+
+    cell->objects.erase(std::find(cell->objects.begin(), cell->objects.end(), &location));
+
+    // remove cells left empty
+    while (cell->parent && cell->group->children.empty())
+    {
+        auto parent = cell->parent;
+        auto& parentChildren = parent->group->children;
+        parentChildren.erase(std::find(parentChildren.begin(), parentChildren.end(), cell->group));
+        for (auto& octant : parent->octants)
+        {
+            if (octant.get() == cell) octant.reset();
+        }
+        --_numCells;
+        cell = parent;
+    }
+
+    refit(cell);
+}
+
+void SpatialGroup::refit(Cell* cell)
+{
+    for (; cell; cell = cell->parent)
+    {
+        vsg::dbox box;
+        for (auto& object : cell->objects) add(box, object->cullNode->bound);
+        for (auto& octant : cell->octants)
+        {
+            if (octant) add(box, octant->group->bound);
+        }
+
+        vsg::dsphere bound(cell->centre, 0.0);
+        if (box.valid())
+        {
+            bound.center = (box.min + box.max) * 0.5;
+            for (auto& object : cell->objects) bound.radius = std::max(bound.radius, enclosingRadius(bound.center, object->cullNode->bound));
+            for (auto& octant : cell->octants)
+            {
+                if (octant) bound.radius = std::max(bound.radius, enclosingRadius(bound.center, octant->group->bound));
+            }
+        }
+
+        // the ancestors' bounds only change if this one does
+        if (bound.center == cell->group->bound.center && bound.radius == cell->group->bound.radius) return;
+        cell->group->bound = bound;
+    }
+}
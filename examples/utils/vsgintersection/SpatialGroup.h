@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+namespace bvh
+{
+
+    /// Group that sorts the objects inserted into it into a loose octree of vsg::CullGroup cells, so the RecordTraversal's view frustum
+    /// culling and the Intersectors' bounding sphere tests skip whole regions of the scene rather than testing every object of a flat Group.
+    /// Cells split into octants once they hold more than maxObjectsPerCell objects, and an object goes in the smallest existing cell whose extents,
+    /// doubled, contain its bounding sphere, so objects can move within their cell without being reinserted.
+    /// Cell bounds are refit to their contents as objects are inserted, moved and removed, and empty cells are removed.
+    /// Objects are wrapped in a vsg::CullNode, unless they are already one, so each object is culled individually.
+    /// Objects outside the extents, or larger than them, are kept as direct children. Use insert() rather than addChild() to add objects.
+    /// SpatialGroup isn't registered with the vsg::ObjectFactory and its cells and object locations aren't serialized, so a SpatialGroup
+    /// written to file isn't recreated when it's read back.
+    class SpatialGroup : public vsg::Inherit<vsg::Group, SpatialGroup>
+    {
+    public:
+        explicit SpatialGroup(const vsg::dbox& extents = {});
+
+        size_t maxObjectsPerCell = 16;
+        uint32_t maxDepth = 16;
+
+        /// insert node with the bounding sphere of its subgraph, computing it with vsg::ComputeBounds unless node is a vsg::CullNode
+        void insert(vsg::ref_ptr<vsg::Node> node);
+        void insert(vsg::ref_ptr<vsg::Node> node, const vsg::dsphere& bound);
+
+        /// update the bound of a node that has moved or changed size, moving it to another cell if it no longer fits its own
+        bool update(const vsg::Node* node, const vsg::dsphere& bound);
+
+        bool remove(const vsg::Node* node);
+
+        size_t numObjects() const { return _locations.size(); }
+        size_t numCells() const { return _numCells; }
+
+    protected:
+        struct Location;
+
+        struct Cell
+        {
+            vsg::ref_ptr<vsg::CullGroup> group;
+            vsg::dvec3 centre;
+            double halfSize = 0.0;
+            uint32_t depth = 0;
+            Cell* parent = nullptr;
+            bool split = false;
+            std::array<std::unique_ptr<Cell>, 8> octants;
+            std::vector<Location*> objects;
+        };
+
+        struct Location
+        {
+            Cell* cell = nullptr;
+            vsg::ref_ptr<vsg::CullNode> cullNode;
+        };
+
+        bool fits(const Cell* cell, const vsg::dsphere& bound) const;
+        void place(Location& location);
+        void place(Location& location, Cell* cell);
+        void unplace(Location& location);
+        void split(Cell* cell);
+        void refit(Cell* cell);
+
+        std::unique_ptr<Cell> _root;
+        size_t _numCells = 0;
+        std::unordered_map<const vsg::Node*, Location> _locations;
+    };
+
+} // namespace bvh
+
+EVSG_type_name(bvh::SpatialGroup);
@@ -0,0 +1,251 @@
+#include "TriangleBVH.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+using namespace bvh;
+
+namespace
+{
+    struct Bounds
+    {
+        vsg::vec3 min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+        vsg::vec3 max{-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+
+        void add(const vsg::vec3& v)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                min[c] = std::min(min[c], v[c]);
+                max[c] = std::max(max[c], v[c]);
+            }
+        }
+
+        void add(const Bounds& bounds)
+        {
+            add(bounds.min);
+            add(bounds.max);
+        }
+
+        bool valid() const { return min.x <= max.x; }
+
+        float area() const
+        {
+            if (!valid()) return 0.0f;
+            auto d = max - min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+    };
+
+    constexpr uint32_t s_numBins = 12;
+} // namespace
+
+bool TriangleBVH::build(const vsg::vec3Array& vertices, const vsg::Data& indexData, uint32_t firstIndex, uint32_t indexCount)
+{
+    auto ushortIndices = indexData.cast<vsg::ushortArray>();
+    auto uintIndices = indexData.cast<vsg::uintArray>();
+    if (!ushortIndices && !uintIndices) return false;
+
+    uint32_t endIndex = std::min(firstIndex + indexCount, static_cast<uint32_t>(indexData.valueCount()));
+    uint32_t numTriangles = endIndex > firstIndex ? (endIndex - firstIndex) / 3 : 0;
+
+    // an empty BVH would have a root with inverted bounds and no triangles, which queries would treat as an internal node
+    if (numTriangles == 0) return false;
+
+    std::vector<uint32_t> sourceIndices(numTriangles * 3);
+    for (uint32_t i = 0; i < sourceIndices.size(); ++i)
+    {
+        uint32_t index = ushortIndices ? ushortIndices->at(firstIndex + i) : uintIndices->at(firstIndex + i);
+        if (index >= vertices.size()) return false;
+        sourceIndices[i] = index;
+    }
+
+    std::vector<Bounds> triangleBounds(numTriangles);
+    std::vector<vsg::vec3> centroids(numTriangles);
+    for (uint32_t t = 0; t < numTriangles; ++t)
+    {
+        auto& v0 = vertices.at(sourceIndices[t * 3]);
+        auto& v1 = vertices.at(sourceIndices[t * 3 + 1]);
+        auto& v2 = vertices.at(sourceIndices[t * 3 + 2]);
+        triangleBounds[t].add(v0);
+        triangleBounds[t].add(v1);
+        triangleBounds[t].add(v2);
+        centroids[t] = (v0 + v1 + v2) / 3.0f;
+    }
+
+    std::vector<uint32_t> order(numTriangles);
+    std::iota(order.begin(), order.end(), 0);
+
+    nodes.clear();
+    nodes.reserve(numTriangles * 2);
+    nodes.emplace_back();
+    nodes[0].first = 0;
+    nodes[0].count = numTriangles;
+
+    // nodes to split with their depth
+    std::vector<std::pair<uint32_t, uint32_t>> toSplit{{0, 0}};
+    while (!toSplit.empty())
+    {
+        auto [nodeIndex, depth] = toSplit.back();
+        toSplit.pop_back();
+
+        uint32_t first = nodes[nodeIndex].first;
+        uint32_t count = nodes[nodeIndex].count;
+
+        Bounds bounds, centroidBounds;
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            bounds.add(triangleBounds[order[i]]);
+            centroidBounds.add(centroids[order[i]]);
+        }
+        nodes[nodeIndex].min = bounds.min;
+        nodes[nodeIndex].max = bounds.max;
+
+        if (count <= maxLeafSize || depth >= maxDepth) continue;
+
+        // find the lowest cost split over binned centroids on each axis
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        uint32_t bestBin = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+            if (extent <= 0.0f) continue;
+
+            Bounds binBounds[s_numBins];
+            uint32_t binCounts[s_numBins] = {};
+            float scale = static_cast<float>(s_numBins) / extent;
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                auto bin = std::min(s_numBins - 1, static_cast<uint32_t>((centroids[order[i]][axis] - centroidBounds.min[axis]) * scale));
+                binBounds[bin].add(triangleBounds[order[i]]);
+                ++binCounts[bin];
+            }
+
+            // sweep from the right to accumulate the cost of the right hand side of each split
+            float rightCosts[s_numBins] = {};
+            Bounds rightBounds;
+            uint32_t rightCount = 0;
+            for (uint32_t bin = s_numBins - 1; bin > 0; --bin)
+            {
+                rightBounds.add(binBounds[bin]);
+                rightCount += binCounts[bin];
+                rightCosts[bin] = static_cast<float>(rightCount) * rightBounds.area();
+            }
+
+            Bounds leftBounds;
+            uint32_t leftCount = 0;
+            for (uint32_t bin = 0; bin < s_numBins - 1; ++bin)
+            {
+                leftBounds.add(binBounds[bin]);
+                leftCount += binCounts[bin];
+                if (leftCount == 0 || leftCount == count) continue;
+
+                float cost = static_cast<float>(leftCount) * leftBounds.area() + rightCosts[bin + 1];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = bin;
+                }
+            }
+        }
+
+        // keep as a leaf if no split reduces the cost, unless the leaf would be too large to test efficiently
+        float leafCost = static_cast<float>(count) * bounds.area();
+        if (bestAxis < 0 || (bestCost >= leafCost && count <= maxLeafSize * 4)) continue;
+
+        float extent = centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis];
+        float scale = static_cast<float>(s_numBins) / extent;
+        auto middle = std::partition(order.begin() + first, order.begin() + first + count, [&](uint32_t t) {
+            auto bin = std::min(s_numBins - 1, static_cast<uint32_t>((centroids[t][bestAxis] - centroidBounds.min[bestAxis]) * scale));
+            return bin <= bestBin;
+        });
+
+        uint32_t leftCount = static_cast<uint32_t>(middle - (order.begin() + first));
+        if (leftCount == 0 || leftCount == count) continue;
+
+        auto left = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+        nodes.emplace_back();
+        nodes[left].first = first;
+        nodes[left].count = leftCount;
+        nodes[left + 1].first = first + leftCount;
+        nodes[left + 1].count = count - leftCount;
+
+        nodes[nodeIndex].first = left;
+        nodes[nodeIndex].count = 0;
+
+        toSplit.emplace_back(left, depth + 1);
+        toSplit.emplace_back(left + 1, depth + 1);
+    }
+
+    // copy the triangles into leaf order
+    positions.resize(numTriangles * 3);
+    indices.resize(numTriangles * 3);
+    for (uint32_t i = 0; i < numTriangles; ++i)
+    {
+        for (uint32_t corner = 0; corner < 3; ++corner)
+        {
+            auto index = sourceIndices[order[i] * 3 + corner];
+            indices[i * 3 + corner] = index;
+            positions[i * 3 + corner] = vertices.at(index);
+        }
+    }
+
+    _vertexData = &vertices;
+    _indexData = &indexData;
+    vertices.getModifiedCount(_vertexModifiedCount);
+    indexData.getModifiedCount(_indexModifiedCount);
+    _firstIndex = firstIndex;
+    _indexCount = indexCount;
+
+    return true;
+}
+
+bool TriangleBVH::valid(const vsg::vec3Array& vertices, const vsg::Data& indexData, uint32_t firstIndex, uint32_t indexCount) const
+{
+    return _vertexData.get() == &vertices && _indexData.get() == &indexData && _firstIndex == firstIndex && _indexCount == indexCount &&
+           !vertices.differentModifiedCount(_vertexModifiedCount) && !indexData.differentModifiedCount(_indexModifiedCount);
+}
+
+bool TriangleBVH::intersectBounds(const Node& node, const vsg::dvec3& start, const vsg::dvec3& inverseDirection) const
+{
+    double tmin = 0.0;
+    double tmax = 1.0;
+    for (int c = 0; c < 3; ++c)
+    {
+        double t0 = (static_cast<double>(node.min[c]) - start[c]) * inverseDirection[c];
+        double t1 = (static_cast<double>(node.max[c]) - start[c]) * inverseDirection[c];
+        if (t0 > t1) std::swap(t0, t1);
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+        if (tmin > tmax) return false;
+    }
+    return true;
+}
+
+bool TriangleBVH::intersectTriangle(uint32_t triangle, const vsg::dvec3& start, const vsg::dvec3& direction, double& ratio, double& u, double& v) const
+{
+    // Möller–Trumbore with an unnormalized direction so the distance is the ratio along the segment
+    vsg::dvec3 v0(positions[triangle * 3]);
+    vsg::dvec3 e1 = vsg::dvec3(positions[triangle * 3 + 1]) - v0;
+    vsg::dvec3 e2 = vsg::dvec3(positions[triangle * 3 + 2]) - v0;
+
+    auto p = vsg::cross(direction, e2);
+    double det = vsg::dot(e1, p);
+    if (det == 0.0) return false;
+
+    double inverseDet = 1.0 / det;
+    auto s = start - v0;
+    u = vsg::dot(s, p) * inverseDet;
+    if (u < 0.0 || u > 1.0) return false;
+
+    auto q = vsg::cross(s, e1);
+    v = vsg::dot(direction, q) * inverseDet;
+    if (v < 0.0 || u + v > 1.0) return false;
+
+    ratio = vsg::dot(e2, q) * inverseDet;
+    return ratio >= 0.0 && ratio <= 1.0;
+}
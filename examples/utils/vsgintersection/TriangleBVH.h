@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vsg/all.h>
+
+namespace bvh
+{
+
+    /// Bounding volume hierarchy over the triangles of an indexed triangle list, built on the CPU using a binned surface area heuristic.
+    /// Triangle positions are copied into leaf order so a query touches contiguous memory, with the original vertex indices kept
+    /// alongside them for reporting intersections. The BVH holds references to the source arrays and records their modified counts,
+    /// so a cached BVH can be checked against the geometry and rebuilt after the arrays have been dirtied.
+    class TriangleBVH : public vsg::Inherit<vsg::Object, TriangleBVH>
+    {
+    public:
+        struct Node
+        {
+            vsg::vec3 min;
+            uint32_t first = 0; // first triangle for leaves, left child for internal nodes with the right child following it
+            vsg::vec3 max;
+            uint32_t count = 0; // number of triangles for leaves, 0 for internal nodes
+        };
+
+        std::vector<Node> nodes;
+        std::vector<vsg::vec3> positions; // three per triangle in leaf order
+        std::vector<uint32_t> indices;    // vertex indices matching positions
+
+        uint32_t maxLeafSize = 4;
+        uint32_t maxDepth = 64;
+
+        /// build from the triangles of vertices indexed by indexData (ushortArray or uintArray), returning false if the arrays aren't supported or hold no triangles.
+        bool build(const vsg::vec3Array& vertices, const vsg::Data& indexData, uint32_t firstIndex, uint32_t indexCount);
+
+        /// return true if the BVH was built from these arrays and they haven't been modified since.
+        bool valid(const vsg::vec3Array& vertices, const vsg::Data& indexData, uint32_t firstIndex, uint32_t indexCount) const;
+
+        uint32_t numTriangles() const { return static_cast<uint32_t>(indices.size() / 3); }
+
+        const vsg::Data* vertexData() const { return _vertexData.get(); }
+        const vsg::Data* indexData() const { return _indexData.get(); }
+
+        /// call callback(triangle, ratio, u, v) for every triangle intersected by the line segment from start to end,
+        /// where ratio is the distance along the segment and u, v the barycentric coordinates of the second and third vertices.
+        template<typename F>
+        void intersect(const vsg::dvec3& start, const vsg::dvec3& end, F callback) const
+        {
+            if (nodes.empty()) return;
+
+            vsg::dvec3 direction = end - start;
+            vsg::dvec3 inverseDirection(1.0 / direction.x, 1.0 / direction.y, 1.0 / direction.z);
+
+            uint32_t stack[128];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+
+            while (stackSize > 0)
+            {
+                auto& node = nodes[stack[--stackSize]];
+                if (!intersectBounds(node, start, inverseDirection)) continue;
+
+                if (node.count > 0)
+                {
+                    for (uint32_t triangle = node.first; triangle < node.first + node.count; ++triangle)
+                    {
+                        double ratio, u, v;
+                        if (intersectTriangle(triangle, start, direction, ratio, u, v)) callback(triangle, ratio, u, v);
+                    }
+                }
+                else
+                {
+                    stack[stackSize++] = node.first;
+                    stack[stackSize++] = node.first + 1;
+                }
+            }
+        }
+
+        bool intersectBounds(const Node& node, const vsg::dvec3& start, const vsg::dvec3& inverseDirection) const;
+        bool intersectTriangle(uint32_t triangle, const vsg::dvec3& start, const vsg::dvec3& direction, double& ratio, double& u, double& v) const;
+
+    protected:
+        vsg::ref_ptr<const vsg::Data> _vertexData;
+        vsg::ref_ptr<const vsg::Data> _indexData;
+        vsg::ModifiedCount _vertexModifiedCount;
+        vsg::ModifiedCount _indexModifiedCount;
+        uint32_t _firstIndex = 0;
+        uint32_t _indexCount = 0;
+    };
+
+} // namespace bvh
+
+EVSG_type_name(bvh::TriangleBVH);
@@ -5,6 +5,13 @@
 #endif
 
 #include <iostream>
+#include <random>
+#include <thread>
+
+#include "BVHLineSegmentIntersector.h"
+#include "BVHPolytopeIntersector.h"
+#include "BatchLineSegmentIntersector.h"
+#include "SpatialGroup.h"
 
 class IntersectionHandler : public vsg::Inherit<vsg::Visitor, IntersectionHandler>
 {
@@ -16,9 +23,13 @@ public:
     vsg::ref_ptr<vsg::Options> options;
     vsg::ref_ptr<vsg::Camera> camera;
     vsg::ref_ptr<vsg::Group> scenegraph;
+    vsg::ref_ptr<bvh::SpatialGroup> spatialGroup; // when set created shapes are inserted into it rather than added to the scenegraph
     vsg::ref_ptr<vsg::EllipsoidModel> ellipsoidModel;
     double scale = 1.0;
     bool verbose = true;
+    bool useBVH = false;
+    bvh::BVHPolytopeIntersector::Mode polytopeMode = bvh::BVHPolytopeIntersector::ALL_INTERSECTIONS;
+    size_t maxPolytopeIntersections = 1;
 
     IntersectionHandler(vsg::ref_ptr<vsg::Builder> in_builder, vsg::ref_ptr<vsg::Camera> in_camera, vsg::ref_ptr<vsg::Group> in_scenegraph, vsg::ref_ptr<vsg::EllipsoidModel> in_ellipsoidModel, double in_scale, vsg::ref_ptr<vsg::Options> in_options) :
         builder(in_builder),
@@ -65,27 +76,27 @@ public:
 
             if (keyPress.keyBase == 'b')
             {
-                scenegraph->addChild(builder->createBox(geom, state));
+                addShape(builder->createBox(geom, state));
             }
             else if (keyPress.keyBase == 'q')
             {
-                scenegraph->addChild(builder->createQuad(geom, state));
+                addShape(builder->createQuad(geom, state));
             }
             else if (keyPress.keyBase == 'c')
             {
-                scenegraph->addChild(builder->createCylinder(geom, state));
+                addShape(builder->createCylinder(geom, state));
             }
             else if (keyPress.keyBase == 'p')
             {
-                scenegraph->addChild(builder->createCapsule(geom, state));
+                addShape(builder->createCapsule(geom, state));
             }
             else if (keyPress.keyBase == 's')
             {
-                scenegraph->addChild(builder->createSphere(geom, state));
+                addShape(builder->createSphere(geom, state));
             }
             else if (keyPress.keyBase == 'n')
             {
-                scenegraph->addChild(builder->createCone(geom, state));
+                addShape(builder->createCone(geom, state));
             }
         }
 
@@ -102,6 +113,14 @@ public:
         }
     }
 
+    void addShape(vsg::ref_ptr<vsg::Node> shape)
+    {
+        if (spatialGroup)
+            spatialGroup->insert(shape);
+        else
+            scenegraph->addChild(shape);
+    }
+
     void apply(vsg::ButtonPressEvent& buttonPressEvent) override
     {
         lastPointerEvent = &buttonPressEvent;
@@ -123,7 +142,11 @@ public:
 
     void intersection_LineSegmentIntersector(vsg::PointerEvent& pointerEvent)
     {
-        auto intersector = vsg::LineSegmentIntersector::create(*camera, pointerEvent.x, pointerEvent.y);
+        vsg::ref_ptr<vsg::LineSegmentIntersector> intersector;
+        if (useBVH)
+            intersector = bvh::BVHLineSegmentIntersector::create(*camera, pointerEvent.x, pointerEvent.y);
+        else
+            intersector = vsg::LineSegmentIntersector::create(*camera, pointerEvent.x, pointerEvent.y);
 
         auto before_intersection = vsg::clock::now();
 
@@ -194,10 +217,30 @@ public:
         double yMin = static_cast<double>(pointerEvent.y) - size;
         double yMax = static_cast<double>(pointerEvent.y) + size;
 
-        auto intersector = vsg::PolytopeIntersector::create(*camera, xMin, yMin, xMax, yMax);
+        vsg::ref_ptr<vsg::PolytopeIntersector> intersector;
+        if (useBVH || polytopeMode != bvh::BVHPolytopeIntersector::ALL_INTERSECTIONS)
+        {
+            auto bvhIntersector = bvh::BVHPolytopeIntersector::create(*camera, xMin, yMin, xMax, yMax);
+            bvhIntersector->mode = polytopeMode;
+            bvhIntersector->maxIntersections = maxPolytopeIntersections;
+            intersector = bvhIntersector;
+        }
+        else
+        {
+            intersector = vsg::PolytopeIntersector::create(*camera, xMin, yMin, xMax, yMax);
+        }
+
+        auto before_intersection = vsg::clock::now();
+
         scenegraph->accept(*intersector);
 
-        if (verbose) std::cout << "intersection_PolytopeIntersector(" << pointerEvent.x << ", " << pointerEvent.y << ") " << intersector->intersections.size() << ")" << std::endl;
+        auto after_intersection = vsg::clock::now();
+
+        if (verbose)
+        {
+            std::cout << "intersection_PolytopeIntersector(" << pointerEvent.x << ", " << pointerEvent.y << ") " << intersector->intersections.size() << ") ";
+            std::cout << "time = " << std::chrono::duration<double, std::chrono::milliseconds::period>(after_intersection - before_intersection).count() << "ms" << std::endl;
+        }
 
         if (intersector->intersections.empty()) return;
 
@@ -248,6 +291,396 @@ protected:
     vsg::ref_ptr<vsg::LineSegmentIntersector::Intersection> lastIntersection;
 };
 
+// create a rippled grid mesh with the specified number of triangles
+vsg::ref_ptr<vsg::Node> createMesh(uint32_t numTriangles)
+{
+    auto size = std::max(1u, static_cast<uint32_t>(std::sqrt(static_cast<double>(numTriangles) / 2.0)));
+    auto vertices = vsg::vec3Array::create((size + 1) * (size + 1));
+    for (uint32_t r = 0; r <= size; ++r)
+    {
+        for (uint32_t c = 0; c <= size; ++c)
+        {
+            float x = static_cast<float>(c) / static_cast<float>(size);
+            float y = static_cast<float>(r) / static_cast<float>(size);
+            vertices->set(r * (size + 1) + c, vsg::vec3(x, y, 0.05f * std::sin(x * 40.0f) * std::cos(y * 30.0f)));
+        }
+    }
+
+    auto indices = vsg::uintArray::create(size * size * 6);
+    auto itr = indices->begin();
+    for (uint32_t r = 0; r < size; ++r)
+    {
+        for (uint32_t c = 0; c < size; ++c)
+        {
+            uint32_t i00 = r * (size + 1) + c;
+            uint32_t i10 = i00 + 1;
+            uint32_t i01 = i00 + size + 1;
+            uint32_t i11 = i01 + 1;
+            for (auto index : {i00, i10, i11, i00, i11, i01}) *(itr++) = index;
+        }
+    }
+
+    auto vid = vsg::VertexIndexDraw::create();
+    vid->assignArrays(vsg::DataList{vertices});
+    vid->assignIndices(indices);
+    vid->indexCount = static_cast<uint32_t>(indices->size());
+    vid->instanceCount = 1;
+    return vid;
+}
+
+// time random line segments through the scene with the standard and BVH accelerated intersectors
+int benchmark(vsg::ref_ptr<vsg::Node> scene, uint32_t numRays)
+{
+    vsg::ComputeBounds computeBounds;
+    scene->accept(computeBounds);
+    double radius = vsg::length(computeBounds.bounds.max - computeBounds.bounds.min);
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_real_distribution<double> direction(-1.0, 1.0);
+
+    std::vector<std::pair<vsg::dvec3, vsg::dvec3>> segments;
+    for (uint32_t i = 0; i < numRays; ++i)
+    {
+        auto& min = computeBounds.bounds.min;
+        auto& max = computeBounds.bounds.max;
+        vsg::dvec3 target(min.x + (max.x - min.x) * unit(generator), min.y + (max.y - min.y) * unit(generator), min.z + (max.z - min.z) * unit(generator));
+        auto offset = vsg::normalize(vsg::dvec3(direction(generator), direction(generator), direction(generator))) * radius;
+        segments.emplace_back(target + offset, target - offset);
+    }
+
+    auto run = [&](auto createIntersector, size_t first) {
+        size_t numIntersections = 0;
+        auto start = vsg::clock::now();
+        for (size_t i = first; i < segments.size(); ++i)
+        {
+            auto intersector = createIntersector(segments[i].first, segments[i].second);
+            scene->accept(*intersector);
+            numIntersections += intersector->intersections.size();
+        }
+        auto time = std::chrono::duration<double>(vsg::clock::now() - start).count();
+        return std::make_pair(time, numIntersections);
+    };
+
+    auto createStandard = [](const vsg::dvec3& s, const vsg::dvec3& e) { return vsg::LineSegmentIntersector::create(s, e); };
+    auto createBVH = [](const vsg::dvec3& s, const vsg::dvec3& e) { return bvh::BVHLineSegmentIntersector::create(s, e); };
+
+    auto [standardTime, standardIntersections] = run(createStandard, 0);
+
+    // the first query builds the BVHs
+    auto buildStart = vsg::clock::now();
+    auto firstIntersector = createBVH(segments[0].first, segments[0].second);
+    scene->accept(*firstIntersector);
+    auto buildTime = std::chrono::duration<double>(vsg::clock::now() - buildStart).count();
+
+    auto [bvhTime, bvhIntersections] = run(createBVH, 1);
+    bvhIntersections += firstIntersector->intersections.size();
+
+    double numBVHRays = static_cast<double>(segments.size() - 1);
+    std::cout << "LineSegmentIntersector    : " << numRays << " rays in " << standardTime * 1000.0 << "ms, " << static_cast<double>(numRays) / standardTime << " rays/s, " << standardIntersections << " intersections" << std::endl;
+    std::cout << "BVHLineSegmentIntersector : first query with BVH build " << buildTime * 1000.0 << "ms, " << segments.size() - 1 << " rays in " << bvhTime * 1000.0 << "ms, "
+              << numBVHRays / bvhTime << " rays/s, " << bvhIntersections << " intersections" << std::endl;
+    std::cout << "speed up = " << (numBVHRays / bvhTime) / (static_cast<double>(numRays) / standardTime) << std::endl;
+
+    return standardIntersections == bvhIntersections ? 0 : 1;
+}
+
+// time vertical line segments over the scene, as used for terrain following, with batches of different sizes distributed across threads
+int batchBenchmark(vsg::ref_ptr<vsg::Node> scene, uint32_t numRays, uint32_t maxThreads)
+{
+    vsg::ComputeBounds computeBounds;
+    scene->accept(computeBounds);
+    auto& min = computeBounds.bounds.min;
+    auto& max = computeBounds.bounds.max;
+    double height = max.z - min.z + 1.0;
+
+    // raster order so neighbouring segments, and the packets made from them, are coherent
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> jitter(0.0, 1.0);
+    auto rows = std::max(1u, static_cast<uint32_t>(std::sqrt(static_cast<double>(numRays))));
+    auto columns = (numRays + rows - 1) / rows;
+
+    std::vector<bvh::LineSegment> lineSegments;
+    for (uint32_t i = 0; i < numRays; ++i)
+    {
+        double x = min.x + (max.x - min.x) * (static_cast<double>(i % columns) + jitter(generator)) / static_cast<double>(columns);
+        double y = min.y + (max.y - min.y) * (static_cast<double>(i / columns) + jitter(generator)) / static_cast<double>(rows);
+        lineSegments.push_back(bvh::LineSegment{vsg::dvec3(x, y, max.z + height), vsg::dvec3(x, y, min.z - height)});
+    }
+
+    // reference nearest intersections from one BVHLineSegmentIntersector per segment, which also builds the BVHs
+    std::vector<double> nearest(lineSegments.size(), -1.0);
+    auto start = vsg::clock::now();
+    for (size_t i = 0; i < lineSegments.size(); ++i)
+    {
+        auto intersector = bvh::BVHLineSegmentIntersector::create(lineSegments[i].start, lineSegments[i].end);
+        scene->accept(*intersector);
+        for (auto& intersection : intersector->intersections)
+        {
+            if (nearest[i] < 0.0 || intersection->ratio < nearest[i]) nearest[i] = intersection->ratio;
+        }
+    }
+    auto referenceTime = std::chrono::duration<double>(vsg::clock::now() - start).count();
+    std::cout << "BVHLineSegmentIntersector per segment : " << numRays << " rays in " << referenceTime * 1000.0 << "ms, " << static_cast<double>(numRays) / referenceTime << " rays/s" << std::endl;
+
+    // the SCALAR packet tests are run alongside the fastest SIMD kernel so both are checked against the reference
+    std::vector<simd::Kernel> kernels{simd::SCALAR};
+    if (simd::bestKernel() != simd::SCALAR) kernels.push_back(simd::bestKernel());
+
+    int result = 0;
+    for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        auto operationThreads = numThreads > 1 ? vsg::OperationThreads::create(numThreads) : vsg::ref_ptr<vsg::OperationThreads>();
+        for (uint32_t batchSize : {1u, 8u, 64u, 512u, 4096u})
+        {
+            if (batchSize > numRays * 2) break;
+
+            for (auto kernel : kernels)
+            {
+                start = vsg::clock::now();
+                auto hits = bvh::intersect(*scene, lineSegments, batchSize, operationThreads, kernel);
+                auto time = std::chrono::duration<double>(vsg::clock::now() - start).count();
+
+                size_t numHits = 0, numMismatches = 0;
+                for (size_t i = 0; i < hits.size(); ++i)
+                {
+                    if (hits[i].valid) ++numHits;
+                    double ratio = hits[i].valid ? hits[i].ratio : -1.0;
+                    if (std::abs(ratio - nearest[i]) > 1e-9) ++numMismatches;
+                }
+                if (numMismatches > 0) result = 1;
+
+                std::cout << "BatchLineSegmentIntersector threads = " << numThreads << ", batch size = " << batchSize << ", " << simd::name(kernel) << " : " << time * 1000.0 << "ms, " << static_cast<double>(numRays) / time << " rays/s, speed up = " << referenceTime / time
+                          << ", " << numHits << " hits, " << numMismatches << " mismatches" << std::endl;
+            }
+        }
+    }
+
+    return result;
+}
+
+// time picks over a headless view of the scene with the standard and BVH accelerated PolytopeIntersector
+int polytopeBenchmark(vsg::ref_ptr<vsg::Node> scene, vsg::ref_ptr<vsg::EllipsoidModel> ellipsoidModel, uint32_t numPicks, size_t numNearest, int loadLevels)
+{
+    vsg::ComputeBounds computeBounds;
+    scene->accept(computeBounds);
+    double radius = vsg::length(computeBounds.bounds.max - computeBounds.bounds.min) * 0.6;
+    vsg::dvec3 centre = (computeBounds.bounds.min + computeBounds.bounds.max) * 0.5;
+
+    // same default view as the interactive viewer
+    VkExtent2D extent{1920, 1080};
+    double aspectRatio = static_cast<double>(extent.width) / static_cast<double>(extent.height);
+    auto lookAt = vsg::LookAt::create(centre + vsg::dvec3(0.0, -radius * 3.5, 0.0), centre, vsg::dvec3(0.0, 0.0, 1.0));
+    vsg::ref_ptr<vsg::ProjectionMatrix> perspective;
+    if (ellipsoidModel)
+        perspective = vsg::EllipsoidPerspective::create(lookAt, ellipsoidModel, 30.0, aspectRatio, 0.001, 0.0);
+    else
+        perspective = vsg::Perspective::create(30.0, aspectRatio, 0.001 * radius, radius * 4.5);
+    auto camera = vsg::Camera::create(perspective, lookAt, vsg::ViewportState::create(extent));
+
+    // pre load PagedLOD levels so paged databases such as the openstreetmap and readymap models have many tiles to pick against
+    if (loadLevels > 0)
+    {
+        vsg::LoadPagedLOD loadPagedLOD(camera, loadLevels);
+        scene->accept(loadPagedLOD);
+        std::cout << "No. of tiles loaded " << loadPagedLOD.numTiles << std::endl;
+    }
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> x(0.0, static_cast<double>(extent.width));
+    std::uniform_real_distribution<double> y(0.0, static_cast<double>(extent.height));
+    std::vector<vsg::dvec2> picks;
+    for (uint32_t i = 0; i < numPicks; ++i) picks.emplace_back(x(generator), y(generator));
+
+    double size = 5.0;
+    auto run = [&](const std::string& name, auto createIntersector) {
+        size_t numIntersections = 0, numPicksWithIntersections = 0;
+        auto start = vsg::clock::now();
+        for (auto& pick : picks)
+        {
+            auto intersector = createIntersector(pick.x - size, pick.y - size, pick.x + size, pick.y + size);
+            scene->accept(*intersector);
+            numIntersections += intersector->intersections.size();
+            if (!intersector->intersections.empty()) ++numPicksWithIntersections;
+        }
+        auto time = std::chrono::duration<double>(vsg::clock::now() - start).count();
+        std::cout << name << " : " << numPicks << " picks in " << time * 1000.0 << "ms, " << time * 1000.0 / static_cast<double>(numPicks) << "ms per pick, "
+                  << numIntersections << " intersections, " << numPicksWithIntersections << " picks with intersections" << std::endl;
+        return std::make_pair(numIntersections, numPicksWithIntersections);
+    };
+
+    auto createBVH = [&](bvh::BVHPolytopeIntersector::Mode mode) {
+        return [&, mode](double xMin, double yMin, double xMax, double yMax) {
+            auto intersector = bvh::BVHPolytopeIntersector::create(*camera, xMin, yMin, xMax, yMax);
+            intersector->mode = mode;
+            intersector->maxIntersections = numNearest;
+            return intersector;
+        };
+    };
+
+    auto standard = run("PolytopeIntersector                         ", [&](double xMin, double yMin, double xMax, double yMax) { return vsg::PolytopeIntersector::create(*camera, xMin, yMin, xMax, yMax); });
+    run("BVHPolytopeIntersector all, with BVH builds  ", createBVH(bvh::BVHPolytopeIntersector::ALL_INTERSECTIONS));
+    auto all = run("BVHPolytopeIntersector all                  ", createBVH(bvh::BVHPolytopeIntersector::ALL_INTERSECTIONS));
+    auto any = run("BVHPolytopeIntersector any                  ", createBVH(bvh::BVHPolytopeIntersector::ANY_INTERSECTION));
+    run("BVHPolytopeIntersector nearest " + std::to_string(numNearest) + "            ", createBVH(bvh::BVHPolytopeIntersector::NEAREST_INTERSECTIONS));
+
+    return (standard == all && standard.second == any.second) ? 0 : 1;
+}
+
+// frustum culling of bounding spheres as done by the RecordTraversal, counting the sphere tests and the objects that would be recorded
+class CullCounter : public vsg::Inherit<vsg::ConstVisitor, CullCounter>
+{
+public:
+    explicit CullCounter(const vsg::dmat4& projectionView)
+    {
+        // planes from the rows of the projection * view matrix, for clip space x and y in [-w, w] and depth in [0, w]
+        auto row = [&](int i) { return vsg::dvec4(projectionView[0][i], projectionView[1][i], projectionView[2][i], projectionView[3][i]); };
+        for (auto& plane : {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)})
+        {
+            double length = vsg::length(vsg::dvec3(plane.x, plane.y, plane.z));
+            frustum.emplace_back(plane.x / length, plane.y / length, plane.z / length, plane.w / length);
+        }
+    }
+
+    std::vector<vsg::dplane> frustum;
+    size_t numTests = 0;
+    size_t numVisible = 0;
+
+    bool visible(const vsg::dsphere& bound)
+    {
+        ++numTests;
+        for (auto& plane : frustum)
+        {
+            if (vsg::distance(plane, bound.center) < -bound.radius) return false;
+        }
+        return true;
+    }
+
+    void apply(const vsg::Node& node) override
+    {
+        node.traverse(*this);
+    }
+
+    void apply(const vsg::CullGroup& cullGroup) override
+    {
+        if (visible(cullGroup.bound)) cullGroup.traverse(*this);
+    }
+
+    void apply(const vsg::CullNode& cullNode) override
+    {
+        if (visible(cullNode.bound)) ++numVisible;
+    }
+};
+
+// insert numObjects boxes into a flat Group of CullNodes and a SpatialGroup, then time culling and picking from views inside the scene, and moving objects
+int spatialBenchmark(vsg::ref_ptr<vsg::Builder> builder, uint32_t numObjects, uint32_t numPicks)
+{
+    auto box = builder->createBox();
+    double size = 10.0 * std::cbrt(static_cast<double>(numObjects));
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> position(0.0, size);
+    std::uniform_real_distribution<double> scale(0.5, 2.0);
+
+    std::vector<vsg::ref_ptr<vsg::MatrixTransform>> objects;
+    std::vector<vsg::dsphere> bounds;
+    for (uint32_t i = 0; i < numObjects; ++i)
+    {
+        vsg::dvec3 centre(position(generator), position(generator), position(generator));
+        double s = scale(generator);
+        auto transform = vsg::MatrixTransform::create(vsg::translate(centre) * vsg::scale(s));
+        transform->addChild(box);
+        objects.push_back(transform);
+        bounds.emplace_back(centre, s * std::sqrt(3.0) * 0.5);
+    }
+
+    auto start = vsg::clock::now();
+    auto flat = vsg::Group::create();
+    std::vector<vsg::ref_ptr<vsg::CullNode>> flatCullNodes;
+    for (uint32_t i = 0; i < numObjects; ++i)
+    {
+        flatCullNodes.push_back(vsg::CullNode::create(bounds[i], objects[i]));
+        flat->addChild(flatCullNodes.back());
+    }
+    auto flatInsertTime = std::chrono::duration<double>(vsg::clock::now() - start).count();
+
+    start = vsg::clock::now();
+    auto spatial = bvh::SpatialGroup::create(vsg::dbox(vsg::dvec3(0.0, 0.0, 0.0), vsg::dvec3(size, size, size)));
+    for (uint32_t i = 0; i < numObjects; ++i) spatial->insert(objects[i], bounds[i]);
+    auto spatialInsertTime = std::chrono::duration<double>(vsg::clock::now() - start).count();
+
+    std::cout << "Group          : " << numObjects << " objects inserted in " << flatInsertTime * 1000.0 << "ms" << std::endl;
+    std::cout << "SpatialGroup   : " << numObjects << " objects inserted in " << spatialInsertTime * 1000.0 << "ms, " << spatial->numCells() << " cells" << std::endl;
+
+    // walk through views from the centre of the scene, looking out horizontally in different directions
+    VkExtent2D extent{1920, 1080};
+    std::vector<vsg::ref_ptr<vsg::Camera>> cameras;
+    vsg::dvec3 centre(size * 0.5, size * 0.5, size * 0.5);
+    for (int i = 0; i < 16; ++i)
+    {
+        double angle = vsg::PI * 2.0 * static_cast<double>(i) / 16.0;
+        auto lookAt = vsg::LookAt::create(centre, centre + vsg::dvec3(std::cos(angle), std::sin(angle), 0.0), vsg::dvec3(0.0, 0.0, 1.0));
+        auto perspective = vsg::Perspective::create(60.0, static_cast<double>(extent.width) / static_cast<double>(extent.height), 0.1, size * 0.5);
+        cameras.push_back(vsg::Camera::create(perspective, lookAt, vsg::ViewportState::create(extent)));
+    }
+
+    std::uniform_real_distribution<double> x(0.0, static_cast<double>(extent.width));
+    std::uniform_real_distribution<double> y(0.0, static_cast<double>(extent.height));
+    std::vector<vsg::dvec2> picks;
+    for (uint32_t i = 0; i < numPicks; ++i) picks.emplace_back(x(generator), y(generator));
+
+    auto run = [&](const std::string& name, vsg::Node& scene) {
+        size_t numTests = 0, numVisible = 0;
+        start = vsg::clock::now();
+        for (auto& camera : cameras)
+        {
+            CullCounter cullCounter(camera->projectionMatrix->transform() * camera->viewMatrix->transform());
+            scene.accept(cullCounter);
+            numTests += cullCounter.numTests;
+            numVisible += cullCounter.numVisible;
+        }
+        auto cullTime = std::chrono::duration<double>(vsg::clock::now() - start).count();
+
+        size_t numIntersections = 0;
+        start = vsg::clock::now();
+        for (size_t i = 0; i < picks.size(); ++i)
+        {
+            auto intersector = vsg::LineSegmentIntersector::create(*cameras[i % cameras.size()], picks[i].x, picks[i].y);
+            scene.accept(*intersector);
+            numIntersections += intersector->intersections.size();
+        }
+        auto pickTime = std::chrono::duration<double>(vsg::clock::now() - start).count();
+
+        std::cout << name << " : cull " << cullTime * 1000.0 / static_cast<double>(cameras.size()) << "ms per view, " << numTests / cameras.size() << " bound tests, " << numVisible / cameras.size() << " visible, "
+                  << "pick " << pickTime * 1000.0 / static_cast<double>(picks.size()) << "ms per pick, " << numIntersections << " intersections" << std::endl;
+        return std::make_pair(numVisible, numIntersections);
+    };
+
+    auto flatResults = run("Group         ", *flat);
+    auto spatialResults = run("SpatialGroup  ", *spatial);
+
+    // move a tenth of the objects, the flat Group only needs the CullNode bounds updating
+    std::uniform_real_distribution<double> offset(-size * 0.01, size * 0.01);
+    std::uniform_int_distribution<uint32_t> pickObject(0, numObjects - 1);
+    uint32_t numMoves = std::max(1u, numObjects / 10);
+    start = vsg::clock::now();
+    for (uint32_t i = 0; i < numMoves; ++i)
+    {
+        auto index = pickObject(generator);
+        bounds[index].center += vsg::dvec3(offset(generator), offset(generator), offset(generator));
+        objects[index]->matrix = vsg::translate(bounds[index].center) * vsg::scale(bounds[index].radius / (std::sqrt(3.0) * 0.5));
+        flatCullNodes[index]->bound = bounds[index];
+        spatial->update(objects[index], bounds[index]);
+    }
+    auto moveTime = std::chrono::duration<double>(vsg::clock::now() - start).count();
+    std::cout << "SpatialGroup   : " << numMoves << " objects moved in " << moveTime * 1000.0 << "ms, " << spatial->numCells() << " cells" << std::endl;
+
+    auto movedFlatResults = run("Group         ", *flat);
+    auto movedSpatialResults = run("SpatialGroup  ", *spatial);
+
+    return (flatResults == spatialResults && movedFlatResults == movedSpatialResults) ? 0 : 1;
+}
+
 int main(int argc, char** argv)
 {
     // set up defaults and read command line arguments to override them
@@ -265,6 +698,20 @@ int main(int argc, char** argv)
     auto pointOfInterest = arguments.value(vsg::dvec3(0.0, 0.0, std::numeric_limits<double>::max()), "--poi");
     auto horizonMountainHeight = arguments.value(0.0, "--hmh");
     vsg::Path textureFile = arguments.value<std::string>("", "-t");
+    bool useBVH = arguments.read("--bvh");
+    auto numBenchmarkRays = arguments.value(0u, "--benchmark");
+    auto numGeneratedTriangles = arguments.value(0u, "--generate");
+    auto numBatchBenchmarkRays = arguments.value(0u, "--batch-benchmark");
+    auto maxThreads = arguments.value(std::max(1u, std::thread::hardware_concurrency()), "--threads");
+    auto numPolytopeBenchmarkPicks = arguments.value(0u, "--polytope-benchmark");
+    auto loadLevels = arguments.value(0, "--load-levels");
+    auto numSpatialBenchmarkObjects = arguments.value(0u, "--spatial-benchmark");
+    auto numPicks = arguments.value(1000u, "--picks");
+    bool useSpatialGroup = arguments.read("--spatial");
+    auto polytopeMode = bvh::BVHPolytopeIntersector::ALL_INTERSECTIONS;
+    size_t maxPolytopeIntersections = 1;
+    if (arguments.read("--any")) polytopeMode = bvh::BVHPolytopeIntersector::ANY_INTERSECTION;
+    if (arguments.read("--nearest", maxPolytopeIntersections)) polytopeMode = bvh::BVHPolytopeIntersector::NEAREST_INTERSECTIONS;
 
     if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
 
@@ -287,6 +734,22 @@ int main(int argc, char** argv)
         }
     }
 
+    if (numSpatialBenchmarkObjects > 0) return spatialBenchmark(builder, numSpatialBenchmarkObjects, numPicks);
+
+    if (numBenchmarkRays > 0 || numBatchBenchmarkRays > 0 || numPolytopeBenchmarkPicks > 0)
+    {
+        // --generate adds a mesh without state so is only used for benchmarking
+        if (numGeneratedTriangles > 0) scene->addChild(createMesh(numGeneratedTriangles));
+        if (scene->children.empty())
+        {
+            std::cout << "No model to benchmark, please specify a model or use --generate <numTriangles>." << std::endl;
+            return 1;
+        }
+        if (numBatchBenchmarkRays > 0) return batchBenchmark(scene, numBatchBenchmarkRays, maxThreads);
+        if (numPolytopeBenchmarkPicks > 0) return polytopeBenchmark(scene, ellipsoidModel, numPolytopeBenchmarkPicks, maxPolytopeIntersections, loadLevels);
+        return benchmark(scene, numBenchmarkRays);
+    }
+
     vsg::StateInfo stateInfo;
 
     if (textureFile)
@@ -366,6 +829,17 @@ int main(int argc, char** argv)
 
     auto camera = vsg::Camera::create(perspective, lookAt, vsg::ViewportState::create(window->extent2D()));
 
+    // --spatial inserts the created shapes into a SpatialGroup covering the model and the shapes placed on it, rather than a flat Group
+    vsg::ref_ptr<bvh::SpatialGroup> spatialGroup;
+    if (useSpatialGroup)
+    {
+        vsg::dbox extents = computeBounds.bounds;
+        extents.min -= vsg::dvec3(radius, radius, radius) * 0.1;
+        extents.max += vsg::dvec3(radius, radius, radius) * 0.1;
+        spatialGroup = bvh::SpatialGroup::create(extents);
+        scene->addChild(spatialGroup);
+    }
+
     auto commandGraph = createCommandGraphForView(window, camera, scene);
     viewer->assignRecordAndSubmitTaskAndPresentation({commandGraph});
 
@@ -376,6 +850,10 @@ int main(int argc, char** argv)
 
     auto intersectionHandler = IntersectionHandler::create(builder, camera, scene, ellipsoidModel, radius * 0.1, options);
     intersectionHandler->state = stateInfo;
+    intersectionHandler->spatialGroup = spatialGroup;
+    intersectionHandler->useBVH = useBVH;
+    intersectionHandler->polytopeMode = polytopeMode;
+    intersectionHandler->maxPolytopeIntersections = maxPolytopeIntersections;
     viewer->addEventHandler(intersectionHandler);
 
     // assign a CompileTraversal to the Builder that will compile for all the views assigned to the viewer,
@@ -0,0 +1,147 @@
+#include "ShaderSetPrecompiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace precompile;
+
+namespace
+{
+    struct CompileVariant : public vsg::Inherit<vsg::Operation, CompileVariant>
+    {
+        CompileVariant(vsg::ShaderStages in_stages, ShaderSetPrecompiler::VariantResult& in_result, vsg::ref_ptr<const vsg::Options> in_options, vsg::ref_ptr<vsg::Latch> in_latch) :
+            stages(in_stages),
+            result(in_result),
+            options(in_options),
+            latch(in_latch) {}
+
+        vsg::ShaderStages stages;
+        ShaderSetPrecompiler::VariantResult& result;
+        vsg::ref_ptr<const vsg::Options> options;
+        vsg::ref_ptr<vsg::Latch> latch;
+
+        void run() override
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            // glslang state isn't shared between compilers so each variant uses its own
+            auto shaderCompiler = vsg::ShaderCompiler::create();
+            result.compiled = shaderCompiler->supported() && shaderCompiler->compile(stages, {}, options);
+            for (auto& stage : stages)
+            {
+                if (stage->module->code.empty()) result.compiled = false;
+            }
+
+            result.compileTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            latch->count_down();
+        }
+    };
+
+    void addCombinations(const std::vector<std::string>& defines, size_t first, size_t maxDefines, std::set<std::string>& current, std::vector<std::set<std::string>>& combinations)
+    {
+        combinations.push_back(current);
+        if (current.size() >= maxDefines) return;
+
+        for (size_t i = first; i < defines.size(); ++i)
+        {
+            current.insert(defines[i]);
+            addCombinations(defines, i + 1, maxDefines, current, combinations);
+            current.erase(defines[i]);
+        }
+    }
+} // namespace
+
+std::vector<std::set<std::string>> precompile::defineCombinations(const std::set<std::string>& defines, size_t maxDefines)
+{
+    std::vector<std::string> definesList(defines.begin(), defines.end());
+    std::set<std::string> current;
+    std::vector<std::set<std::string>> combinations;
+    addCombinations(definesList, 0, maxDefines, current, combinations);
+    return combinations;
+}
+
+ShaderSetPrecompiler::ShaderSetPrecompiler(uint32_t in_numThreads) :
+    numThreads(in_numThreads > 0 ? in_numThreads : std::max(1u, std::thread::hardware_concurrency()))
+{
+    _operationThreads = vsg::OperationThreads::create(numThreads);
+}
+
+void ShaderSetPrecompiler::addVariants(vsg::ShaderSet& shaderSet, const std::vector<std::set<std::string>>& combinations, vsg::ref_ptr<const vsg::ShaderCompileSettings> baseSettings) const
+{
+    for (auto& defines : combinations)
+    {
+        auto scs = baseSettings ? vsg::ShaderCompileSettings::create(*baseSettings) : vsg::ShaderCompileSettings::create();
+        scs->defines.insert(defines.begin(), defines.end());
+        shaderSet.getShaderStages(scs);
+    }
+}
+
+bool ShaderSetPrecompiler::precompile(vsg::ShaderSet& shaderSet, vsg::ref_ptr<const vsg::Options> options)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // gather the variants still to compile before dispatching, as the ShaderSet's variants mustn't be modified while the threads run
+    std::vector<std::pair<vsg::ref_ptr<vsg::ShaderCompileSettings>, vsg::ShaderStages>> variantsToCompile;
+    for (auto& [scs, stages] : shaderSet.variants)
+    {
+        vsg::ShaderStages stagesToCompile;
+        for (auto& stage : stages)
+        {
+            if (stage && stage->module && stage->module->code.empty() && !stage->module->source.empty()) stagesToCompile.push_back(stage);
+        }
+        if (!stagesToCompile.empty()) variantsToCompile.emplace_back(scs, stagesToCompile);
+    }
+
+    results.clear();
+    results.resize(variantsToCompile.size());
+
+    if (!variantsToCompile.empty())
+    {
+        auto latch = vsg::Latch::create(static_cast<int>(variantsToCompile.size()));
+        for (size_t i = 0; i < variantsToCompile.size(); ++i)
+        {
+            auto& [scs, stages] = variantsToCompile[i];
+            results[i].settings = scs;
+            results[i].numStages = stages.size();
+            _operationThreads->add(CompileVariant::create(stages, results[i], options, latch));
+        }
+        latch->wait();
+    }
+
+    wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto& result : results)
+    {
+        if (!result.compiled) return false;
+    }
+    return true;
+}
+
+void ShaderSetPrecompiler::report(std::ostream& out, bool perVariant) const
+{
+    double totalCompileTime = 0.0;
+    size_t numFailed = 0;
+    for (auto& result : results)
+    {
+        totalCompileTime += result.compileTime;
+        if (!result.compiled) ++numFailed;
+    }
+
+    out << "ShaderSetPrecompiler::report() " << this << " numThreads = " << numThreads << std::endl;
+    if (perVariant)
+    {
+        for (auto& result : results)
+        {
+            out << "    { ";
+            if (result.settings)
+            {
+                for (auto& define : result.settings->defines) out << define << " ";
+            }
+            out << "} " << result.numStages << " stages, " << result.compileTime * 1000.0 << "ms" << (result.compiled ? "" : " FAILED") << std::endl;
+        }
+    }
+    out << "    variants = " << results.size() << ", failed = " << numFailed << ", compile time = " << totalCompileTime * 1000.0 << "ms, wall time = " << wallTime * 1000.0 << "ms";
+    if (wallTime > 0.0) out << ", parallelism = " << totalCompileTime / wallTime;
+    out << std::endl;
+}
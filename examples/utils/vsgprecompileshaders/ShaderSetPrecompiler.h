@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <set>
+
+namespace precompile
+{
+
+    /// return every combination of up to maxDefines of the defines, including the empty combination.
+    std::vector<std::set<std::string>> defineCombinations(const std::set<std::string>& defines, size_t maxDefines);
+
+    /// Compiles the variants of a ShaderSet ahead of time on a pool of threads, so they don't compile serially on first use.
+    /// Each variant's stages are compiled together by their own vsg::ShaderCompiler, so variants compile concurrently
+    /// while the stages of a variant are still linked as a single program.
+    class ShaderSetPrecompiler : public vsg::Inherit<vsg::Object, ShaderSetPrecompiler>
+    {
+    public:
+        explicit ShaderSetPrecompiler(uint32_t in_numThreads = 0);
+
+        const uint32_t numThreads;
+
+        /// add a variant to the ShaderSet for each combination of defines, taking the other compile settings from baseSettings.
+        void addVariants(vsg::ShaderSet& shaderSet, const std::vector<std::set<std::string>>& combinations, vsg::ref_ptr<const vsg::ShaderCompileSettings> baseSettings = {}) const;
+
+        /// compile the variants of the ShaderSet that have GLSL source but no SPIR-V, returning true if all compiled successfully.
+        bool precompile(vsg::ShaderSet& shaderSet, vsg::ref_ptr<const vsg::Options> options = {});
+
+        struct VariantResult
+        {
+            vsg::ref_ptr<vsg::ShaderCompileSettings> settings;
+            size_t numStages = 0;
+            double compileTime = 0.0;
+            bool compiled = false;
+        };
+
+        /// results of the last precompile().
+        std::vector<VariantResult> results;
+        double wallTime = 0.0;
+
+        void report(std::ostream& out, bool perVariant = true) const;
+
+    protected:
+        vsg::ref_ptr<vsg::OperationThreads> _operationThreads;
+    };
+
+} // namespace precompile
+
+EVSG_type_name(precompile::ShaderSetPrecompiler);
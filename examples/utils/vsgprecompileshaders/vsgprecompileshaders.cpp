@@ -0,0 +1,83 @@
+#include <vsg/all.h>
+
+#ifdef vsgXchange_FOUND
+#    include <vsgXchange/all.h>
+#endif
+
+#include <iostream>
+#include <thread>
+
+#include "ShaderSetPrecompiler.h"
+
+std::vector<vsg::ref_ptr<vsg::ShaderSet>> createShaderSets(vsg::ref_ptr<const vsg::Options> options)
+{
+    return {vsg::createFlatShadedShaderSet(options),
+            vsg::createPhongShaderSet(options),
+            vsg::createPhysicsBasedRenderingShaderSet(options),
+            vsg::createTextShaderSet(options)};
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto maxThreads = arguments.value(std::max(1u, std::thread::hardware_concurrency()), "--threads");
+    auto maxDefines = arguments.value<size_t>(1, "--defines");
+    bool verbose = arguments.read({"--verbose", "-v"});
+
+    auto baseSettings = vsg::ShaderCompileSettings::create();
+    baseSettings->generateDebugInfo = arguments.read({"--debug-info", "-g"});
+
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+
+#ifdef vsgXchange_all
+    options->add(vsgXchange::all::create());
+#endif
+
+    options->readOptions(arguments);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    // thread counts 1, 2, 4 ... up to and including maxThreads
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t numThreads = 1; numThreads < maxThreads; numThreads *= 2) threadCounts.push_back(numThreads);
+    threadCounts.push_back(maxThreads);
+
+    std::cout << "threads, variants, compile time (ms), wall time (ms), speedup" << std::endl;
+
+    double singleThreadedWallTime = 0.0;
+    for (auto numThreads : threadCounts)
+    {
+        auto precompiler = precompile::ShaderSetPrecompiler::create(numThreads);
+
+        // fresh ShaderSets each run so nothing is already compiled
+        size_t numVariants = 0;
+        double compileTime = 0.0;
+        double wallTime = 0.0;
+        for (auto& shaderSet : createShaderSets(options))
+        {
+            precompiler->addVariants(*shaderSet, precompile::defineCombinations(shaderSet->optionalDefines, maxDefines), baseSettings);
+            if (!precompiler->precompile(*shaderSet, options)) std::cout << "Warning: not all variants compiled." << std::endl;
+
+            if (verbose) precompiler->report(std::cout);
+
+            numVariants += precompiler->results.size();
+            for (auto& result : precompiler->results) compileTime += result.compileTime;
+            wallTime += precompiler->wallTime;
+        }
+
+        if (numVariants == 0)
+        {
+            std::cout << "No GLSL source to compile, set VSG_FILE_PATH to the vsgExamples/data directory so the shaders/*.vert and *.frag files are found." << std::endl;
+            return 1;
+        }
+
+        if (numThreads == 1) singleThreadedWallTime = wallTime;
+
+        std::cout << numThreads << ", " << numVariants << ", " << compileTime * 1000.0 << ", " << wallTime * 1000.0;
+        if (singleThreadedWallTime > 0.0) std::cout << ", " << singleThreadedWallTime / wallTime;
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include "ShaderCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace shadercache;
+
+namespace
+{
+    const char s_magic[8] = {'v', 's', 'g', 's', 'p', 'v', '1', '\n'};
+
+    // 64 bit FNV-1a, only used to name the cache files as the full key is checked on load
+    uint64_t hashKey(const std::string& key)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (auto c : key)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /// collect the ShaderStages of the graphics and compute pipelines in a scene graph.
+    class CollectShaderStages : public vsg::Visitor
+    {
+    public:
+        vsg::ShaderStages stages;
+        std::set<const vsg::Object*> visited;
+
+        void apply(vsg::Object& object) override
+        {
+            object.traverse(*this);
+        }
+
+        void apply(vsg::StateGroup& stateGroup) override
+        {
+            for (auto& stateCommand : stateGroup.stateCommands) stateCommand->accept(*this);
+            stateGroup.traverse(*this);
+        }
+
+        void apply(vsg::BindGraphicsPipeline& bindGraphicsPipeline) override
+        {
+            if (bindGraphicsPipeline.pipeline) apply(*bindGraphicsPipeline.pipeline);
+        }
+
+        void apply(vsg::GraphicsPipeline& graphicsPipeline) override
+        {
+            if (!visited.insert(&graphicsPipeline).second) return;
+            stages.insert(stages.end(), graphicsPipeline.stages.begin(), graphicsPipeline.stages.end());
+        }
+
+        void apply(vsg::BindComputePipeline& bindComputePipeline) override
+        {
+            if (bindComputePipeline.pipeline) apply(*bindComputePipeline.pipeline);
+        }
+
+        void apply(vsg::ComputePipeline& computePipeline) override
+        {
+            if (!visited.insert(&computePipeline).second) return;
+            if (computePipeline.stage) stages.push_back(computePipeline.stage);
+        }
+    };
+} // namespace
+
+ShaderCache::ShaderCache(const vsg::Path& in_directory) :
+    directory(in_directory)
+{
+    vsg::makeDirectory(directory);
+
+    auto shaderCompiler = vsg::ShaderCompiler::create();
+    if (shaderCompiler->supported()) _shaderCompiler = shaderCompiler;
+}
+
+std::string ShaderCache::key(const vsg::ShaderStage& stage, const std::vector<std::string>& defines) const
+{
+    std::ostringstream str;
+    str << "vsg " << vsg::vsgGetVersionString() << "\n";
+    str << "stage " << stage.stage << "\n";
+    str << "entryPointName " << stage.entryPointName << "\n";
+
+    // the settings are written with the native ascii format so any ShaderCompileSettings member, including the defines, contributes to the key
+    if (stage.module->hints)
+    {
+        vsg::AsciiOutput output(str);
+        output.version = vsg::vsgGetVersion();
+        output.writeObject("hints", stage.module->hints);
+    }
+
+    for (auto& define : defines) str << "define " << define << "\n";
+
+    str << "source\n"
+        << stage.module->source;
+
+    return str.str();
+}
+
+vsg::Path ShaderCache::filename(const std::string& key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(hashKey(key)));
+    return directory / name;
+}
+
+bool ShaderCache::load(const std::string& key, std::vector<uint32_t>& code) const
+{
+    std::ifstream fin(filename(key), std::ios::in | std::ios::binary);
+    if (!fin) return false;
+
+    char magic[sizeof(s_magic)];
+    uint64_t keySize = 0;
+    fin.read(magic, sizeof(magic));
+    fin.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
+    if (!fin || std::memcmp(magic, s_magic, sizeof(s_magic)) != 0 || keySize != key.size()) return false;
+
+    std::string storedKey(keySize, '\0');
+    fin.read(storedKey.data(), static_cast<std::streamsize>(keySize));
+    if (!fin || storedKey != key) return false;
+
+    uint64_t codeSize = 0;
+    fin.read(reinterpret_cast<char*>(&codeSize), sizeof(codeSize));
+    if (!fin || codeSize == 0) return false;
+
+    code.resize(codeSize);
+    fin.read(reinterpret_cast<char*>(code.data()), static_cast<std::streamsize>(codeSize * sizeof(uint32_t)));
+    return static_cast<bool>(fin);
+}
+
+bool ShaderCache::store(const std::string& key, const std::vector<uint32_t>& code) const
+{
+    // write to a temporary file and rename so concurrent readers, in this or another process, never see a partial entry
+    // thread ids are only unique within a process, so add a random suffix to keep other processes sharing the cache directory from colliding
+    thread_local std::mt19937_64 s_generator(std::random_device{}());
+    auto finalFilename = filename(key);
+    std::ostringstream temporaryName;
+    temporaryName << finalFilename.string() << "." << std::this_thread::get_id() << "." << std::hex << s_generator() << ".tmp";
+    auto temporaryFilename = temporaryName.str();
+
+    {
+        std::ofstream fout(temporaryFilename, std::ios::out | std::ios::binary);
+        if (!fout) return false;
+
+        uint64_t keySize = key.size();
+        uint64_t codeSize = code.size();
+        fout.write(s_magic, sizeof(s_magic));
+        fout.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+        fout.write(key.data(), static_cast<std::streamsize>(keySize));
+        fout.write(reinterpret_cast<const char*>(&codeSize), sizeof(codeSize));
+        fout.write(reinterpret_cast<const char*>(code.data()), static_cast<std::streamsize>(codeSize * sizeof(uint32_t)));
+        if (!fout)
+        {
+            fout.close();
+            std::remove(temporaryFilename.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(temporaryFilename.c_str(), finalFilename.string().c_str()) == 0) return true;
+
+    std::remove(temporaryFilename.c_str());
+    return false;
+}
+
+bool ShaderCache::compile(vsg::ShaderStages& stages, const std::vector<std::string>& defines, vsg::ref_ptr<const vsg::Options> options)
+{
+    bool result = true;
+    for (auto& stage : stages)
+    {
+        // nothing to do for stages that are already compiled or have no source to compile
+        if (!stage || !stage->module || !stage->module->code.empty() || stage->module->source.empty()) continue;
+
+        auto stageKey = key(*stage, defines);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<uint32_t> code;
+        bool hit = load(stageKey, code);
+        auto loadDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (hit)
+        {
+            stage->module->code.swap(code);
+
+            std::scoped_lock<std::mutex> lock(_mutex);
+            ++numLookups;
+            ++numHits;
+            loadTime += loadDuration;
+            continue;
+        }
+
+        start = std::chrono::steady_clock::now();
+        bool compiled = _shaderCompiler && _shaderCompiler->compile(stage, defines, options) && !stage->module->code.empty();
+        auto compileDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (compiled && !store(stageKey, stage->module->code))
+        {
+            vsg::warn("ShaderCache::compile() unable to write cache entry to ", directory);
+        }
+
+        std::scoped_lock<std::mutex> lock(_mutex);
+        ++numLookups;
+        if (compiled) ++numCompiled;
+        else ++numFailed;
+        loadTime += loadDuration;
+        compileTime += compileDuration;
+
+        result = result && compiled;
+    }
+    return result;
+}
+
+bool ShaderCache::compile(vsg::Object* object, vsg::ref_ptr<const vsg::Options> options)
+{
+    if (!object) return false;
+
+    CollectShaderStages collectShaderStages;
+    object->accept(collectShaderStages);
+    return compile(collectShaderStages.stages, {}, options);
+}
+
+bool ShaderCache::compile(vsg::ShaderSet& shaderSet, vsg::ref_ptr<const vsg::Options> options)
+{
+    bool result = true;
+    for (auto& [shaderCompileSettings, stages] : shaderSet.variants)
+    {
+        if (!compile(stages, {}, options)) result = false;
+    }
+    return result;
+}
+
+void ShaderCache::clear()
+{
+    for (auto& name : vsg::getDirectoryContents(directory))
+    {
+        if (vsg::lowerCaseFileExtension(name) == ".spv") std::remove((directory / name).string().c_str());
+    }
+}
+
+void ShaderCache::clearStats()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    numLookups = 0;
+    numHits = 0;
+    numCompiled = 0;
+    numFailed = 0;
+    loadTime = 0.0;
+    compileTime = 0.0;
+}
+
+void ShaderCache::report(std::ostream& out) const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    out << "ShaderCache::report() " << this << " " << directory << std::endl;
+    out << "    lookups = " << numLookups << ", hits = " << numHits << ", compiled = " << numCompiled << ", failed = " << numFailed << std::endl;
+    out << "    load time = " << loadTime * 1000.0 << "ms, compile time = " << compileTime * 1000.0 << "ms" << std::endl;
+    if (!_shaderCompiler) out << "    vsg::ShaderCompiler not supported, misses can't be compiled." << std::endl;
+}
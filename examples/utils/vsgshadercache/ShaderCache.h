@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vsg/all.h>
+
+#include <mutex>
+
+namespace shadercache
+{
+
+    /// Persistent cache of compiled SPIR-V, consulted before invoking vsg::ShaderCompiler.
+    /// Each entry is stored in its own file in the cache directory, named by a hash of the key built from the shader stage,
+    /// entry point, GLSL source, defines, ShaderCompileSettings and VSG version. The full key is stored alongside the SPIR-V
+    /// and checked on lookup so hash collisions can't return the wrong code. Files pulled in by #include aren't part of the key,
+    /// so the cache directory should be cleared when included shader files are edited.
+    class ShaderCache : public vsg::Inherit<vsg::Object, ShaderCache>
+    {
+    public:
+        explicit ShaderCache(const vsg::Path& in_directory);
+
+        const vsg::Path directory;
+
+        /// assign the SPIR-V of any stages that have source but no code, loading it from the cache or compiling and storing it.
+        bool compile(vsg::ShaderStages& stages, const std::vector<std::string>& defines = {}, vsg::ref_ptr<const vsg::Options> options = {});
+
+        /// compile the stages of all the pipelines in a scene graph, for use before Viewer::compile() or CompileManager::compile().
+        bool compile(vsg::Object* object, vsg::ref_ptr<const vsg::Options> options = {});
+
+        /// compile all the variants of a ShaderSet.
+        bool compile(vsg::ShaderSet& shaderSet, vsg::ref_ptr<const vsg::Options> options = {});
+
+        /// key identifying the SPIR-V compiled from a stage.
+        std::string key(const vsg::ShaderStage& stage, const std::vector<std::string>& defines) const;
+
+        /// remove all the entries from the cache directory.
+        void clear();
+
+        // statistics
+        size_t numLookups = 0;
+        size_t numHits = 0;
+        size_t numCompiled = 0;
+        size_t numFailed = 0;
+        double loadTime = 0.0;
+        double compileTime = 0.0;
+
+        void clearStats();
+        void report(std::ostream& out) const;
+
+    protected:
+        vsg::Path filename(const std::string& key) const;
+        bool load(const std::string& key, std::vector<uint32_t>& code) const;
+        bool store(const std::string& key, const std::vector<uint32_t>& code) const;
+
+        mutable std::mutex _mutex;
+        vsg::ref_ptr<vsg::ShaderCompiler> _shaderCompiler;
+    };
+
+} // namespace shadercache
+
+EVSG_type_name(shadercache::ShaderCache);
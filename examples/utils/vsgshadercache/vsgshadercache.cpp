@@ -0,0 +1,115 @@
+#include <vsg/all.h>
+
+#ifdef vsgXchange_FOUND
+#    include <vsgXchange/all.h>
+#endif
+
+#include <chrono>
+#include <iostream>
+#include <set>
+
+#include "ShaderCache.h"
+
+// create the built in ShaderSets with a variant for the default settings and one for each of their optional defines
+std::vector<vsg::ref_ptr<vsg::ShaderSet>> createShaderSets(vsg::ref_ptr<const vsg::Options> options, bool generateDebugInfo, size_t maxVariants)
+{
+    std::vector<vsg::ref_ptr<vsg::ShaderSet>> shaderSets{
+        vsg::createFlatShadedShaderSet(options),
+        vsg::createPhongShaderSet(options),
+        vsg::createPhysicsBasedRenderingShaderSet(options),
+        vsg::createTextShaderSet(options)};
+
+    for (auto& shaderSet : shaderSets)
+    {
+        std::vector<std::set<std::string>> variants{{}};
+        for (auto& define : shaderSet->optionalDefines)
+        {
+            if (variants.size() >= maxVariants) break;
+            variants.push_back({define});
+        }
+
+        for (auto& defines : variants)
+        {
+            auto scs = vsg::ShaderCompileSettings::create();
+            scs->generateDebugInfo = generateDebugInfo;
+            scs->defines = defines;
+            shaderSet->getShaderStages(scs);
+        }
+    }
+
+    return shaderSets;
+}
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+    auto cacheDirectory = arguments.value<vsg::Path>("shader_cache", "--cache");
+    auto maxVariants = arguments.value<size_t>(8, "--variants");
+    bool generateDebugInfo = arguments.read({"--debug-info", "-g"});
+
+    auto options = vsg::Options::create();
+    options->paths = vsg::getEnvPaths("VSG_FILE_PATH");
+
+#ifdef vsgXchange_all
+    options->add(vsgXchange::all::create());
+#endif
+
+    options->readOptions(arguments);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    using clock = std::chrono::high_resolution_clock;
+    auto milliseconds = [](clock::time_point start) { return std::chrono::duration<double, std::milli>(clock::now() - start).count(); };
+
+    // without a cache, as the viewer would compile them
+    {
+        auto shaderSets = createShaderSets(options, generateDebugInfo, maxVariants);
+
+        auto shaderCompiler = vsg::ShaderCompiler::create();
+        if (!shaderCompiler->supported())
+        {
+            std::cout << "vsg::ShaderCompiler not supported, unable to compile GLSL." << std::endl;
+            return 1;
+        }
+
+        size_t numStages = 0;
+        auto start = clock::now();
+        for (auto& shaderSet : shaderSets)
+        {
+            for (auto& [scs, stages] : shaderSet->variants)
+            {
+                for (auto& stage : stages)
+                {
+                    if (!stage->module->code.empty() || stage->module->source.empty()) continue;
+                    shaderCompiler->compile(stage, {}, options);
+                    ++numStages;
+                }
+            }
+        }
+        std::cout << "vsg::ShaderCompiler : " << numStages << " stages compiled in " << milliseconds(start) << "ms" << std::endl;
+
+        if (numStages == 0)
+        {
+            std::cout << "No GLSL source to compile, set VSG_FILE_PATH to the vsgExamples/data directory so the shaders/*.vert and *.frag files are found." << std::endl;
+            return 1;
+        }
+    }
+
+    auto shaderCache = shadercache::ShaderCache::create(cacheDirectory);
+    shaderCache->clear();
+
+    for (auto pass : {"cold", "warm"})
+    {
+        auto shaderSets = createShaderSets(options, generateDebugInfo, maxVariants);
+
+        shaderCache->clearStats();
+        auto start = clock::now();
+        for (auto& shaderSet : shaderSets) shaderCache->compile(*shaderSet, options);
+        auto time = milliseconds(start);
+
+        std::cout << "\nShaderCache " << pass << " : " << time << "ms" << std::endl;
+        shaderCache->report(std::cout);
+    }
+
+    return 0;
+}
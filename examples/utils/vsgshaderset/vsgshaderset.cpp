@@ -5,6 +5,8 @@
 #    include <vsgXchange/all.h>
 #endif
 
+#include "ShaderSetPrecompiler.h"
+
 // functions provided by text.cpp, flat.cpp
 extern vsg::ref_ptr<vsg::ShaderSet> text_ShaderSet(vsg::ref_ptr<const vsg::Options> options);
 extern vsg::ref_ptr<vsg::ShaderSet> flat_ShaderSet(vsg::ref_ptr<const vsg::Options> options);
@@ -151,6 +153,8 @@ int main(int argc, char** argv)
     bool vsgShaderSet = arguments.read("--vsg");
     bool stripShaderSetBeforeWrite = arguments.read({"-s", "--strip"});
     bool compileShaders = !arguments.read({"--nc", "--no-compile"});
+    auto numThreads = arguments.value(0u, "--threads");
+    auto maxCombinationDefines = arguments.value<size_t>(0, "--combinations");
 
     vsg::ref_ptr<vsg::ShaderSet> shaderSet;
     if (inputFilename)
@@ -222,6 +226,16 @@ int main(int argc, char** argv)
         std::cout << std::endl;
     }
 
+    auto precompiler = precompile::ShaderSetPrecompiler::create(numThreads);
+
+    // add the variants for all combinations of up to --combinations of the supported defines
+    if (maxCombinationDefines > 0)
+    {
+        auto combinations = precompile::defineCombinations(defines, maxCombinationDefines);
+        std::cout << "adding " << combinations.size() << " variants from combinations of up to " << maxCombinationDefines << " defines" << std::endl;
+        precompiler->addVariants(*shaderSet, combinations, shaderSet->defaultShaderHints);
+    }
+
     // load remaining command line parameters as models to help fill out the required ShaderSet variants
     for (int i = 1; i < argc; ++i)
     {
@@ -249,6 +263,10 @@ int main(int argc, char** argv)
         auto shaderCompiler = vsg::ShaderCompiler::create();
         if (shaderCompiler->supported())
         {
+            // compile the variants in parallel, leaving the loop below to share the resulting stages
+            precompiler->precompile(*shaderSet, options);
+            precompiler->report(std::cout);
+
             std::cout << "\ncompiling shaderSet->variants.size() = " << shaderSet->variants.size() << std::endl;
             std::cout << "{" << std::endl;
             for (auto& [shaderCompileSetting, stagesToCompile] : shaderSet->variants)
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vsg/core/Object.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <typeinfo>
+#include <vector>
+
+/// FastCast gives each registered target class a bit, and for each concrete class registered caches an ancestry bitset
+/// holding the bits of all the target classes it's compatible with, so that cast<T>() reduces to a typeid(), a probe of the hash table
+/// keyed on the type_info's address, and a mask test against the ancestry bits it finds.
+/// Ideally the class ID and ancestry bits would be stored on each object so the cast is the mask test alone, but vsg::Object has no
+/// member to hold them and the VSG classes can't be changed from here, so the typeid() and probe stand in for reading that member.
+/// Target classes must be registered before the concrete classes, unregistered targets or classes fall back to vsg::Object::cast<T>().
+class FastCast
+{
+public:
+    static FastCast& instance()
+    {
+        static FastCast s_fastCast;
+        return s_fastCast;
+    }
+
+    template<class T>
+    void registerTarget()
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        auto& bit = targetBit<T>();
+        if (bit != 0 || _targets.size() >= maxTargets) return;
+
+        bit = uint64_t(1) << _targets.size();
+        _targets.push_back(&typeid(T));
+    }
+
+    /// register the concrete class of object, computing its ancestry from the registered targets.
+    void registerType(const vsg::Object& object)
+    {
+        const std::type_info* type = &typeid(object);
+        if (find(type)) return;
+
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        uint64_t ancestry = registeredBit;
+        for (size_t i = 0; i < _targets.size(); ++i)
+        {
+            if (object.is_compatible(*_targets[i])) ancestry |= (uint64_t(1) << i);
+        }
+
+        for (size_t i = 0; i < tableSize; ++i)
+        {
+            auto& entry = _table[(hash(type) + i) & (tableSize - 1)];
+            auto key = entry.type.load(std::memory_order_relaxed);
+            if (key == type) return;
+            if (!key)
+            {
+                entry.ancestry = ancestry;
+                entry.type.store(type, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    template<class T>
+    const T* cast(const vsg::Object* object) const
+    {
+        if (!object) return nullptr;
+
+        uint64_t bit = targetBit<T>();
+        if (auto ancestry = find(&typeid(*object)); ancestry && bit)
+        {
+            return (ancestry & bit) ? static_cast<const T*>(object) : nullptr;
+        }
+        return object->cast<T>();
+    }
+
+    template<class T>
+    T* cast(vsg::Object* object) const
+    {
+        return const_cast<T*>(cast<T>(static_cast<const vsg::Object*>(object)));
+    }
+
+protected:
+    FastCast() = default;
+
+    static constexpr size_t maxTargets = 63;
+    static constexpr uint64_t registeredBit = uint64_t(1) << maxTargets;
+    static constexpr size_t tableSize = 1024;
+
+    template<class T>
+    static uint64_t& targetBit()
+    {
+        static uint64_t s_bit = 0;
+        return s_bit;
+    }
+
+    static size_t hash(const std::type_info* type) { return static_cast<size_t>(reinterpret_cast<uintptr_t>(type) >> 4); }
+
+    uint64_t find(const std::type_info* type) const
+    {
+        for (size_t i = 0; i < tableSize; ++i)
+        {
+            auto& entry = _table[(hash(type) + i) & (tableSize - 1)];
+            auto key = entry.type.load(std::memory_order_acquire);
+            if (key == type) return entry.ancestry;
+            if (!key) return 0;
+        }
+        return 0;
+    }
+
+    struct Entry
+    {
+        std::atomic<const std::type_info*> type{nullptr};
+        uint64_t ancestry = 0;
+    };
+
+    std::mutex _mutex;
+    std::vector<const std::type_info*> _targets;
+    std::array<Entry, tableSize> _table;
+};
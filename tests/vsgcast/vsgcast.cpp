@@ -9,6 +9,8 @@
 #include <iostream>
 #include <thread>
 
+#include "FastCast.h"
+
 size_t traverseChildren(const vsg::Group* group)
 {
     size_t count = group->children.size();
@@ -19,6 +21,96 @@ size_t traverseChildren(const vsg::Group* group)
     return count;
 }
 
+struct VsgCast
+{
+    static constexpr const char* name = "Object::cast<>";
+
+    template<class T>
+    static const T* cast(const vsg::Object* object) { return object->cast<T>(); }
+};
+
+struct DynamicCast
+{
+    static constexpr const char* name = "dynamic_cast<>";
+
+    template<class T>
+    static const T* cast(const vsg::Object* object) { return dynamic_cast<const T*>(object); }
+};
+
+struct TableCast
+{
+    static constexpr const char* name = "FastCast table";
+
+    template<class T>
+    static const T* cast(const vsg::Object* object) { return FastCast::instance().cast<T>(object); }
+};
+
+// count the nodes that cast to T, each child is cast twice, once to T and once to Group to decide whether to traverse
+template<class Caster, class T>
+size_t countCasts(const vsg::Group* group)
+{
+    size_t count = 0;
+    for(auto& child : group->children)
+    {
+        if (Caster::template cast<T>(child.get())) ++count;
+        if (auto child_group = Caster::template cast<vsg::Group>(child.get())) count += countCasts<Caster, T>(child_group);
+    }
+    return count;
+}
+
+// register the concrete classes in the scene graph with the FastCast table
+struct RegisterTypes : public vsg::Inherit<vsg::ConstVisitor, RegisterTypes>
+{
+    void apply(const vsg::Object& object) override
+    {
+        FastCast::instance().registerType(object);
+        object.traverse(*this);
+    }
+};
+
+template<class Caster, class T>
+void benchmarkCast(const char* description, const vsg::Group* root, size_t numNodes, size_t iterationCount, unsigned int numThreads)
+{
+    // pad each thread's counter to its own cache line so the threads don't contend through false sharing
+    struct alignas(64) Counter
+    {
+        size_t value = 0;
+    };
+    std::vector<Counter> counts(std::max(numThreads, 1u));
+
+    auto startTime = vsg::clock::now();
+
+    if (numThreads <= 1)
+    {
+        for (size_t i = 0; i < iterationCount; ++i) counts[0].value += countCasts<Caster, T>(root);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&, t]() {
+                for (size_t i = 0; i < iterationCount; ++i) counts[t].value += countCasts<Caster, T>(root);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+
+    auto time = std::chrono::duration<double, std::chrono::seconds::period>(vsg::clock::now() - startTime).count();
+
+    size_t numCasts = 2 * numNodes * iterationCount * std::max(numThreads, 1u);
+    std::cout << "  " << description << ", " << Caster::name << ", threads = " << numThreads << ", time = " << time * 1000.0 << "ms, matches = " << counts[0].value / iterationCount;
+    std::cout << ", casts per second " << static_cast<size_t>(static_cast<double>(numCasts) / time) << std::endl;
+}
+
+template<class T>
+void benchmarkCasts(const char* description, const vsg::Group* root, size_t numNodes, size_t iterationCount, unsigned int numThreads)
+{
+    benchmarkCast<VsgCast, T>(description, root, numNodes, iterationCount, numThreads);
+    benchmarkCast<DynamicCast, T>(description, root, numNodes, iterationCount, numThreads);
+    benchmarkCast<TableCast, T>(description, root, numNodes, iterationCount, numThreads);
+}
+
 int main(int argc, char** argv)
 {
     // set up defaults and read command line arguments to override them
@@ -43,6 +135,9 @@ int main(int argc, char** argv)
     options->readOptions(arguments);
 
     size_t iterationCount = arguments.value<size_t>(100000, "-i");
+    size_t castIterationCount = arguments.value<size_t>(1000, "--cast-iterations");
+    size_t numTransforms = arguments.value<size_t>(1000, "--transforms");
+    unsigned int numThreads = arguments.value<unsigned int>(std::thread::hardware_concurrency(), "--threads");
 
     auto root = vsg::Group::create();
 
@@ -77,6 +172,18 @@ int main(int argc, char** argv)
             else if (i%3==1) root->addChild(vsg::VertexDraw::create());
             else if (i%3==2) root->addChild(vsg::Geometry::create());
         }
+
+        // add transforms to exercise casts down the MatrixTransform -> Transform -> Group inheritance chain,
+        // use --transforms 0 for the original scene so the cast and traverse timing is comparable with earlier runs
+        for(size_t i = 0; i<numTransforms; ++i)
+        {
+            auto transform = vsg::MatrixTransform::create();
+            auto group = vsg::Group::create();
+            group->addChild(vsg::VertexDraw::create());
+            group->addChild(vsg::Node::create());
+            transform->addChild(group);
+            root->addChild(transform);
+        }
     }
 
     if (VSG_USE_dynamic_cast)
@@ -101,6 +208,30 @@ int main(int argc, char** argv)
     std::cout << "Time " << time*1000.0 << "ms" << " count = " << count << std::endl;
     std::cout << "Cast and traverse per second " << static_cast<size_t>((static_cast<double>(count)/time))<< std::endl;
 
+    // compare vsg::Object::cast<>, dynamic_cast<> and the FastCast ancestry table
+    auto& fastCast = FastCast::instance();
+    fastCast.registerTarget<vsg::Node>();
+    fastCast.registerTarget<vsg::Group>();
+    fastCast.registerTarget<vsg::Transform>();
+    fastCast.registerTarget<vsg::MatrixTransform>();
+    fastCast.registerTarget<vsg::Camera>();
+
+    RegisterTypes registerTypes;
+    root->accept(registerTypes);
+
+    size_t numNodes = traverseChildren(root);
+
+    for (unsigned int threads : {1u, numThreads})
+    {
+        std::cout << "\nCasting " << numNodes << " nodes " << castIterationCount << " times with " << threads << " thread(s)" << std::endl;
+        benchmarkCasts<vsg::Group>("Group", root, numNodes, castIterationCount, threads);
+        benchmarkCasts<vsg::Transform>("Transform", root, numNodes, castIterationCount, threads);
+        benchmarkCasts<vsg::MatrixTransform>("MatrixTransform", root, numNodes, castIterationCount, threads);
+        benchmarkCasts<vsg::Camera>("Camera (failed casts)", root, numNodes, castIterationCount, threads);
+
+        if (numThreads <= 1) break;
+    }
+
     // clean up done automatically thanks to ref_ptr<>
     return 0;
 }
@@ -1,8 +1,11 @@
 #include <cassert>
+#include <iostream>
 #include <string>
 
 #include "vsg/all.h"
 
+#include "ShaderCache.h"
+
 std::string VERT{R"(
 #version 450
 layout(push_constant) uniform PushConstants { mat4 projection; mat4 modelView; };
@@ -118,6 +121,11 @@ int main(int argc, char** argv)
     windowTraits->debugLayer = arguments.read({"--debug", "-d"});
     windowTraits->apiDumpLayer = arguments.read({"--api", "-a"});
 
+    // optionally use a persistent SPIR-V cache rather than compiling the GLSL each time the scenes are created
+    vsg::ref_ptr<shadercache::ShaderCache> shaderCache;
+    vsg::Path cacheDirectory;
+    if (arguments.read("--shader-cache", cacheDirectory)) shaderCache = shadercache::ShaderCache::create(cacheDirectory);
+
     auto window = vsg::Window::create(windowTraits);
     auto lookAt = vsg::LookAt::create(
         vsg::dvec3{2, -5, -1},
@@ -138,6 +146,8 @@ int main(int argc, char** argv)
 
     auto commandGraph = vsg::createCommandGraphForView(window, camera, sceneGraph);
     viewer->assignRecordAndSubmitTaskAndPresentation({commandGraph});
+
+    if (shaderCache) shaderCache->compile(sceneGraph);
     viewer->compile();
 
     int sceneNumber{0};
@@ -160,6 +170,8 @@ int main(int argc, char** argv)
             }
 
             sceneGraph->addChild(stateGroup);
+            if (shaderCache) shaderCache->compile(sceneGraph);
+
             auto result = viewer->compileManager->compile(sceneGraph);
             assert(result.result == VK_SUCCESS);
             vsg::updateViewer(*viewer, result);
@@ -170,4 +182,6 @@ int main(int argc, char** argv)
         viewer->recordAndSubmit();
         viewer->present();
     }
+
+    if (shaderCache) shaderCache->report(std::cout);
 }
@@ -9,6 +9,10 @@
 #include <iostream>
 #include <thread>
 
+#include "ContentDeduplicator.h"
+#include "LazyReaderWriter.h"
+#include "ResidentSetSize.h"
+
 vsg::ref_ptr<vsg::Node> createTextureQuad(vsg::ref_ptr<vsg::Data> sourceData, vsg::ref_ptr<vsg::Options> options)
 {
     auto builder = vsg::Builder::create();
@@ -140,6 +144,8 @@ vsg::ref_ptr<vsg::Animation> OrbitPath::build()
 
 int main(int argc, char** argv)
 {
+    auto startupTime = vsg::clock::now();
+
     try
     {
         // set up defaults and read command line arguments to override them
@@ -163,12 +169,25 @@ int main(int argc, char** argv)
         options->add(vsgXchange::all::create());
 #endif
 
+        // add support for reading .vsgl files, see examples/io/vsglazyload
+        options->add(lazy::LazyReaderWriter::create());
+
         options->readOptions(arguments);
 
         if (uint32_t numOperationThreads = 0; arguments.read("--ot", numOperationThreads)) options->operationThreads = vsg::OperationThreads::create(numOperationThreads);
 
         bool reportAverageFrameRate = true;
         bool reportMemoryStats = arguments.read("--rms");
+        bool reportStartup = arguments.read("--startup");
+
+        // deduplicate identical Data and state as native files are read, see examples/io/vsgdeduplicate
+        vsg::ref_ptr<dedup::DeduplicatingVSG> deduplicatingVSG;
+        if (arguments.read("--dedup"))
+        {
+            deduplicatingVSG = dedup::DeduplicatingVSG::create();
+            options->readerWriters.insert(options->readerWriters.begin(), deduplicatingVSG);
+        }
+
         if (arguments.read({"-t", "--test"}))
         {
             windowTraits->swapchainPreferences.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
@@ -318,6 +337,12 @@ int main(int argc, char** argv)
             return 1;
         }
 
+        if (reportStartup)
+        {
+            auto time = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startupTime).count();
+            std::cout << "Time to load = " << time << "ms, resident memory = " << residentSetSize() / (1024 * 1024) << " MB" << std::endl;
+        }
+
         vsg::ref_ptr<vsg::Node> vsg_scene;
         if (group->children.size() == 1)
             vsg_scene = group->children[0];
@@ -510,6 +535,14 @@ int main(int argc, char** argv)
             }
         }
 
+        auto reportFirstFrame = [&]() {
+            if (!reportStartup) return;
+            reportStartup = false;
+
+            auto time = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startupTime).count();
+            std::cout << "Time to first frame = " << time << "ms, resident memory = " << residentSetSize() / (1024 * 1024) << " MB" << std::endl;
+        };
+
         if (initialFrameCycleCount > 0)
         {
             // run an initial set of frames to get past the intiial frame time variability so we get stable frame rate stats
@@ -520,6 +553,8 @@ int main(int argc, char** argv)
                 viewer->update();
                 viewer->recordAndSubmit();
                 viewer->present();
+
+                reportFirstFrame();
             }
         }
 
@@ -542,6 +577,8 @@ int main(int argc, char** argv)
                 viewer->recordAndSubmit();
                 viewer->present();
 
+                reportFirstFrame();
+
                 ++frameCount;
             }
 
@@ -560,6 +597,10 @@ int main(int argc, char** argv)
 
         if (reportMemoryStats)
         {
+            std::cout << "Resident memory = " << residentSetSize() / (1024 * 1024) << " MB" << std::endl;
+
+            if (deduplicatingVSG) deduplicatingVSG->deduplicator->report(std::cout);
+
             if (options->sharedObjects)
             {
                 vsg::LogOutput output;